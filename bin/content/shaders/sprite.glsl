@@ -0,0 +1,115 @@
+#type vertex
+#version 450 core
+
+layout (location = 0) in vec3 in_center;
+layout (location = 1) in vec4 in_color;
+layout (location = 2) in uvec2 in_tex_unit_and_shape;
+layout (location = 3) in vec4 in_tex_rect;
+layout (location = 4) in vec2 in_half_size;
+layout (location = 6) in float in_rotation;
+
+uniform mat4 u_vp_matrix;
+
+layout (location = 0) out vec4 out_color;
+layout (location = 1) out flat uint out_tex_unit;
+layout (location = 2) out flat uint out_shape;
+layout (location = 3) out vec2 out_tex_coord;
+layout (location = 4) out flat float out_inner_radius;
+
+#if APORIA_EDITOR
+layout (location = 5) in int in_editor_index;
+layout (location = 5) out flat int out_editor_index;
+#endif
+
+#define SHAPE_TEXTURE 0u
+#define SHAPE_RECTANGLE 1u
+#define SHAPE_CIRCLE 2u
+
+#define TWO_PI 6.283185307179586
+
+void main()
+{
+    // The sprite is drawn as a triangle strip with the corners (0, 0), (1, 0), (0, 1), (1, 1).
+    vec2 corner = vec2(gl_VertexID & 1, gl_VertexID >> 1);
+    vec2 local_position = (corner * 2.0 - 1.0) * in_half_size;
+
+    float angle = in_rotation * TWO_PI;
+    float s = sin(angle);
+    float c = cos(angle);
+
+    vec2 position = in_center.xy + vec2(local_position.x * c - local_position.y * s, local_position.x * s + local_position.y * c);
+    gl_Position = u_vp_matrix * vec4(position, in_center.z, 1.0);
+
+    out_color = in_color;
+    out_tex_unit = in_tex_unit_and_shape.x;
+    out_shape = in_tex_unit_and_shape.y;
+
+    if (out_shape == SHAPE_CIRCLE)
+    {
+        out_tex_coord = corner * 2.0 - 1.0;
+        out_inner_radius = in_tex_rect.x;
+    }
+    else
+    {
+        // The xy is the top-left corner of the subtexture and zw is the bottom-right one.
+        out_tex_coord = vec2(mix(in_tex_rect.x, in_tex_rect.z, corner.x), mix(in_tex_rect.w, in_tex_rect.y, corner.y));
+        out_inner_radius = 0.0;
+    }
+
+#if APORIA_EDITOR
+    out_editor_index = in_editor_index;
+#endif
+}
+
+
+
+#type fragment
+#version 450 core
+
+layout (location = 0) in vec4 in_color;
+layout (location = 1) in flat uint in_tex_unit;
+layout (location = 2) in flat uint in_shape;
+layout (location = 3) in vec2 in_tex_coord;
+layout (location = 4) in flat float in_inner_radius;
+
+uniform sampler2D u_atlas[32];
+
+layout (location = 0) out vec4 out_color;
+
+#if APORIA_EDITOR
+layout (location = 5) in flat int in_editor_index;
+layout (location = 1) out int out_editor_index;
+#endif
+
+#define SHAPE_TEXTURE 0u
+#define SHAPE_RECTANGLE 1u
+#define SHAPE_CIRCLE 2u
+
+#define SMALL_NUMBER 0.01
+
+void main()
+{
+    vec4 object_color = in_color;
+
+    if (in_shape == SHAPE_TEXTURE)
+    {
+        object_color *= texture(u_atlas[in_tex_unit], in_tex_coord);
+    }
+    else if (in_shape == SHAPE_CIRCLE)
+    {
+        float radius = length(in_tex_coord);
+
+        float outer_mask = smoothstep(1.0, 1.0 - SMALL_NUMBER, radius);
+        float inner_mask = smoothstep(in_inner_radius - SMALL_NUMBER, in_inner_radius, radius);
+
+        object_color.a *= outer_mask * inner_mask;
+    }
+
+    out_color = object_color;
+
+#if APORIA_EDITOR
+    out_editor_index = in_editor_index;
+    if (out_color.a == 0.0)
+        discard;
+#endif
+}
@@ -0,0 +1,133 @@
+#type vertex
+#version 300 es
+precision highp float;
+
+layout (location = 0) in vec3 in_center;
+layout (location = 1) in vec4 in_color;
+layout (location = 2) in vec2 in_tex_unit_and_shape;
+layout (location = 3) in vec4 in_tex_rect;
+layout (location = 4) in vec2 in_half_size;
+layout (location = 6) in float in_rotation;
+
+uniform mat4 u_vp_matrix;
+
+out vec4 vs_color;
+flat out float vs_tex_unit;
+flat out float vs_shape;
+out vec2 vs_tex_coord;
+flat out float vs_inner_radius;
+
+#define SHAPE_CIRCLE 2.0
+
+#define TWO_PI 6.283185307179586
+
+void main()
+{
+    // The sprite is drawn as a triangle strip with the corners (0, 0), (1, 0), (0, 1), (1, 1).
+    vec2 corner = vec2(gl_VertexID & 1, gl_VertexID >> 1);
+    vec2 local_position = (corner * 2.0 - 1.0) * in_half_size;
+
+    float angle = in_rotation * TWO_PI;
+    float s = sin(angle);
+    float c = cos(angle);
+
+    vec2 position = in_center.xy + vec2(local_position.x * c - local_position.y * s, local_position.x * s + local_position.y * c);
+    gl_Position = u_vp_matrix * vec4(position, in_center.z, 1.0);
+
+    vs_color = in_color;
+    vs_tex_unit = in_tex_unit_and_shape.x;
+    vs_shape = in_tex_unit_and_shape.y;
+
+    if (vs_shape == SHAPE_CIRCLE)
+    {
+        vs_tex_coord = corner * 2.0 - 1.0;
+        vs_inner_radius = in_tex_rect.x;
+    }
+    else
+    {
+        // The xy is the top-left corner of the subtexture and zw is the bottom-right one.
+        vs_tex_coord = vec2(mix(in_tex_rect.x, in_tex_rect.z, corner.x), mix(in_tex_rect.w, in_tex_rect.y, corner.y));
+        vs_inner_radius = 0.0;
+    }
+}
+
+
+
+#type fragment
+#version 300 es
+precision highp float;
+
+in vec4 vs_color;
+flat in float vs_tex_unit;
+flat in float vs_shape;
+in vec2 vs_tex_coord;
+flat in float vs_inner_radius;
+
+uniform sampler2D u_atlas[16];
+
+out vec4 out_color;
+
+#define SHAPE_TEXTURE 0.0
+#define SHAPE_CIRCLE 2.0
+
+#define SMALL_NUMBER 0.01
+
+vec4 sample_texture()
+{
+    int tex_unit = int(vs_tex_unit);
+    if (tex_unit == 0)
+        return texture(u_atlas[0], vs_tex_coord);
+    else if (tex_unit == 1)
+        return texture(u_atlas[1], vs_tex_coord);
+    else if (tex_unit == 2)
+        return texture(u_atlas[2], vs_tex_coord);
+    else if (tex_unit == 3)
+        return texture(u_atlas[3], vs_tex_coord);
+    else if (tex_unit == 4)
+        return texture(u_atlas[4], vs_tex_coord);
+    else if (tex_unit == 5)
+        return texture(u_atlas[5], vs_tex_coord);
+    else if (tex_unit == 6)
+        return texture(u_atlas[6], vs_tex_coord);
+    else if (tex_unit == 7)
+        return texture(u_atlas[7], vs_tex_coord);
+    else if (tex_unit == 8)
+        return texture(u_atlas[8], vs_tex_coord);
+    else if (tex_unit == 9)
+        return texture(u_atlas[9], vs_tex_coord);
+    else if (tex_unit == 10)
+        return texture(u_atlas[10], vs_tex_coord);
+    else if (tex_unit == 11)
+        return texture(u_atlas[11], vs_tex_coord);
+    else if (tex_unit == 12)
+        return texture(u_atlas[12], vs_tex_coord);
+    else if (tex_unit == 13)
+        return texture(u_atlas[13], vs_tex_coord);
+    else if (tex_unit == 14)
+        return texture(u_atlas[14], vs_tex_coord);
+    else if (tex_unit == 15)
+        return texture(u_atlas[15], vs_tex_coord);
+    else
+        return vec4(1.0, 0.0, 1.0, 1.0);
+}
+
+void main()
+{
+    vec4 object_color = vs_color;
+
+    if (vs_shape == SHAPE_TEXTURE)
+    {
+        object_color *= sample_texture();
+    }
+    else if (vs_shape == SHAPE_CIRCLE)
+    {
+        float radius = length(vs_tex_coord);
+
+        float outer_mask = smoothstep(1.0, 1.0 - SMALL_NUMBER, radius);
+        float inner_mask = smoothstep(vs_inner_radius - SMALL_NUMBER, vs_inner_radius, radius);
+
+        object_color.a *= outer_mask * inner_mask;
+    }
+
+    out_color = object_color;
+}
@@ -1,15 +1,15 @@
 #include "aporia_animations.hpp"
 
+#include "aporia_atoms.hpp"
 #include "aporia_debug.hpp"
-#include "aporia_entity.hpp"
 #include "aporia_game.hpp"
 #include "aporia_hash_table.hpp"
 #include "aporia_parser.hpp"
 #include "aporia_string.hpp"
 #include "aporia_textures.hpp"
 
-static constexpr u64 MAX_ANIMATIONS = 128;
-static HashTable<Animation> all_animations;
+static constexpr i64 INITIAL_ANIMATION_BUCKET_COUNT = 128;
+static HashTable<Animation, Atom> all_animations;
 
 static bool operator==(const Animation& animation1, const Animation& animation2)
 {
@@ -20,7 +20,7 @@ static bool operator==(const Animation& animation1, const Animation& animation2)
 
 void animations_init(MemoryArena* arena)
 {
-    all_animations = hash_table_create<Animation>(arena, MAX_ANIMATIONS);
+    all_animations = hash_table_create<Animation, Atom>(arena, INITIAL_ANIMATION_BUCKET_COUNT);
 }
 
 // @TODO(dubgron): The arena should be parameterized in the future.
@@ -39,7 +39,7 @@ void load_animations(String filepath)
             for (ParseTreeNode* animation_node = node->child_first; animation_node; animation_node = animation_node->next)
             {
                 APORIA_ASSERT(animation_node->type == ParseTreeNode_Field);
-                String animation_name = push_string(&memory.persistent, animation_node->name);
+                Atom animation_name = atom_intern(animation_node->name);
                 u64 frame_count = animation_node->child_count;
 
                 Animation animation;
@@ -50,7 +50,10 @@ void load_animations(String filepath)
                     APORIA_ASSERT(frame_node->type == ParseTreeNode_String);
 
                     AnimationFrame frame;
-                    frame.texture = get_subtexture(frame_node->string_value);
+                    frame.texture = atom_intern(frame_node->string_value);
+
+                    // @NOTE(dubgron): Reports the missing subtextures once, instead of every frame.
+                    get_subtexture(frame.texture);
 
                     animation.frames[animation.frame_count] = frame;
                     animation.frame_count += 1;
@@ -64,11 +67,9 @@ void load_animations(String filepath)
     }
 }
 
-void animation_tick(Entity* entity, f32 frame_time)
+void animation_tick(Animator* animator, SubTexture* texture, f32 frame_time)
 {
-    Animator* animator = &entity->animator;
-
-    if (animator->current_animation.is_empty())
+    if (atom_is_empty(animator->current_animation))
     {
         return;
     }
@@ -82,13 +83,13 @@ void animation_tick(Entity* entity, f32 frame_time)
         animator->elapsed_time -= animation->frame_length;
 
         // The current frame is over. If other animation has been requested, play it.
-        if (!animator->requested_animation.is_empty())
+        if (!atom_is_empty(animator->requested_animation))
         {
             animation = hash_table_find(&all_animations, animator->requested_animation);
             APORIA_ASSERT(animation);
 
             animator->current_animation = animator->requested_animation;
-            animator->requested_animation = String{};
+            animator->requested_animation = Atom{};
         }
 
         // Increment the current frame and wrap it around, if necessary.
@@ -98,13 +99,14 @@ void animation_tick(Entity* entity, f32 frame_time)
             animator->current_frame = 0;
         }
 
-        entity->texture = *animation->frames[animator->current_frame].texture;
+        SubTexture* subtexture = hash_table_find(&subtextures, animation->frames[animator->current_frame].texture);
+        *texture = subtexture ? *subtexture : SubTexture{};
     }
 }
 
-void animation_request(Animator* animator, String animation)
+void animation_request(Animator* animator, Atom animation)
 {
-    if (animator->current_animation.is_empty())
+    if (atom_is_empty(animator->current_animation))
     {
         animator->current_animation = animation;
     }
@@ -113,3 +115,8 @@ void animation_request(Animator* animator, String animation)
         animator->requested_animation = animation;
     }
 }
+
+bool animation_is_playing(const Animator& animator)
+{
+    return !atom_is_empty(animator.current_animation);
+}
@@ -1,13 +1,15 @@
 #pragma once
 
+#include "aporia_atoms.hpp"
 #include "aporia_string.hpp"
 #include "aporia_textures.hpp"
 
-struct Entity;
-
+// @NOTE(dubgron): The frames keep the atom of the subtexture, which is looked up whenever
+// the frame starts. The pointers into the subtexture hash table are invalidated whenever it
+// rehashes, and a copy of the subtexture would go stale, once the atlas is reloaded.
 struct AnimationFrame
 {
-    SubTexture* texture = nullptr;
+    Atom texture;
 };
 
 struct Animation
@@ -19,8 +21,8 @@ struct Animation
 
 struct Animator
 {
-    String current_animation;
-    String requested_animation;
+    Atom current_animation;
+    Atom requested_animation;
 
     u64 current_frame = 0;
     f32 elapsed_time = 0.f;
@@ -30,5 +32,8 @@ void animations_init(MemoryArena* arena);
 
 void load_animations(String filepath);
 
-void animation_tick(Entity* entity, f32 frame_time);
-void animation_request(Animator* animator, String animation_name);
+void animation_tick(Animator* animator, SubTexture* texture, f32 frame_time);
+void animation_request(Animator* animator, Atom animation_name);
+
+// @NOTE(dubgron): The animator changes the texture of its entity on every animation_tick.
+bool animation_is_playing(const Animator& animator);
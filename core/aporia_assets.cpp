@@ -5,14 +5,10 @@
 #include "aporia_config.hpp"
 #include "aporia_debug.hpp"
 #include "aporia_game.hpp"
+#include "aporia_pool.hpp"
 #include "platform/aporia_os.hpp"
 
-static constexpr u64 MAX_ASSETS = 100;
-
-static Asset assets[MAX_ASSETS];
-static i64 assets_count = 0;
-
-static Asset* free_list = nullptr;
+static Pool<Asset> assets;
 
 static String asset_type_to_string(AssetType type)
 {
@@ -44,11 +40,7 @@ void assets_init()
 {
     assets_mutex = mutex_create();
 
-    free_list = assets;
-    for (i64 idx = 0; idx < MAX_ASSETS - 1; ++idx)
-    {
-        assets[idx].next = &assets[idx + 1];
-    }
+    assets = pool_create<Asset>(&memory.assets);
 }
 
 void assets_deinit()
@@ -63,10 +55,10 @@ void assets_reload_if_dirty(f32 delta_time)
         return;
     }
 
-    for (i64 idx = 0; idx < assets_count; ++idx)
+    for (i32 idx = 0; idx < assets.capacity; ++idx)
     {
-        Asset* asset = &assets[idx];
-        if (asset->status == AssetStatus::NeedsReload)
+        Asset* asset = pool_get_at_index(&assets, idx);
+        if (asset && asset->status == AssetStatus::NeedsReload)
         {
             if (asset->time_until_reload > 0.f)
             {
@@ -96,27 +88,13 @@ Asset* register_asset(String source_file, AssetType type)
         return nullptr;
     }
 
-    if (!free_list)
-    {
-        APORIA_LOG(Warning, "Failed to register an asset '%' of type %! The asset list is full!", source_file, asset_type_to_string(type));
-        return nullptr;
-    }
-
-    static i64 next_id = 0;
-
-    Asset result;
-    result.id = next_id;
-    result.source_file = push_string(&memory.assets, source_file);
-    result.type = type;
-    result.status = AssetStatus::NotLoaded;
-
-    Asset* new_created = free_list;
-    free_list = free_list->next;
-
-    *new_created = result;
+    PoolHandle handle;
+    Asset* new_created = pool_alloc(&assets, &handle);
 
-    assets_count += 1;
-    next_id += 1;
+    new_created->id = pool_handle_to_id(handle);
+    new_created->source_file = push_string(&memory.assets, source_file);
+    new_created->type = type;
+    new_created->status = AssetStatus::NotLoaded;
 
     APORIA_LOG(Info, "Registered asset '%' of type %", source_file, asset_type_to_string(type));
 
@@ -125,55 +103,34 @@ Asset* register_asset(String source_file, AssetType type)
 
 bool unregister_asset(i64 id)
 {
-    Asset* asset = get_asset(id);
-    if (!asset)
+    if (id == Asset::INVALID_ID || !pool_free(&assets, pool_handle_from_id(id)))
     {
         APORIA_LOG(Warning, "Failed to unregister an asset with ID %! No asset with this ID exists!", id);
         return false;
     }
 
-    if (assets_count > 1)
-    {
-        *asset = assets[assets_count - 1];
-        asset = &assets[assets_count - 1];
-    }
-
-    *asset = Asset{};
-    asset->next = free_list;
-    free_list = asset;
-
-    assets_count -= 1;
-
     return true;
 }
 
 Asset* get_asset(i64 id)
 {
-    Asset* result = nullptr;
     if (id == Asset::INVALID_ID)
     {
-        return result;
+        return nullptr;
     }
 
-    for (i64 idx = 0; idx < assets_count; ++idx)
-    {
-        if (assets[idx].id == id)
-        {
-            result = &assets[idx];
-            break;
-        }
-    }
-    return result;
+    return pool_get(&assets, pool_handle_from_id(id));
 }
 
 Asset* get_asset_by_source_file(String source_file)
 {
     Asset* result = nullptr;
-    for (i64 idx = 0; idx < assets_count; ++idx)
+    for (i32 idx = 0; idx < assets.capacity; ++idx)
     {
-        if (assets[idx].source_file == source_file)
+        Asset* asset = pool_get_at_index(&assets, idx);
+        if (asset && asset->source_file == source_file)
         {
-            result = &assets[idx];
+            result = asset;
             break;
         }
     }
@@ -206,11 +163,11 @@ void debug_assets()
     }
     ImGui::Separator();
 
-    if (assets_count > 0)
+    if (assets.count > 0)
     {
-        static i32 selected_id = Asset::INVALID_ID;
+        static i64 selected_id = Asset::INVALID_ID;
 
-        ImGui::InputInt("Asset ID", &selected_id);
+        ImGui::InputScalar("Asset ID", ImGuiDataType_S64, &selected_id);
         if (ImGui::Button("Unregiser Asset"))
         {
             unregister_asset(selected_id);
@@ -219,7 +176,10 @@ void debug_assets()
         ImGui::SameLine();
         if (ImGui::Button("Mark Asset As Dirty"))
         {
-            get_asset(selected_id)->status = AssetStatus::NeedsReload;
+            if (Asset* selected_asset = get_asset(selected_id))
+            {
+                selected_asset->status = AssetStatus::NeedsReload;
+            }
         }
         ImGui::Separator();
 
@@ -231,16 +191,20 @@ void debug_assets()
             ImGui::TableSetupColumn("Type");
             ImGui::TableSetupColumn("Status");
             ImGui::TableHeadersRow();
-            for (i64 idx = 0; idx < assets_count; ++idx)
+            for (i32 idx = 0; idx < assets.capacity; ++idx)
             {
-                Asset* asset = &assets[idx];
+                Asset* asset = pool_get_at_index(&assets, idx);
+                if (!asset)
+                {
+                    continue;
+                }
 
                 ImGui::TableNextRow();
 
                 ImGui::TableNextColumn();
 
-                char label[8];
-                stbsp_sprintf(label, "%d", asset->id);
+                char label[24];
+                stbsp_sprintf(label, "%lld", asset->id);
                 if (ImGui::Selectable(label, asset->id == selected_id, ImGuiSelectableFlags_SpanAllColumns))
                 {
                     selected_id = asset->id;
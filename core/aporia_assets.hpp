@@ -22,8 +22,6 @@ enum class AssetStatus : u8
 
 struct Asset
 {
-    Asset* next = nullptr;
-
     i64 id = INVALID_ID;
     String source_file;
     AssetType type = AssetType::Invalid;
@@ -0,0 +1,158 @@
+#include "aporia_atoms.hpp"
+
+#include "aporia_debug.hpp"
+#include "aporia_dynamic_array.hpp"
+#include "aporia_hash_table.hpp"
+#include "aporia_memory.hpp"
+#include "aporia_utils.hpp"
+
+#if defined(APORIA_EMSCRIPTEN)
+static constexpr i64 MAX_ATOMS = 16384;
+static constexpr u64 ATOM_STRINGS_SIZE = MEGABYTES(1);
+static constexpr u64 ATOM_TABLE_SIZE = MEGABYTES(1);
+#else
+static constexpr i64 MAX_ATOMS = 1 << 20;
+static constexpr u64 ATOM_STRINGS_SIZE = MEGABYTES(64);
+static constexpr u64 ATOM_TABLE_SIZE = MEGABYTES(128);
+#endif
+
+static constexpr i64 INITIAL_ATOM_BUCKET_COUNT = 1024;
+
+struct AtomInfo
+{
+    String string;
+    u32 hash = 0;
+};
+
+// @NOTE(dubgron): The infos never move, so the atoms can be read without locking. The
+// hash table has an arena on its own, so it can reuse its memory when it grows.
+static DynamicArray<AtomInfo> atom_infos;
+
+// @NOTE(dubgron): The count of atom_infos, published with a release store after the info of
+// a new atom has been written. The readers load it with an acquire, so every atom they can
+// see has its info fully written, even if it was interned on another thread a moment ago.
+static std::atomic<u32> published_atom_count{ 0 };
+static MemoryArena atom_strings;
+static MemoryArena atom_table_arena;
+static HashTable<Atom> atom_table;
+static Mutex atoms_mutex;
+
+bool operator==(Atom atom0, Atom atom1)
+{
+    return atom0.id == atom1.id;
+}
+
+bool operator!=(Atom atom0, Atom atom1)
+{
+    return atom0.id != atom1.id;
+}
+
+void atoms_init()
+{
+    atom_infos = dynamic_array_create<AtomInfo>(MAX_ATOMS);
+    atom_strings = arena_init(ATOM_STRINGS_SIZE);
+    atom_table_arena = arena_init(ATOM_TABLE_SIZE);
+    atom_table = hash_table_create<Atom>(&atom_table_arena, INITIAL_ATOM_BUCKET_COUNT);
+    atoms_mutex = mutex_create();
+
+    // @NOTE(dubgron): Reserve the id 0 for the empty string.
+    AtomInfo* empty_atom = dynamic_array_push(&atom_infos);
+    empty_atom->string = String{ (u8*)"", 0 };
+    empty_atom->hash = get_hash(empty_atom->string);
+
+    published_atom_count.store(atom_infos.count, std::memory_order_release);
+}
+
+void atoms_deinit()
+{
+    mutex_destroy(&atoms_mutex);
+    arena_deinit(&atom_table_arena);
+    arena_deinit(&atom_strings);
+    dynamic_array_destroy(&atom_infos);
+
+    atom_table = HashTable<Atom>{};
+    published_atom_count.store(0, std::memory_order_relaxed);
+}
+
+Atom atom_intern(String string)
+{
+    return atom_intern(string, get_hash(string));
+}
+
+Atom atom_intern(String string, u32 hash)
+{
+    APORIA_ASSERT(hash == get_hash(string));
+
+    if (string.is_empty())
+    {
+        return Atom{};
+    }
+
+    mutex_lock(&atoms_mutex);
+    defer { mutex_unlock(&atoms_mutex); };
+
+    if (Atom* atom = hash_table_find_with_hash(&atom_table, string, hash))
+    {
+        return *atom;
+    }
+
+    AtomInfo info;
+    info.string = String{ (u8*)string.cstring(&atom_strings), string.length };
+    info.hash = hash;
+
+    Atom result;
+    result.id = atom_infos.count;
+    dynamic_array_push(&atom_infos, info);
+    published_atom_count.store(atom_infos.count, std::memory_order_release);
+
+    hash_table_insert_with_hash(&atom_table, info.string, hash, result);
+
+    return result;
+}
+
+static const AtomInfo* atom_get_info(Atom atom)
+{
+    u32 atom_count = published_atom_count.load(std::memory_order_acquire);
+    APORIA_ASSERT_WITH_MESSAGE(atom.id < atom_count, "Invalid atom % (there are only % atoms)!", atom.id, atom_count);
+    return &atom_infos.data[atom.id];
+}
+
+bool atom_is_empty(Atom atom)
+{
+    return atom.id == 0;
+}
+
+String atom_get_string(Atom atom)
+{
+    if (atom_is_empty(atom))
+    {
+        return String{};
+    }
+
+    return atom_get_info(atom)->string;
+}
+
+CString atom_get_cstring(Atom atom)
+{
+    if (atom_is_empty(atom))
+    {
+        return "";
+    }
+
+    return (CString)atom_get_info(atom)->string.data;
+}
+
+u32 atom_get_hash(Atom atom)
+{
+    return atom_get_info(atom)->hash;
+}
+
+u32 get_hash(Atom atom)
+{
+    return atom_get_hash(atom);
+}
+
+String to_string(MemoryArena* arena, Atom atom)
+{
+    return push_string(arena, atom_get_string(atom));
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "aporia_string.hpp"
+#include "aporia_types.hpp"
+#include "aporia_utils.hpp"
+
+// @NOTE(dubgron): An atom is an interned string. Interning the same string always returns
+// the same atom, so comparing two atoms is the same as comparing their strings. Every
+// atom keeps its hash and a null-terminated copy of its string, which stays valid for
+// the whole lifetime of the program. The atom with id 0 is the empty string.
+struct Atom
+{
+    u32 id = 0;
+};
+
+bool operator==(Atom atom0, Atom atom1);
+bool operator!=(Atom atom0, Atom atom1);
+
+void atoms_init();
+void atoms_deinit();
+
+// @NOTE(dubgron): The interning is thread-safe. Reading an atom is lock-free.
+Atom atom_intern(String string);
+Atom atom_intern(String string, u32 hash);
+
+// @NOTE(dubgron): Hashes the literal at compile time.
+#define ATOM_LITERAL(literal) atom_intern(literal, hash_literal(literal))
+
+bool atom_is_empty(Atom atom);
+
+String atom_get_string(Atom atom);
+CString atom_get_cstring(Atom atom);
+u32 atom_get_hash(Atom atom);
+
+u32 get_hash(Atom atom);
+String to_string(MemoryArena* arena, Atom atom);
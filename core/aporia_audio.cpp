@@ -12,15 +12,11 @@
 
 #include "aporia_camera.hpp"
 #include "aporia_debug.hpp"
+#include "aporia_game.hpp"
 #include "aporia_utils.hpp"
 
-constexpr i64 MAX_AUDIO_SOURCES = 64;
-AudioSource audio_sources[MAX_AUDIO_SOURCES];
-i64 audio_sources_count = 0;
-
-constexpr i64 MAX_ACTIVE_AUDIO_STREAMS = 128;
-AudioStream* active_streams[MAX_ACTIVE_AUDIO_STREAMS];
-i64 active_streams_count = 0;
+Pool<AudioSource> audio_sources;
+Pool<AudioStream*> active_streams;
 
 static void get_icursor_and_remainder(f32 cursor, i64* out_icursor, f32* out_remainder)
 {
@@ -90,9 +86,15 @@ static void audio_thread_function(f32* buffer, i32 num_samples, i32 num_channels
 
     mutex_lock(&audio_mutex);
 
-    for (i64 idx = 0; idx < active_streams_count; ++idx)
+    for (i32 idx = 0; idx < active_streams.capacity; ++idx)
     {
-        AudioStream* stream = active_streams[idx];
+        AudioStream** active_stream = pool_get_at_index(&active_streams, idx);
+        if (!active_stream)
+        {
+            continue;
+        }
+
+        AudioStream* stream = *active_stream;
         AudioSource* source = stream->source;
 
         f32 play_direction = (stream->playback_speed < 0.f) ? -1.f : 1.f;
@@ -159,9 +161,8 @@ static void audio_thread_function(f32* buffer, i32 num_samples, i32 num_channels
 
                 if (!(stream->flags & AudioFlag_Looped))
                 {
-                    active_streams[idx] = active_streams[active_streams_count - 1];
-                    active_streams_count -= 1;
-                    idx -= 1;
+                    pool_free(&active_streams, stream->active_handle);
+                    stream->active_handle = PoolHandle{};
                     break;
                 }
             }
@@ -171,10 +172,20 @@ static void audio_thread_function(f32* buffer, i32 num_samples, i32 num_channels
     mutex_unlock(&audio_mutex);
 }
 
-void audio_init()
+void audio_init(MemoryArena* arena)
 {
     audio_mutex = mutex_create();
 
+    audio_sources = pool_create<AudioSource>(arena);
+    active_streams = pool_create<AudioStream*>(arena);
+
+    // @NOTE(dubgron): The sounds can still be loaded and played in the headless mode, they
+    // just never reach any device.
+    if (engine_is_headless)
+    {
+        return;
+    }
+
     saudio_desc desc = {};
     desc.num_channels = 2;
     desc.stream_cb = audio_thread_function;
@@ -183,7 +194,10 @@ void audio_init()
 
 void audio_deinit()
 {
-    saudio_shutdown();
+    if (!engine_is_headless)
+    {
+        saudio_shutdown();
+    }
     mutex_destroy(&audio_mutex);
 }
 
@@ -211,48 +225,43 @@ i64 audio_load(MemoryArena* arena, String filepath)
     }
     scratch_end(temp);
 
-    APORIA_ASSERT(audio_sources_count < MAX_AUDIO_SOURCES);
-    i64 result = audio_sources_count;
-    audio_sources[result] = source;
-    audio_sources_count += 1;
+    PoolHandle handle;
+    *pool_alloc(&audio_sources, &handle) = source;
 
-    return result;
+    return pool_handle_to_id(handle);
 }
 
 AudioStream audio_create_stream(i64 source_id)
 {
     AudioStream result;
-    result.source = &audio_sources[source_id];
+    result.source = pool_get(&audio_sources, pool_handle_from_id(source_id));
+    APORIA_ASSERT_WITH_MESSAGE(result.source, "Invalid audio source ID %!", source_id);
     return result;
 }
 
 void audio_play(AudioStream* stream)
 {
-    if (active_streams_count < MAX_ACTIVE_AUDIO_STREAMS)
-    {
-        mutex_lock(&audio_mutex);
-
-        active_streams[active_streams_count] = stream;
-        active_streams_count += 1;
+    mutex_lock(&audio_mutex);
 
-        mutex_unlock(&audio_mutex);
+    AudioStream** active_stream = pool_get(&active_streams, stream->active_handle);
+    if (!active_stream || *active_stream != stream)
+    {
+        *pool_alloc(&active_streams, &stream->active_handle) = stream;
     }
+
+    mutex_unlock(&audio_mutex);
 }
 
 void audio_stop(AudioStream* stream)
 {
-    for (i64 idx = 0; idx < active_streams_count; ++idx)
-    {
-        if (active_streams[idx] == stream)
-        {
-            mutex_lock(&audio_mutex);
-
-            active_streams[idx] = active_streams[active_streams_count - 1];
-            active_streams_count -= 1;
-
-            mutex_unlock(&audio_mutex);
+    mutex_lock(&audio_mutex);
 
-            break;
-        }
+    AudioStream** active_stream = pool_get(&active_streams, stream->active_handle);
+    if (active_stream && *active_stream == stream)
+    {
+        pool_free(&active_streams, stream->active_handle);
+        stream->active_handle = PoolHandle{};
     }
+
+    mutex_unlock(&audio_mutex);
 }
@@ -1,5 +1,6 @@
 #pragma once 
 
+#include "aporia_pool.hpp"
 #include "aporia_string.hpp"
 #include "aporia_types.hpp"
 #include "platform/aporia_os.hpp"
@@ -48,13 +49,16 @@ struct AudioStream
     f32 outer_radius = 2500.f;
 
     AudioFlags flags = AudioFlag_None;
+
+    // @NOTE(dubgron): Set while the stream is playing, points into the list of active streams.
+    PoolHandle active_handle;
 };
 
 Mutex audio_mutex;
 
 f32 master_volume = 1.f;
 
-void audio_init();
+void audio_init(MemoryArena* arena);
 void audio_deinit();
 
 i64 audio_load(MemoryArena* arena, String filepath);
@@ -36,12 +36,19 @@ static void recalculate_view(Camera* camera)
     camera->view.matrix[3][1] = x * sin - y * cos;
 }
 
-static void recalculate_projection(Camera* camera)
+static v2 get_half_view_size(const Camera* camera)
 {
     f32 half_height = 0.5f * game_render_height / camera->projection.zoom;
     f32 half_width = half_height * camera->projection.aspect_ratio;
 
-    camera->projection.matrix = glm::ortho(-half_width, half_width, -half_height, half_height);
+    return v2{ half_width, half_height };
+}
+
+static void recalculate_projection(Camera* camera)
+{
+    v2 half_size = get_half_view_size(camera);
+
+    camera->projection.matrix = glm::ortho(-half_size.x, half_size.x, -half_size.y, half_size.y);
 }
 
 const m4& camera_calculate_view_projection_matrix(Camera* camera)
@@ -65,6 +72,21 @@ const m4& camera_calculate_view_projection_matrix(Camera* camera)
     return camera->view_projection_matrix;
 }
 
+Collider_AABB camera_get_view_bounds(const Camera* camera)
+{
+    v2 half_size = get_half_view_size(camera);
+
+    // @NOTE(dubgron): The cached vectors may be out of date, if the view is dirty.
+    f32 sin = std::sin(camera->view.rotation);
+    f32 cos = std::cos(camera->view.rotation);
+
+    v2 right_offset = v2{ cos, sin } * half_size.x;
+    v2 up_offset = v2{ -sin, cos } * half_size.y;
+
+    v2 base_offset = camera->view.position - right_offset - up_offset;
+    return aabb_from_parallelogram(base_offset, right_offset * 2.f, up_offset * 2.f);
+}
+
 void camera_control_movement(Camera* camera)
 {
     if (input_is_held(Key_LShift))
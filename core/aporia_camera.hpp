@@ -1,5 +1,6 @@
 #pragma once
 
+#include "aporia_collision.hpp"
 #include "aporia_types.hpp"
 #include "aporia_memory.hpp"
 
@@ -42,6 +43,10 @@ struct Camera
 
 const m4& camera_calculate_view_projection_matrix(Camera* camera);
 
+// @NOTE(dubgron): The smallest AABB which contains the area seen by the camera, including
+// its rotation.
+Collider_AABB camera_get_view_bounds(const Camera* camera);
+
 void camera_control_movement(Camera* camera);
 void camera_control_rotation(Camera* camera);
 void camera_control_zoom(Camera* camera, f32 delta_time);
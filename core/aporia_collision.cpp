@@ -260,6 +260,73 @@ bool collision_check(const Collider& collider_a, const Collider& collider_b)
     return false;
 }
 
+Collider_AABB collider_get_bounds(const Collider& collider)
+{
+    Collider_AABB result;
+    switch (collider.type)
+    {
+        case ColliderType_AABB:
+        {
+            result = collider.aabb;
+        }
+        break;
+
+        case ColliderType_Circle:
+        {
+            result.base = collider.circle.base - collider.circle.radius;
+            result.width = result.height = collider.circle.radius * 2.f;
+        }
+        break;
+
+        case ColliderType_Polygon:
+        {
+            if (collider.polygon.point_count == 0)
+            {
+                break;
+            }
+
+            v2 lower = collider.polygon.points[0];
+            v2 upper = collider.polygon.points[0];
+
+            for (i64 idx = 1; idx < collider.polygon.point_count; ++idx)
+            {
+                lower = glm::min(lower, collider.polygon.points[idx]);
+                upper = glm::max(upper, collider.polygon.points[idx]);
+            }
+
+            result.base = lower;
+            result.width = upper.x - lower.x;
+            result.height = upper.y - lower.y;
+        }
+        break;
+    }
+    return result;
+}
+
+Collider_AABB aabb_from_parallelogram(v2 base, v2 right, v2 up)
+{
+    v2 lower = base + glm::min(right, v2{ 0.f }) + glm::min(up, v2{ 0.f });
+    v2 upper = base + glm::max(right, v2{ 0.f }) + glm::max(up, v2{ 0.f });
+
+    Collider_AABB result;
+    result.base = lower;
+    result.width = upper.x - lower.x;
+    result.height = upper.y - lower.y;
+    return result;
+}
+
+Collider_AABB aabb_union(const Collider_AABB& aabb_a, const Collider_AABB& aabb_b)
+{
+    v2 lower = glm::min(aabb_a.base, aabb_b.base);
+    v2 upper = glm::max(aabb_a.base + v2{ aabb_a.width, aabb_a.height }, aabb_b.base + v2{ aabb_b.width, aabb_b.height });
+
+    Collider_AABB result;
+    result.base = lower;
+    result.width = upper.x - lower.x;
+    result.height = upper.y - lower.y;
+    return result;
+}
+
 void draw_collider(const Collider& collider, f32 thickness /* = 1.f */, Color color /* = Color::Magenta */)
 {
     switch (collider.type)
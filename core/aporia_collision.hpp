@@ -58,6 +58,15 @@ bool collision_polygon_to_polygon(const Collider_Polygon& polygon_a, const Colli
 
 bool collision_check(const Collider& collider_a, const Collider& collider_b);
 
+// @NOTE(dubgron): The smallest AABB which contains the whole collider. The bounds of
+// ColliderType_None are empty, so they never collide with anything.
+Collider_AABB collider_get_bounds(const Collider& collider);
+
+// @NOTE(dubgron): The smallest AABB which contains the parallelogram with the corners at
+// base, base + right, base + up and base + right + up.
+Collider_AABB aabb_from_parallelogram(v2 base, v2 right, v2 up);
+Collider_AABB aabb_union(const Collider_AABB& aabb_a, const Collider_AABB& aabb_b);
+
 // Debug Visualization
 void draw_collider(const Collider& collider, f32 thickness = 1.f, Color color = Color::Magenta);
 void draw_collider_aabb(const Collider_AABB& aabb, f32 thickness = 1.f, Color color = Color::Magenta);
@@ -0,0 +1,103 @@
+#pragma once
+
+#include "aporia_debug.hpp"
+#include "aporia_memory.hpp"
+#include "aporia_types.hpp"
+#include "aporia_utils.hpp"
+
+constexpr i64 DYNAMIC_ARRAY_MIN_CAPACITY = 16;
+
+// @NOTE(dubgron): The dynamic array owns an arena, which reserves the address space
+// for max_count elements up front. The memory is committed only as the array grows,
+// doubling its capacity each time. The elements never move, so the pointers to them
+// stay valid for the whole lifetime of the array. Note that max_count only limits the
+// reserved address space, it doesn't cost any physical memory.
+template<typename T>
+struct DynamicArray
+{
+    MemoryArena arena;
+
+    T* data = nullptr;
+    i64 count = 0;
+    i64 capacity = 0;
+    i64 max_count = 0;
+};
+
+template<typename T>
+DynamicArray<T> dynamic_array_create(i64 max_count SOURCE_LOCATION_PARAM)
+{
+    APORIA_ASSERT(max_count > 0);
+
+    DynamicArray<T> result;
+    result.arena = arena_init(max_count * sizeof(T), ARENA_DEFAULT_DECOMMIT_THRESHOLD SOURCE_LOCATION_ARG);
+
+    // @NOTE(dubgron): The arena must not insert any padding between the consecutive
+    // pushes, otherwise the elements wouldn't be contiguous.
+    result.arena.align = alignof(T);
+
+    result.data = (T*)result.arena.memory;
+    result.max_count = max_count;
+
+    return result;
+}
+
+template<typename T>
+void dynamic_array_destroy(DynamicArray<T>* array)
+{
+    arena_deinit(&array->arena);
+    *array = DynamicArray<T>{};
+}
+
+template<typename T>
+bool dynamic_array_is_created(DynamicArray<T>* array)
+{
+    return array->data != nullptr;
+}
+
+template<typename T>
+void dynamic_array_reserve(DynamicArray<T>* array, i64 capacity)
+{
+    if (capacity <= array->capacity)
+    {
+        return;
+    }
+
+    APORIA_ASSERT_WITH_MESSAGE(capacity <= array->max_count,
+        "Can't grow the dynamic array to % elements! Max: % elements", capacity, array->max_count);
+
+    i64 new_capacity = max(array->capacity * 2, DYNAMIC_ARRAY_MIN_CAPACITY);
+    new_capacity = clamp(new_capacity, capacity, array->max_count);
+
+    arena_push_uninitialized<T>(&array->arena, new_capacity - array->capacity);
+    array->capacity = new_capacity;
+}
+
+template<typename T>
+T* dynamic_array_push(DynamicArray<T>* array, const T& value = T{})
+{
+    dynamic_array_reserve(array, array->count + 1);
+
+    T* result = &array->data[array->count];
+    *result = value;
+    array->count += 1;
+
+    return result;
+}
+
+template<typename T>
+void dynamic_array_resize(DynamicArray<T>* array, i64 count)
+{
+    dynamic_array_reserve(array, count);
+
+    for (i64 idx = array->count; idx < count; ++idx)
+    {
+        array->data[idx] = T{};
+    }
+    array->count = count;
+}
+
+template<typename T>
+void dynamic_array_clear(DynamicArray<T>* array)
+{
+    array->count = 0;
+}
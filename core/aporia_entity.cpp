@@ -7,24 +7,24 @@ bool operator==(EntityID id0, EntityID id1)
     return id0.index == id1.index && id0.generation == id1.generation;
 }
 
-bool entity_flags_has_all(const Entity& entity, EntityFlags flags)
+bool entity_flags_has_all(EntityFlags entity_flags, EntityFlags flags)
 {
-    return (entity.flags & flags) == flags;
+    return (entity_flags & flags) == flags;
 }
 
-bool entity_flags_has_any(const Entity& entity, EntityFlags flags)
+bool entity_flags_has_any(EntityFlags entity_flags, EntityFlags flags)
 {
-    return (entity.flags & flags) != 0;
+    return (entity_flags & flags) != 0;
 }
 
-void entity_flags_set(Entity* entity, EntityFlags flags)
+void entity_flags_set(EntityFlags* entity_flags, EntityFlags flags)
 {
-    entity->flags |= flags;
+    *entity_flags |= flags;
 }
 
-void entity_flags_unset(Entity* entity, EntityFlags flags)
+void entity_flags_unset(EntityFlags* entity_flags, EntityFlags flags)
 {
-    entity->flags &= ~flags;
+    *entity_flags &= ~flags;
 }
 
 String entity_type_to_string(EntityType type)
@@ -38,48 +38,48 @@ String entity_type_to_string(EntityType type)
     }
 }
 
-void entity_adjust_size_to_texture(Entity* entity)
+void entity_adjust_size_to_texture(EntityTransform* transform, const EntityRender& render)
 {
-    get_subtexture_size(entity->texture, &entity->width, &entity->height);
+    get_subtexture_size(render.texture, &transform->width, &transform->height);
 }
 
-Collider entity_collider_from_local_to_world(const Entity& entity)
+Collider entity_collider_from_local_to_world(const Collider& collider, const EntityTransform& transform, v2* out_points /* = nullptr */)
 {
-    Collider result = entity.collider;
+    Collider result = collider;
     switch (result.type)
     {
         case ColliderType_AABB:
         {
-            v2 scaled_size = v2{ entity.width, entity.height } * entity.scale;
-            v2 offset_from_center = scaled_size * entity.center_of_rotation;
-            v2 base_offset = entity.position - offset_from_center;
+            v2 scaled_size = v2{ transform.width, transform.height } * transform.scale;
+            v2 offset_from_center = scaled_size * transform.center_of_rotation;
+            v2 base_offset = transform.position - offset_from_center;
 
             result.aabb.base += base_offset;
-            result.aabb.width *= entity.scale.x;
-            result.aabb.height *= entity.scale.y;
+            result.aabb.width *= transform.scale.x;
+            result.aabb.height *= transform.scale.y;
         }
         break;
 
         case ColliderType_Circle:
         {
-            result.circle.base += entity.position;
-            result.circle.radius *= max(entity.scale.x, entity.scale.y);
+            result.circle.base += transform.position;
+            result.circle.radius *= max(transform.scale.x, transform.scale.y);
         }
         break;
 
         case ColliderType_Polygon:
         {
-            f32 sin = std::sin(entity.rotation);
-            f32 cos = std::cos(entity.rotation);
+            f32 sin = std::sin(transform.rotation);
+            f32 cos = std::cos(transform.rotation);
 
-            v2 right_offset = v2{ cos, sin } * entity.scale.x;
-            v2 up_offset = v2{ -sin, cos } * entity.scale.y;
+            v2 right_offset = v2{ cos, sin } * transform.scale.x;
+            v2 up_offset = v2{ -sin, cos } * transform.scale.y;
 
-            result.polygon.points = arena_push_uninitialized<v2>(&memory.frame, result.polygon.point_count);
+            result.polygon.points = out_points ? out_points : arena_push_uninitialized<v2>(&memory.frame, result.polygon.point_count);
             for (i64 idx = 0; idx < result.polygon.point_count; ++idx)
             {
-                v2 local_position = entity.collider.polygon.points[idx];
-                result.polygon.points[idx] = entity.position + (right_offset * local_position.x) + (up_offset * local_position.y);
+                v2 local_position = collider.polygon.points[idx];
+                result.polygon.points[idx] = transform.position + (right_offset * local_position.x) + (up_offset * local_position.y);
             }
         }
         break;
@@ -87,16 +87,35 @@ Collider entity_collider_from_local_to_world(const Entity& entity)
     return result;
 }
 
-Entity entity_lerp(const Entity& e0, const Entity& e1, f32 t)
+Collider_AABB entity_transform_get_bounds(const EntityTransform& transform)
 {
-    Entity result = e0;
-    result.position = lerp(e0.position, e1.position, t);
-    result.z = lerp(e0.z, e1.z, t);
-    result.rotation = lerp(e0.rotation, e1.rotation, t);
-    result.center_of_rotation = lerp(e0.center_of_rotation, e1.center_of_rotation, t);
-    result.width = lerp(e0.width, e1.width, t);
-    result.height = lerp(e0.height, e1.height, t);
-    result.scale = lerp(e0.scale, e1.scale, t);
-    result.color = lerp(e0.color, e1.color, t);
+    v2 size = v2{ transform.width, transform.height } * transform.scale;
+
+    if (transform.rotation == 0.f)
+    {
+        v2 base_offset = transform.position - size * transform.center_of_rotation;
+        return aabb_from_parallelogram(base_offset, v2{ size.x, 0.f }, v2{ 0.f, size.y });
+    }
+
+    f32 sin = std::sin(transform.rotation);
+    f32 cos = std::cos(transform.rotation);
+
+    v2 right_offset = v2{ cos, sin } * size.x;
+    v2 up_offset = v2{ -sin, cos } * size.y;
+
+    v2 base_offset = transform.position - right_offset * transform.center_of_rotation.x - up_offset * transform.center_of_rotation.y;
+    return aabb_from_parallelogram(base_offset, right_offset, up_offset);
+}
+
+EntityTransform entity_transform_lerp(const EntityTransform& t0, const EntityTransform& t1, f32 t)
+{
+    EntityTransform result;
+    result.position = lerp(t0.position, t1.position, t);
+    result.z = lerp(t0.z, t1.z, t);
+    result.rotation = lerp(t0.rotation, t1.rotation, t);
+    result.center_of_rotation = lerp(t0.center_of_rotation, t1.center_of_rotation, t);
+    result.width = lerp(t0.width, t1.width, t);
+    result.height = lerp(t0.height, t1.height, t);
+    result.scale = lerp(t0.scale, t1.scale, t);
     return result;
 }
@@ -19,7 +19,17 @@ enum EntityFlag_ : EntityFlags
     EntityFlag_BlockingLight                = 0x0020,
     EntityFlag_SkipInterpolationNextFrame   = 0x0040,
 
+    // @NOTE(dubgron): The entity never moves, so it's drawn from the static batches, which
+    // are rebuilt only when a static entity changes (see world_mark_static_entities_changed).
+    EntityFlag_Static                       = 0x0080,
+
     EntityFlag_CollisionEnabled             = 0x0100,
+
+    // @NOTE(dubgron): The cached world-space collider and bounds of the entity are out of date.
+    // Anything writing to the transform or the collider of the entity must set it, otherwise
+    // the entity collides and is culled at its old position. The accessors and the deferred
+    // commands of the World, and world_run_system, set it for you.
+    EntityFlag_WorldColliderDirty           = 0x0200,
 };
 
 enum EntityType : u32
@@ -38,14 +48,8 @@ struct EntityID
 
 bool operator==(EntityID id0, EntityID id1);
 
-struct Entity
+struct EntityTransform
 {
-    EntityID id;
-    Entity* next = nullptr;
-
-    EntityFlags flags = EntityFlag_Visible | EntityFlag_BlockingLight;
-    EntityType type = Entity_None;
-
     v2 position{ 0.f };
     f32 z = 0.f;
 
@@ -55,25 +59,59 @@ struct Entity
     f32 width = 0.f;
     f32 height = 0.f;
     v2 scale{ 1.f };
+};
 
+struct EntityRender
+{
     SubTexture texture;
     Color color = Color::White;
     u32 shader_id = default_shader;
+};
+
+// @NOTE(dubgron): The part of the state of an entity, which is interpolated between
+// the fixed steps of the simulation.
+struct EntitySnapshot
+{
+    EntityTransform transform;
+    Color color = Color::White;
+};
+
+// @NOTE(dubgron): The world doesn't store the entities in this form, it keeps every
+// component in a separate array instead (see World). This struct is only a copy of all
+// the components of a single entity, used where the whole entity has to be handled at
+// once, e.g. in the editor or in the serialization.
+struct Entity
+{
+    EntityID id;
+
+    EntityFlags flags = EntityFlag_Visible | EntityFlag_BlockingLight;
+    EntityType type = Entity_None;
+
+    // @NOTE(dubgron): The prefab the entity has been created from, if any (see Prefab).
+    Atom prefab;
+
+    EntityTransform transform;
+    EntityRender render;
 
     Animator animator;
 
     Collider collider;
 };
 
-bool entity_flags_has_all(const Entity& entity, EntityFlags flags);
-bool entity_flags_has_any(const Entity& entity, EntityFlags flags);
-void entity_flags_set(Entity* entity, EntityFlags flags);
-void entity_flags_unset(Entity* entity, EntityFlags flags);
+bool entity_flags_has_all(EntityFlags entity_flags, EntityFlags flags);
+bool entity_flags_has_any(EntityFlags entity_flags, EntityFlags flags);
+void entity_flags_set(EntityFlags* entity_flags, EntityFlags flags);
+void entity_flags_unset(EntityFlags* entity_flags, EntityFlags flags);
 
 String entity_type_to_string(EntityType type);
 
-void entity_adjust_size_to_texture(Entity* entity);
+void entity_adjust_size_to_texture(EntityTransform* transform, const EntityRender& render);
+
+// @NOTE(dubgron): The points of a polygon are written to out_points, which must fit all of
+// them. If out_points is nullptr, they're allocated on the frame arena.
+Collider entity_collider_from_local_to_world(const Collider& collider, const EntityTransform& transform, v2* out_points = nullptr);
 
-Collider entity_collider_from_local_to_world(const Entity& entity);
+// @NOTE(dubgron): The bounds of the quad the entity is drawn with.
+Collider_AABB entity_transform_get_bounds(const EntityTransform& transform);
 
-Entity entity_lerp(const Entity& e0, const Entity& e1, f32 t);
+EntityTransform entity_transform_lerp(const EntityTransform& t0, const EntityTransform& t1, f32 t);
@@ -1,14 +1,16 @@
 #include "aporia_fonts.hpp"
 
 #include "aporia_debug.hpp"
+#include "aporia_dynamic_array.hpp"
 #include "aporia_game.hpp"
 #include "aporia_parser.hpp"
 #include "aporia_utils.hpp"
 
-static constexpr u64 MAX_FONTS = 10;
+// @NOTE(dubgron): This is only the size of the reserved address space, the array
+// commits the memory as it grows.
+static constexpr i64 MAX_FONTS = 1024;
 
-static Font fonts[MAX_FONTS];
-static u64 fonts_count = 0;
+static DynamicArray<Font> fonts;
 
 // @TODO(dubgron): The arena should be parameterized in the future.
 void load_font(String name, String filepath)
@@ -19,9 +21,14 @@ void load_font(String name, String filepath)
     String png_filepath = replace_extension(temp.arena, filepath, "png");
     String config_filepath = replace_extension(temp.arena, filepath, "aporia-config");
 
-    for (u64 idx = 0; idx < fonts_count; ++idx)
+    if (!dynamic_array_is_created(&fonts))
     {
-        if (fonts[idx].name == name)
+        fonts = dynamic_array_create<Font>(MAX_FONTS);
+    }
+
+    for (i64 idx = 0; idx < fonts.count; ++idx)
+    {
+        if (fonts.data[idx].name == name)
         {
             APORIA_LOG(Warning, "Already loaded font named '%'!", name);
             return;
@@ -36,9 +43,12 @@ void load_font(String name, String filepath)
     // GL_NEAREST, as it works best with pixelart, but fonts look better
     // with linear filtering. Choosing filter should not require to overwrite
     // it after loading the texture.
-    glActiveTexture(GL_TEXTURE0);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    if (!engine_is_headless)
+    {
+        glActiveTexture(GL_TEXTURE0);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    }
 
     ParseTreeNode* parsed_file = parse_from_file(temp.arena, config_filepath);
 
@@ -229,17 +239,16 @@ void load_font(String name, String filepath)
         }
     }
 
-    fonts[fonts_count] = result;
-    fonts_count += 1;
+    dynamic_array_push(&fonts, result);
 }
 
 Font* get_font(String name)
 {
-    for (i64 idx = 0; idx < fonts_count; ++idx)
+    for (i64 idx = 0; idx < fonts.count; ++idx)
     {
-        if (fonts[idx].name == name)
+        if (fonts.data[idx].name == name)
         {
-            return &fonts[idx];
+            return &fonts.data[idx];
         }
     }
 
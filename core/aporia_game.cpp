@@ -6,10 +6,13 @@
 
 #include "aporia_animations.hpp"
 #include "aporia_assets.hpp"
+#include "aporia_atoms.hpp"
 #include "aporia_audio.hpp"
 #include "aporia_camera.hpp"
 #include "aporia_config.hpp"
 #include "aporia_debug.hpp"
+#include "aporia_jobs.hpp"
+#include "aporia_prefabs.hpp"
 #include "aporia_rendering.hpp"
 #include "aporia_window.hpp"
 #include "aporia_world.hpp"
@@ -18,12 +21,30 @@
 #include "editor/aporia_editor.hpp"
 #endif
 
+#if defined(APORIA_BENCHMARKS)
+#include "benchmarks/aporia_benchmarks.hpp"
+#endif
+
 GameMemory memory;
 
+bool engine_is_headless = false;
+
+// @NOTE(dubgron): Set with --worlds and --steps. A negative step count runs the simulation
+// until the process is killed.
+static i64 headless_world_count = 1;
+static i64 headless_step_count = -1;
+
+// @NOTE(dubgron): The number of steps, which the headless mode runs between the reports.
+static constexpr i64 HEADLESS_STEPS_PER_BATCH = 60;
+
 static void game_initialize()
 {
 }
 
+static void game_initialize_world(World* world)
+{
+}
+
 static void game_handle_input(f32 frame_time)
 {
 }
@@ -32,7 +53,7 @@ static void game_update_frame(f32 frame_time)
 {
 }
 
-static void game_simulate_frame(f32 time, f32 delta_time)
+static void game_simulate_frame(World* world, f32 time, f32 delta_time)
 {
 }
 
@@ -48,6 +69,19 @@ static void game_shutdown()
 {
 }
 
+static void tick_entity_animations(WorldChunk* chunk, void* user_data)
+{
+    f32 frame_time = *(f32*)user_data;
+    World* world = chunk->world;
+
+    WorldQuery visible = world_query(&chunk->arena, chunk, EntityFlag_Visible);
+    for (i64 query_idx = 0; query_idx < visible.count; ++query_idx)
+    {
+        i32 idx = visible.indices[query_idx];
+        animation_tick(&world->animators.data[idx], &world->renders.data[idx].texture, frame_time);
+    }
+}
+
 static Timer frame_timer;
 static f32 total_time = 0.f;
 static f32 game_time = 0.f;
@@ -91,42 +125,65 @@ static void game_main_loop()
         {
             world_next_frame(&current_world);
 
-            game_simulate_frame(game_time, delta_time);
+            game_simulate_frame(&current_world, game_time, delta_time);
+            world_apply_deferred_changes(&current_world);
+
             accumulated_frame_time -= delta_time;
         }
+
+        world_run_system(&current_world, tick_entity_animations, &frame_time, WorldComponent_Render | WorldComponent_Animator);
+        world_apply_deferred_changes(&current_world);
     }
 
     rendering_frame_begin();
     {
-        for (i64 idx = 0; idx < current_world.entity_count; ++idx)
+        const EntitySnapshot* last_frame = world_get_snapshot(&current_world);
+
+        ScratchArena temp = scratch_begin();
+
+        world_update_colliders(&current_world);
+
+        WorldQuery visible = world_query(temp.arena, &current_world, EntityFlag_Visible);
+        for (i64 query_idx = 0; query_idx < visible.count; ++query_idx)
         {
-            Entity* entity = &current_world.entity_array[idx];
-            if (entity_flags_has_all(*entity, EntityFlag_Active | EntityFlag_Visible))
+            i32 idx = visible.indices[query_idx];
+
+            EntityID entity_id = current_world.ids.data[idx];
+            const EntityTransform& transform = current_world.transforms.data[idx];
+            const EntityRender& render = current_world.renders.data[idx];
+
+            if (is_drawn_from_static_batches(current_world.flags.data[idx], render, current_world.animators.data[idx]))
             {
+                continue;
+            }
+
+            // @NOTE(dubgron): The render bounds cover both the quad from the last snapshot and
+            // the current one, so they contain every quad the entity can be interpolated to.
+            if (!is_in_camera_view(current_world.render_bounds.data[idx]))
+            {
+                continue;
+            }
+
 #if defined(APORIA_EDITOR)
-                if (editor_is_open)
-                {
-                    draw_entity(*entity);
-                }
-                else
+            if (editor_is_open)
+            {
+                draw_entity(entity_id, transform, render);
+            }
+            else
 #endif
-                {
-                    animation_tick(entity, frame_time);
-
-                    if (entity_flags_has_all(*entity, EntityFlag_SkipInterpolationNextFrame))
-                    {
-                        draw_entity(*entity);
-                    }
-                    else
-                    {
-                        f32 alpha = accumulated_frame_time / delta_time;
-                        Entity entity_interpolated = entity_lerp(current_world.entity_array_last_frame[idx], *entity, alpha);
-                        draw_entity(entity_interpolated);
-                    }
-                }
+            if (entity_flags_has_all(current_world.flags.data[idx], EntityFlag_SkipInterpolationNextFrame))
+            {
+                draw_entity(entity_id, transform, render);
+            }
+            else
+            {
+                f32 alpha = accumulated_frame_time / delta_time;
+                draw_entity_interpolated(entity_id, last_frame[idx], transform, render, alpha);
             }
         }
 
+        scratch_end(temp);
+
         game_draw_frame(frame_time);
     }
     rendering_frame_end();
@@ -149,45 +206,153 @@ static void game_main_loop()
     window_display();
 }
 
+// @NOTE(dubgron): Every world runs on its own job, so the worlds are simulated in parallel.
+// They advance in lockstep, HEADLESS_STEPS_PER_BATCH steps at a time, so in between the
+// batches the main thread can report the progress. The jobs don't touch memory.frame, which
+// is used only by the main thread. Every world has its own step_arena instead, which is
+// cleared by world_next_frame at the beginning of each step.
+static void engine_run_headless()
+{
+    World** worlds = arena_push<World*>(&memory.persistent, headless_world_count);
+    worlds[0] = &current_world;
+
+    for (i64 world_idx = 1; world_idx < headless_world_count; ++world_idx)
+    {
+        worlds[world_idx] = arena_push<World>(&memory.persistent);
+        *worlds[world_idx] = world_init();
+
+        game_initialize_world(worlds[world_idx]);
+    }
+
+    APORIA_LOG(Info, "Running % world(s) headless, for % steps.", headless_world_count, headless_step_count);
+
+    Timer total_timer;
+    Timer report_timer;
+
+    i64 steps_done = 0;
+    i64 steps_since_report = 0;
+
+    while (headless_step_count < 0 || steps_done < headless_step_count)
+    {
+        i64 batch_step_count = HEADLESS_STEPS_PER_BATCH;
+        if (headless_step_count >= 0)
+        {
+            batch_step_count = min(batch_step_count, headless_step_count - steps_done);
+        }
+
+        arena_clear(&memory.frame);
+
+        parallel_for(headless_world_count, 1, [&](i64 begin, i64 end)
+        {
+            for (i64 world_idx = begin; world_idx < end; ++world_idx)
+            {
+                World* world = worlds[world_idx];
+
+                for (i64 step_idx = 0; step_idx < batch_step_count; ++step_idx)
+                {
+                    f32 time = (steps_done + step_idx + 1) * delta_time;
+
+                    world_next_frame(world);
+
+                    game_simulate_frame(world, time, delta_time);
+                    world_apply_deferred_changes(world);
+                }
+            }
+        });
+
+        steps_done += batch_step_count;
+        steps_since_report += batch_step_count;
+
+        f32 elapsed_time = report_timer.get_elapsed_time();
+        if (elapsed_time >= 1.f)
+        {
+            f32 steps_per_second = steps_since_report / elapsed_time;
+            APORIA_LOG(Info, "Step %: % steps/s per world, % steps/s in total.",
+                steps_done, steps_per_second, steps_per_second * headless_world_count);
+
+            steps_since_report = 0;
+            report_timer.reset();
+        }
+    }
+
+    f32 total_time = total_timer.get_elapsed_time();
+    f32 steps_per_second = steps_done / max(total_time, 0.001f);
+    APORIA_LOG(Info, "Simulated % steps of % world(s) in % s: % steps/s per world, % steps/s in total.",
+        steps_done, headless_world_count, total_time, steps_per_second, steps_per_second * headless_world_count);
+}
+
 static void engine_main(String config_filepath)
 {
     // Init
     {
+#if defined(APORIA_EMSCRIPTEN)
+        // @NOTE(dubgron): Emscripten implements mmap on top of malloc, so the whole
+        // reserved range gets allocated immediately. Keep the reservations small there.
         memory.persistent = arena_init(MEGABYTES(100));
         memory.frame = arena_init(MEGABYTES(1));
         memory.config = arena_init(KILOBYTES(10));
         memory.assets = arena_init(KILOBYTES(100)); // @TODO(dubgron): This arena should store the assets.
 
         temporary_memory_init(MEGABYTES(10));
+#else
+        // @NOTE(dubgron): These are only reservations of the address space. The memory
+        // gets committed as the arenas grow, so we can be generous here.
+        memory.persistent = arena_init(GIGABYTES(4));
+        memory.frame = arena_init(GIGABYTES(1));
+        memory.config = arena_init(MEGABYTES(64));
+        memory.assets = arena_init(MEGABYTES(256)); // @TODO(dubgron): This arena should store the assets.
+
+        temporary_memory_init(GIGABYTES(1));
+#endif
 
         LOGGING_INIT(&memory.persistent, "aporia");
 
+        atoms_init();
+        jobs_init();
+
         assets_init();
 
         bool config_loaded_successfully = load_engine_config(config_filepath);
         APORIA_ASSERT(config_loaded_successfully);
 
-        window_create(&memory.persistent);
-        camera_apply_config(&active_camera);
+        if (!engine_is_headless)
+        {
+            window_create(&memory.persistent);
+            camera_apply_config(&active_camera);
+
+            opengl_init();
+            shaders_init();
+            rendering_init(&memory.persistent);
+        }
 
-        opengl_init();
-        shaders_init(&memory.persistent);
-        rendering_init(&memory.persistent);
         animations_init(&memory.persistent);
-        audio_init();
+        prefabs_init(&memory.persistent);
+        audio_init(&memory.persistent);
 
         current_world = world_init();
 
-        IMGUI_INIT();
+        if (!engine_is_headless)
+        {
+            IMGUI_INIT();
+        }
 
         game_initialize();
+        game_initialize_world(&current_world);
 
 #if defined(APORIA_EDITOR)
-        watch_project_directory();
+        if (!engine_is_headless)
+        {
+            watch_project_directory();
+        }
 #endif
     }
 
     // Update
+    if (engine_is_headless)
+    {
+        engine_run_headless();
+    }
+    else
     {
         world_next_frame(&current_world);
 
@@ -205,6 +370,10 @@ static void engine_main(String config_filepath)
     {
         game_shutdown();
 
+#if defined(APORIA_DEBUGTOOLS)
+        log_memory_telemetry();
+#endif
+
         LOGGING_DEINIT();
 
         return;
@@ -213,17 +382,23 @@ static void engine_main(String config_filepath)
         // the OS will free this memory for us. Doing it manually has no benefits and it
         // slows down the shutdown of the engine.
 
-        IMGUI_DEINIT();
-
         world_deinit(&current_world);
 
         audio_deinit();
-        rendering_deinit();
 
-        window_destroy();
+        if (!engine_is_headless)
+        {
+            IMGUI_DEINIT();
+
+            rendering_deinit();
+            window_destroy();
+        }
 
         assets_deinit();
 
+        jobs_deinit();
+        atoms_deinit();
+
         temporary_memory_deinit();
 
         arena_deinit(&memory.assets);
@@ -235,6 +410,41 @@ static void engine_main(String config_filepath)
 
 int main(int argc, char** argv)
 {
+#if defined(APORIA_BENCHMARKS)
+    String benchmark_name;
+#endif
+
+    for (i32 idx = 1; idx < argc; ++idx)
+    {
+        String arg = argv[idx];
+        if (arg == "--headless")
+        {
+            engine_is_headless = true;
+        }
+        else if (arg == "--worlds" && idx + 1 < argc)
+        {
+            headless_world_count = max(string_to_int(argv[++idx]), (i64)1);
+        }
+        else if (arg == "--steps" && idx + 1 < argc)
+        {
+            headless_step_count = string_to_int(argv[++idx]);
+        }
+#if defined(APORIA_BENCHMARKS)
+        else if (arg == "--benchmark" && idx + 1 < argc)
+        {
+            benchmark_name = argv[++idx];
+        }
+#endif
+    }
+
+#if defined(APORIA_BENCHMARKS)
+    if (!benchmark_name.is_empty())
+    {
+        benchmarks_main(benchmark_name);
+        return 0;
+    }
+#endif
+
     engine_main("content/settings.aporia-config");
     return 0;
 }
@@ -11,3 +11,8 @@ struct GameMemory
 };
 
 extern GameMemory memory;
+
+// @NOTE(dubgron): In the headless mode the engine doesn't create the window, nor does it
+// initialize the rendering and the audio devices. It only runs the simulation as fast as it
+// can, which is meant for the batch runs (e.g. the balance simulations or the replays).
+extern bool engine_is_headless;
@@ -5,23 +5,43 @@
 #include "aporia_string.hpp"
 #include "aporia_utils.hpp"
 
-constexpr i64 FIRST_VALID_HASH = 0;
-constexpr i64 NEVER_OCCUPIED_HASH = -1;
-constexpr i64 REMOVED_HASH = -2;
+// @NOTE(dubgron): Every bucket has a control byte. The byte of a valid bucket stores the
+// lowest 7 bits of its hash, so the top bit is set only for the empty and removed ones.
+constexpr u8 CONTROL_EMPTY = 0x80;
+constexpr u8 CONTROL_REMOVED = 0xFE;
 
-constexpr i64 MAX_LOAD_FACTOR_PERCENT = 70;
+constexpr i64 HASH_TABLE_GROUP_SIZE = 16;
 
-// @NOTE(dubgron): Remember that this hash table does not automatically resize!
-template<typename T>
+constexpr i64 MAX_LOAD_FACTOR_PERCENT = 70;
+constexpr i64 MIN_BUCKET_COUNT = HASH_TABLE_GROUP_SIZE;
+
+// @NOTE(dubgron): The hash table probes the control bytes a group of 16 buckets at a time,
+// and looks at the buckets only when the 7 bits of the hash match. The buckets themselves
+// are stored out of line, so the probing doesn't pull them into the cache.
+//
+// The hash table rehashes itself when inserting into it would exceed the max load factor.
+// Keep in mind that the rehash moves the buckets, so the pointers to the values are valid
+// only until the next insert.
+//
+// The keys are hashed with 'get_hash' and compared with 'operator=='.
+template<typename T, typename K = String>
 struct HashTable
 {
+    using Key = K;
+
     struct Bucket
     {
-        i64 hash = NEVER_OCCUPIED_HASH;
-        String key;
+        u32 hash = 0;
+        K key;
         T value;
     };
 
+    MemoryArena* arena = nullptr;
+
+    // @NOTE(dubgron): There are HASH_TABLE_GROUP_SIZE more control bytes than buckets. The
+    // bytes at the end mirror the first ones, so a group starting near the end of the
+    // table can be loaded with a single read.
+    u8* control = nullptr;
     Bucket* buckets = nullptr;
     i64 bucket_count = 0;
 
@@ -41,42 +61,159 @@ static u64 next_power_of_two(u64 n)
     return result;
 }
 
-template<typename T>
-bool hash_table_is_created(HashTable<T>* hash_table)
+// @NOTE(dubgron): The group masks have a bit set for every matching bucket in the group.
+// NEON doesn't have an equivalent of movemask, so its masks use 4 bits per bucket.
+#if defined(APORIA_NEON)
+constexpr u32 HASH_TABLE_GROUP_MASK_SHIFT = 2;
+#else
+constexpr u32 HASH_TABLE_GROUP_MASK_SHIFT = 0;
+#endif
+
+#if !defined(APORIA_SSE2) && !defined(APORIA_NEON)
+constexpr u64 HASH_TABLE_LOW_BITS = 0x0101010101010101ull;
+constexpr u64 HASH_TABLE_HIGH_BITS = 0x8080808080808080ull;
+
+// @NOTE(dubgron): Without SIMD, the group is processed as two 64-bit words. This takes
+// the top bits of the 8 bytes of a word and packs them into an 8-bit mask.
+static inline u64 hash_table_pack_high_bits(u64 high_bits)
 {
-    return hash_table->buckets && hash_table->bucket_count > 0;
+    return ((high_bits >> 7) * 0x0102040810204080ull) >> 56;
 }
 
-template<typename T>
-HashTable<T> hash_table_create(MemoryArena* arena, i64 bucket_count)
+static inline u64 hash_table_load_word(const u8* group, i64 word_index)
 {
-    // @NOTE(dubgron): The number of buckets in the hash table should be a power of 2.
-    // For explanation, see 'hash_table_wrap_around' function.
-    if ((bucket_count & (bucket_count - 1)) != 0)
+    u64 result;
+    memcpy(&result, group + word_index * sizeof(u64), sizeof(u64));
+    return result;
+}
+#endif
+
+// @NOTE(dubgron): The mask can have false positives, so the keys of the matching buckets
+// still have to be compared.
+static inline u64 hash_table_group_match(const u8* group, u8 control)
+{
+#if defined(APORIA_SSE2)
+    __m128i bytes = _mm_loadu_si128((const __m128i*)group);
+    __m128i matches = _mm_cmpeq_epi8(bytes, _mm_set1_epi8((char)control));
+    return (u32)_mm_movemask_epi8(matches);
+#elif defined(APORIA_NEON)
+    uint8x16_t bytes = vld1q_u8(group);
+    uint8x16_t matches = vceqq_u8(bytes, vdupq_n_u8(control));
+    uint8x8_t narrowed = vshrn_n_u16(vreinterpretq_u16_u8(matches), 4);
+    return vget_lane_u64(vreinterpret_u64_u8(narrowed), 0) & 0x8888888888888888ull;
+#else
+    u64 result = 0;
+    for (i64 word_index = 0; word_index < 2; ++word_index)
     {
-        bucket_count = next_power_of_two(bucket_count);
+        u64 word = hash_table_load_word(group, word_index) ^ (HASH_TABLE_LOW_BITS * control);
+        u64 zero_bytes = (word - HASH_TABLE_LOW_BITS) & ~word & HASH_TABLE_HIGH_BITS;
+        result |= hash_table_pack_high_bits(zero_bytes) << (word_index * 8);
     }
+    return result;
+#endif
+}
 
-    using HashTableBucket = typename HashTable<T>::Bucket;
+static inline u64 hash_table_group_match_empty(const u8* group)
+{
+#if defined(APORIA_SSE2) || defined(APORIA_NEON)
+    return hash_table_group_match(group, CONTROL_EMPTY);
+#else
+    // @NOTE(dubgron): Both CONTROL_EMPTY and CONTROL_REMOVED have the top bit set, but
+    // only CONTROL_EMPTY has the second lowest bit clear.
+    u64 result = 0;
+    for (i64 word_index = 0; word_index < 2; ++word_index)
+    {
+        u64 word = hash_table_load_word(group, word_index);
+        u64 empty_bytes = word & ~(word << 6) & HASH_TABLE_HIGH_BITS;
+        result |= hash_table_pack_high_bits(empty_bytes) << (word_index * 8);
+    }
+    return result;
+#endif
+}
+
+static inline u64 hash_table_group_match_empty_or_removed(const u8* group)
+{
+#if defined(APORIA_SSE2)
+    __m128i bytes = _mm_loadu_si128((const __m128i*)group);
+    return (u32)_mm_movemask_epi8(bytes);
+#elif defined(APORIA_NEON)
+    uint8x16_t bytes = vld1q_u8(group);
+    uint8x16_t matches = vcgeq_u8(bytes, vdupq_n_u8(CONTROL_EMPTY));
+    uint8x8_t narrowed = vshrn_n_u16(vreinterpretq_u16_u8(matches), 4);
+    return vget_lane_u64(vreinterpret_u64_u8(narrowed), 0) & 0x8888888888888888ull;
+#else
+    u64 result = 0;
+    for (i64 word_index = 0; word_index < 2; ++word_index)
+    {
+        u64 word = hash_table_load_word(group, word_index);
+        result |= hash_table_pack_high_bits(word & HASH_TABLE_HIGH_BITS) << (word_index * 8);
+    }
+    return result;
+#endif
+}
+
+// Returns the index of the first matching bucket in the group and removes it from the mask.
+static inline i64 hash_table_group_mask_pop(u64* mask)
+{
+    u32 bit = count_trailing_zeros(*mask);
+    *mask &= *mask - 1;
+    return bit >> HASH_TABLE_GROUP_MASK_SHIFT;
+}
 
-    HashTable<T> result;
-    result.buckets = arena_push<HashTableBucket>(arena, bucket_count);
-    result.bucket_count = bucket_count;
+static inline u8 hash_table_control_from_hash(u32 hash)
+{
+    return hash & 0x7F;
+}
 
-    for (u64 idx = 0; idx < bucket_count; ++idx)
+template<typename T, typename K>
+static inline i64 hash_table_wrap_around(HashTable<T, K>* hash_table, u64 value)
+{
+    // @NOTE(dubgron): The number of buckets in the hash table is a power
+    // of 2, so we can easily wrap the value between 0 and bucket_count by
+    // chopping off the top bits.
+    return value & (hash_table->bucket_count - 1);
+}
+
+template<typename T, typename K>
+static inline i64 hash_table_first_group(HashTable<T, K>* hash_table, u32 hash)
+{
+    // @NOTE(dubgron): The lowest 7 bits of the hash are already stored in the control
+    // bytes, so use the remaining ones to pick the group.
+    return hash_table_wrap_around(hash_table, hash >> 7);
+}
+
+template<typename T, typename K>
+static inline void hash_table_set_control(HashTable<T, K>* hash_table, i64 index, u8 control)
+{
+    hash_table->control[index] = control;
+
+    if (index < HASH_TABLE_GROUP_SIZE)
     {
-        result.buckets[idx].hash = NEVER_OCCUPIED_HASH;
+        hash_table->control[hash_table->bucket_count + index] = control;
     }
+}
 
-    return result;
+template<typename T, typename K>
+bool hash_table_is_created(HashTable<T, K>* hash_table)
+{
+    return hash_table->buckets && hash_table->bucket_count > 0;
 }
 
-template<typename T>
-void hash_table_destroy(HashTable<T>* hash_table)
+template<typename T, typename K>
+bool hash_table_is_bucket_valid(HashTable<T, K>* hash_table, i64 index)
 {
-    for (u64 idx = 0; idx < hash_table->bucket_count; ++idx)
+    return hash_table->control[index] < CONTROL_EMPTY;
+}
+
+template<typename T, typename K>
+static void hash_table_reset_buckets(HashTable<T, K>* hash_table)
+{
+    using HashTableBucket = typename HashTable<T, K>::Bucket;
+
+    memset(hash_table->control, CONTROL_EMPTY, hash_table->bucket_count + HASH_TABLE_GROUP_SIZE);
+
+    for (i64 idx = 0; idx < hash_table->bucket_count; ++idx)
     {
-        using HashTableBucket = typename HashTable<T>::Bucket;
         hash_table->buckets[idx] = HashTableBucket{};
     }
 
@@ -84,125 +221,232 @@ void hash_table_destroy(HashTable<T>* hash_table)
     hash_table->occupied_buckets = 0;
 }
 
-template<typename T>
-void hash_table_expand(MemoryArena* arena, HashTable<T>* hash_table)
+template<typename T, typename K>
+static void hash_table_allocate_buckets(HashTable<T, K>* hash_table, i64 bucket_count)
 {
-    u64 required_count;
-    if (hash_table->valid_buckets * 2 * 100 <= MAX_LOAD_FACTOR_PERCENT * hash_table->bucket_count)
-    {
-        required_count = hash_table->bucket_count;
-    }
-    else
-    {
-        required_count = hash_table->bucket_count * 2;
-    }
+    using HashTableBucket = typename HashTable<T, K>::Bucket;
 
-    HashTable<T> result = hash_table_create<T>(arena, required_count);
+    // @NOTE(dubgron): The buckets and the control bytes are pushed together, so they can
+    // be popped together when the hash table grows.
+    u64 buckets_size = bucket_count * sizeof(HashTableBucket);
+    u64 control_size = bucket_count + HASH_TABLE_GROUP_SIZE;
+    u8* memory = (u8*)arena_push_uninitialized(hash_table->arena, buckets_size + control_size);
 
-    for (u64 idx = 0; idx < hash_table->bucket_count; ++idx)
-    {
-        using HashTableBucket = typename HashTable<T>::Bucket;
-        HashTableBucket* bucket = &hash_table->buckets[idx];
+    hash_table->buckets = (HashTableBucket*)memory;
+    hash_table->control = memory + buckets_size;
+    hash_table->bucket_count = bucket_count;
+}
 
-        if (bucket->hash >= FIRST_VALID_HASH)
-        {
-            hash_table_insert(&result, bucket->key, bucket->value);
-        }
-    }
+template<typename T, typename K = String>
+HashTable<T, K> hash_table_create(MemoryArena* arena, i64 bucket_count)
+{
+    // @NOTE(dubgron): The number of buckets in the hash table should be a power of 2.
+    // For explanation, see 'hash_table_wrap_around' function.
+    bucket_count = next_power_of_two(max(bucket_count, MIN_BUCKET_COUNT));
+
+    HashTable<T, K> result;
+    result.arena = arena;
 
-    *hash_table = result;
+    hash_table_allocate_buckets(&result, bucket_count);
+    hash_table_reset_buckets(&result);
+
+    return result;
 }
 
-template<typename T>
-static inline i64 hash_table_wrap_around(HashTable<T>* hash_table, u64 value)
+template<typename T, typename K>
+void hash_table_destroy(HashTable<T, K>* hash_table)
 {
-    // @NOTE(dubgron): The number of buckets in the hash table is a power
-    // of 2, so we can easily wrap the value between 0 and bucket_count by
-    // chopping off the top bits.
-    return value & (hash_table->bucket_count - 1);
+    hash_table_reset_buckets(hash_table);
 }
 
-template<typename T>
-T* hash_table_insert(HashTable<T>* hash_table, String key, T value)
+template<typename T, typename K>
+static T* hash_table_insert_without_rehash(HashTable<T, K>* hash_table, u32 hash, K key, T value)
 {
-    // @NOTE(dubgron): Without dividing, we want to test:
-    //      occupied_buckets / bucket_count >= max_load_factor_percent / 100
-    // Therefore, we say:
-    //      occupied_buckets * 100 >= max_load_factor_percent * bucket_count
-    if (hash_table->occupied_buckets * 100 >= MAX_LOAD_FACTOR_PERCENT * hash_table->bucket_count)
+    i64 group_index = hash_table_first_group(hash_table, hash);
+    i64 probe_increment = HASH_TABLE_GROUP_SIZE;
+
+    // Probe forward, until you find a group with an empty or a removed bucket.
+    u64 free_buckets = hash_table_group_match_empty_or_removed(&hash_table->control[group_index]);
+    while (free_buckets == 0)
     {
-        APORIA_LOG(Warning, "The hash table is full! Failed to insert at key '%'!", key);
-        return nullptr;
-    }
+        group_index = hash_table_wrap_around(hash_table, group_index + probe_increment);
+        probe_increment += HASH_TABLE_GROUP_SIZE;
 
-    u32 hash = get_hash(key);
-    i64 index = hash_table_wrap_around(hash_table, hash);
+        free_buckets = hash_table_group_match_empty_or_removed(&hash_table->control[group_index]);
+    }
 
-    u32 probe_increment = 1;
+    i64 index = hash_table_wrap_around(hash_table, group_index + hash_table_group_mask_pop(&free_buckets));
 
-    // Probe forward, until you find an empty bucket.
-    while (hash_table->buckets[index].hash != NEVER_OCCUPIED_HASH)
+    // @NOTE(dubgron): Reusing a removed bucket doesn't increase the number of occupied
+    // buckets, so the churn of inserts and removes doesn't fill up the table.
+    if (hash_table->control[index] == CONTROL_EMPTY)
     {
-        index = hash_table_wrap_around(hash_table, index + probe_increment);
-        probe_increment += 1;
+        hash_table->occupied_buckets += 1;
     }
 
+    hash_table_set_control(hash_table, index, hash_table_control_from_hash(hash));
+
     hash_table->buckets[index].hash = hash;
     hash_table->buckets[index].key = key;
     hash_table->buckets[index].value = value;
 
     hash_table->valid_buckets += 1;
-    hash_table->occupied_buckets += 1;
 
     return &hash_table->buckets[index].value;
 }
 
-template<typename T>
-T hash_table_remove(HashTable<T>* hash_table, String key)
+template<typename T, typename K>
+void hash_table_rehash(HashTable<T, K>* hash_table)
 {
-    u32 hash = get_hash(key);
-    i64 index = hash_table_wrap_around(hash_table, hash);
+    using HashTableBucket = typename HashTable<T, K>::Bucket;
+
+    // @NOTE(dubgron): If most of the occupied buckets are removed, it's enough to get rid
+    // of them. Otherwise, the hash table doubles its size, which keeps the number of
+    // buckets a power of 2.
+    i64 new_bucket_count = hash_table->bucket_count;
+    if (hash_table->valid_buckets * 2 * 100 > MAX_LOAD_FACTOR_PERCENT * hash_table->bucket_count)
+    {
+        new_bucket_count = hash_table->bucket_count * 2;
+    }
+
+    ScratchArena temp = scratch_begin(hash_table->arena);
+    defer { scratch_end(temp); };
+
+    HashTableBucket* valid_buckets = arena_push_uninitialized<HashTableBucket>(temp.arena, hash_table->valid_buckets);
+    i64 valid_bucket_count = 0;
 
-    u32 probe_increment = 1;
+    for (i64 idx = 0; idx < hash_table->bucket_count; ++idx)
+    {
+        if (hash_table_is_bucket_valid(hash_table, idx))
+        {
+            valid_buckets[valid_bucket_count] = hash_table->buckets[idx];
+            valid_bucket_count += 1;
+        }
+    }
 
-    // Probe forward, until you find the correct bucket (or an empty one).
-    while (hash_table->buckets[index].hash != hash)
+    APORIA_ASSERT(valid_bucket_count == hash_table->valid_buckets);
+
+    if (new_bucket_count != hash_table->bucket_count)
     {
-        if (hash_table->buckets[index].hash == NEVER_OCCUPIED_HASH)
+        u64 buckets_begin = PTR_TO_INT(hash_table->buckets);
+        u64 control_end = PTR_TO_INT(hash_table->control + hash_table->bucket_count + HASH_TABLE_GROUP_SIZE);
+        u64 arena_end = PTR_TO_INT(hash_table->arena->memory) + hash_table->arena->pos;
+
+        // @NOTE(dubgron): If the buckets are the last thing on the arena, we can pop them
+        // and reuse their memory. Otherwise, the old buckets are left behind on the arena.
+        if (control_end == arena_end)
         {
-            APORIA_LOG(Warning, "Tried to remove a non-existant key '%' from the hash table!", key);
-            return T{};
+            arena_pop(hash_table->arena, arena_end - buckets_begin);
         }
 
-        index = hash_table_wrap_around(hash_table, index + probe_increment);
-        probe_increment += 1;
+        hash_table_allocate_buckets(hash_table, new_bucket_count);
     }
 
-    hash_table->buckets[index].hash = REMOVED_HASH;
-    hash_table->valid_buckets -= 1;
+    hash_table_reset_buckets(hash_table);
 
-    return hash_table->buckets[index].value;
+    for (i64 idx = 0; idx < valid_bucket_count; ++idx)
+    {
+        HashTableBucket* bucket = &valid_buckets[idx];
+        hash_table_insert_without_rehash(hash_table, bucket->hash, bucket->key, bucket->value);
+    }
+}
+
+// @NOTE(dubgron): The hash must be equal to 'get_hash(key)'. It lets the callers hash
+// the keys at compile time (see 'hash_literal') or reuse the hashes they already have.
+template<typename T, typename K>
+T* hash_table_insert_with_hash(HashTable<T, K>* hash_table, typename HashTable<T, K>::Key key, u32 hash, T value)
+{
+    APORIA_ASSERT_WITH_MESSAGE(hash_table_is_created(hash_table), "The hash table hasn't been created!");
+
+    // @NOTE(dubgron): Without dividing, we want to test:
+    //      (occupied_buckets + 1) / bucket_count > max_load_factor_percent / 100
+    // Therefore, we say:
+    //      (occupied_buckets + 1) * 100 > max_load_factor_percent * bucket_count
+    if ((hash_table->occupied_buckets + 1) * 100 > MAX_LOAD_FACTOR_PERCENT * hash_table->bucket_count)
+    {
+        hash_table_rehash(hash_table);
+    }
+
+    return hash_table_insert_without_rehash(hash_table, hash, key, value);
+}
+
+template<typename T, typename K>
+T* hash_table_insert(HashTable<T, K>* hash_table, typename HashTable<T, K>::Key key, T value)
+{
+    return hash_table_insert_with_hash(hash_table, key, get_hash(key), value);
 }
 
-template<typename T>
-T* hash_table_find(HashTable<T>* hash_table, String key)
+template<typename T, typename K>
+static i64 hash_table_find_index(HashTable<T, K>* hash_table, typename HashTable<T, K>::Key key, u32 hash)
 {
-    u32 hash = get_hash(key);
-    i64 index = hash_table_wrap_around(hash_table, hash);
+    if (!hash_table_is_created(hash_table))
+    {
+        return INDEX_INVALID;
+    }
 
-    u32 probe_increment = 1;
+    u8 control = hash_table_control_from_hash(hash);
 
-    // Probe forward, until you find the correct bucket (or an empty one).
-    while (hash_table->buckets[index].hash != hash || hash_table->buckets[index].key != key)
+    i64 group_index = hash_table_first_group(hash_table, hash);
+    i64 probe_increment = HASH_TABLE_GROUP_SIZE;
+
+    // Probe forward, until you find the correct bucket (or a group with an empty one).
+    while (true)
     {
-        if (hash_table->buckets[index].hash == NEVER_OCCUPIED_HASH)
+        const u8* group = &hash_table->control[group_index];
+
+        u64 matches = hash_table_group_match(group, control);
+        while (matches != 0)
+        {
+            i64 index = hash_table_wrap_around(hash_table, group_index + hash_table_group_mask_pop(&matches));
+
+            typename HashTable<T, K>::Bucket* bucket = &hash_table->buckets[index];
+            if (bucket->hash == hash && bucket->key == key)
+            {
+                return index;
+            }
+        }
+
+        if (hash_table_group_match_empty(group) != 0)
         {
-            return nullptr;
+            return INDEX_INVALID;
         }
 
-        index = hash_table_wrap_around(hash_table, index + probe_increment);
-        probe_increment += 1;
+        group_index = hash_table_wrap_around(hash_table, group_index + probe_increment);
+        probe_increment += HASH_TABLE_GROUP_SIZE;
+    }
+}
+
+template<typename T, typename K>
+T hash_table_remove(HashTable<T, K>* hash_table, typename HashTable<T, K>::Key key)
+{
+    i64 index = hash_table_find_index(hash_table, key, get_hash(key));
+    if (index == INDEX_INVALID)
+    {
+        APORIA_LOG(Warning, "Tried to remove a non-existant key '%' from the hash table!", key);
+        return T{};
+    }
+
+    hash_table_set_control(hash_table, index, CONTROL_REMOVED);
+    hash_table->valid_buckets -= 1;
+
+    return hash_table->buckets[index].value;
+}
+
+// @NOTE(dubgron): The hash must be equal to 'get_hash(key)'.
+template<typename T, typename K>
+T* hash_table_find_with_hash(HashTable<T, K>* hash_table, typename HashTable<T, K>::Key key, u32 hash)
+{
+    i64 index = hash_table_find_index(hash_table, key, hash);
+    if (index == INDEX_INVALID)
+    {
+        return nullptr;
     }
 
     return &hash_table->buckets[index].value;
 }
+
+template<typename T, typename K>
+T* hash_table_find(HashTable<T, K>* hash_table, typename HashTable<T, K>::Key key)
+{
+    return hash_table_find_with_hash(hash_table, key, get_hash(key));
+}
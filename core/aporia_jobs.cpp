@@ -0,0 +1,363 @@
+#include "aporia_jobs.hpp"
+
+#include "aporia_debug.hpp"
+#include "aporia_memory.hpp"
+#include "platform/aporia_os.hpp"
+
+static constexpr i32 MAX_JOB_THREADS = 64;
+
+// @NOTE(dubgron): Both have to be powers of two. The job slots of a thread are reused in
+// a ring, so a thread can have at most MAX_JOBS_PER_THREAD jobs in flight. If the ring wraps
+// around onto a job, which hasn't finished yet, the new job runs inline instead.
+static constexpr i64 MAX_JOBS_PER_THREAD = 4096;
+static constexpr i64 JOB_DEQUE_CAPACITY = MAX_JOBS_PER_THREAD;
+
+// @NOTE(dubgron): How many times an idle worker tries to steal, before it goes to sleep.
+static constexpr i32 JOB_STEAL_ATTEMPTS_BEFORE_SLEEP = 64;
+
+struct Job
+{
+    JobProc proc = nullptr;
+    void* data = nullptr;
+    JobCounter* counter = nullptr;
+
+    // @NOTE(dubgron): Set when the job is pushed, and cleared after it's done, so the slot
+    // can be reused.
+    std::atomic<bool> is_pending{ false };
+};
+
+// @NOTE(dubgron): The Chase-Lev work-stealing deque, as described in "Correct and Efficient
+// Work-Stealing for Weak Memory Models" by Lê et al. The owner pushes and pops at the bottom,
+// the thieves steal from the top. The capacity is fixed, so it never has to be resized.
+struct JobDeque
+{
+    alignas(64) std::atomic<i64> top{ 0 };
+    alignas(64) std::atomic<i64> bottom{ 0 };
+    alignas(64) std::atomic<Job*> buffer[JOB_DEQUE_CAPACITY];
+};
+
+struct JobThread
+{
+    JobDeque deque;
+
+    Job jobs[MAX_JOBS_PER_THREAD];
+    i64 next_job = 0;
+
+    Thread thread;
+    u32 random_state = 0;
+};
+
+static JobThread* job_threads = nullptr;
+static i32 job_thread_count = 0;
+
+// @NOTE(dubgron): The number of threads, which job_threads has been allocated for. It's larger
+// than job_thread_count, if some of the threads have failed to start.
+static i32 job_threads_allocated_count = 0;
+
+static thread_local i32 job_thread_index = INDEX_INVALID;
+
+static std::atomic<bool> jobs_running{ false };
+
+// @NOTE(dubgron): The idle workers sleep on the condition variable. The queued_jobs counts
+// the jobs which were pushed, but not yet taken by any thread. The spawning thread takes the
+// mutex only if there are sleeping workers, so spawning is lock-free most of the time.
+static std::atomic<i32> queued_jobs{ 0 };
+static std::atomic<i32> sleeping_workers{ 0 };
+static Mutex jobs_mutex;
+static ConditionVariable jobs_condition_variable;
+
+static void job_deque_push(JobDeque* deque, Job* job)
+{
+    i64 bottom = deque->bottom.load(std::memory_order_relaxed);
+    i64 top = deque->top.load(std::memory_order_acquire);
+
+    APORIA_ASSERT_WITH_MESSAGE(bottom - top < JOB_DEQUE_CAPACITY,
+        "The job deque is full! Can't push more than % jobs!", JOB_DEQUE_CAPACITY);
+
+    deque->buffer[bottom & (JOB_DEQUE_CAPACITY - 1)].store(job, std::memory_order_release);
+    deque->bottom.store(bottom + 1, std::memory_order_release);
+}
+
+static Job* job_deque_pop(JobDeque* deque)
+{
+    i64 bottom = deque->bottom.load(std::memory_order_relaxed) - 1;
+    deque->bottom.store(bottom, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    i64 top = deque->top.load(std::memory_order_relaxed);
+
+    if (top > bottom)
+    {
+        // The deque was empty.
+        deque->bottom.store(bottom + 1, std::memory_order_relaxed);
+        return nullptr;
+    }
+
+    Job* job = deque->buffer[bottom & (JOB_DEQUE_CAPACITY - 1)].load(std::memory_order_relaxed);
+    if (top == bottom)
+    {
+        // This is the last job, so we race against the thieves for it.
+        if (!deque->top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+        {
+            job = nullptr;
+        }
+        deque->bottom.store(bottom + 1, std::memory_order_relaxed);
+    }
+
+    return job;
+}
+
+static Job* job_deque_steal(JobDeque* deque)
+{
+    i64 top = deque->top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    i64 bottom = deque->bottom.load(std::memory_order_acquire);
+
+    if (top >= bottom)
+    {
+        return nullptr;
+    }
+
+    Job* job = deque->buffer[top & (JOB_DEQUE_CAPACITY - 1)].load(std::memory_order_acquire);
+    if (!deque->top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+    {
+        // Another thread took this job first.
+        return nullptr;
+    }
+
+    return job;
+}
+
+static Job* job_find(i32 thread_index)
+{
+    JobThread* job_thread = &job_threads[thread_index];
+
+    if (Job* job = job_deque_pop(&job_thread->deque))
+    {
+        return job;
+    }
+
+    if (job_thread_count == 1)
+    {
+        return nullptr;
+    }
+
+    // @NOTE(dubgron): Start from a random victim, so the thieves don't all pile up on
+    // the same deque. This is xorshift32.
+    u32 random = job_thread->random_state;
+    random ^= random << 13;
+    random ^= random >> 17;
+    random ^= random << 5;
+    job_thread->random_state = random;
+
+    i32 first_victim = random % job_thread_count;
+    for (i32 offset = 0; offset < job_thread_count; ++offset)
+    {
+        i32 victim = (first_victim + offset) % job_thread_count;
+        if (victim == thread_index)
+            continue;
+
+        if (Job* job = job_deque_steal(&job_threads[victim].deque))
+        {
+            return job;
+        }
+    }
+
+    return nullptr;
+}
+
+static void job_execute(Job* job)
+{
+    queued_jobs.fetch_sub(1, std::memory_order_relaxed);
+
+    job->proc(job->data);
+
+    if (job->counter)
+    {
+        job->counter->value.fetch_sub(1, std::memory_order_release);
+    }
+
+    // @NOTE(dubgron): The owner may reuse the slot right after this, so it's the last access.
+    job->is_pending.store(false, std::memory_order_release);
+}
+
+static void job_worker_proc(void* data)
+{
+    job_thread_index = (i32)(i64)data;
+
+    temporary_memory_thread_init();
+    defer { temporary_memory_thread_deinit(); };
+
+    i32 failed_attempts = 0;
+    while (jobs_running.load(std::memory_order_acquire))
+    {
+        if (Job* job = job_find(job_thread_index))
+        {
+            job_execute(job);
+            failed_attempts = 0;
+            continue;
+        }
+
+        failed_attempts += 1;
+        if (failed_attempts < JOB_STEAL_ATTEMPTS_BEFORE_SLEEP)
+        {
+            thread_yield();
+            continue;
+        }
+
+        mutex_lock(&jobs_mutex);
+        sleeping_workers.fetch_add(1, std::memory_order_seq_cst);
+        while (queued_jobs.load(std::memory_order_seq_cst) == 0 && jobs_running.load(std::memory_order_acquire))
+        {
+            condition_variable_wait(&jobs_condition_variable, &jobs_mutex);
+        }
+        sleeping_workers.fetch_sub(1, std::memory_order_relaxed);
+        mutex_unlock(&jobs_mutex);
+
+        failed_attempts = 0;
+    }
+}
+
+void jobs_init(i32 worker_count /* = -1 */)
+{
+#if defined(APORIA_EMSCRIPTEN)
+    // @NOTE(dubgron): We don't build with the pthreads support on the web, so all
+    // the jobs run on the main thread, when it waits for them.
+    worker_count = 0;
+#else
+    if (worker_count < 0)
+    {
+        worker_count = get_processor_count() - 1;
+    }
+#endif
+
+    job_thread_count = clamp(worker_count + 1, 1, MAX_JOB_THREADS);
+    job_threads_allocated_count = job_thread_count;
+
+    job_threads = (JobThread*)memory_reserve(job_thread_count * sizeof(JobThread));
+    memory_commit(job_threads, job_thread_count * sizeof(JobThread));
+
+    // @NOTE(dubgron): The threads hold atomics, so they have to be constructed in place,
+    // instead of relying on the committed memory being zeroed.
+    for (i32 idx = 0; idx < job_thread_count; ++idx)
+    {
+        JobThread* job_thread = new (&job_threads[idx]) JobThread;
+        job_thread->random_state = 0x9E3779B9u * (idx + 1);
+    }
+
+    jobs_mutex = mutex_create();
+    jobs_condition_variable = condition_variable_create();
+    jobs_running.store(true, std::memory_order_release);
+
+    // @NOTE(dubgron): The thread calling jobs_init becomes the thread with index 0.
+    job_thread_index = 0;
+
+    for (i32 idx = 1; idx < job_thread_count; ++idx)
+    {
+        if (!thread_create(&job_threads[idx].thread, job_worker_proc, (void*)(i64)idx))
+        {
+            APORIA_LOG(Error, "Failed to create the job thread %! Running with % threads instead.", idx, idx);
+            job_thread_count = idx;
+            break;
+        }
+    }
+
+    APORIA_LOG(Info, "Job system is running on % threads.", job_thread_count);
+}
+
+void jobs_deinit()
+{
+    mutex_lock(&jobs_mutex);
+    jobs_running.store(false, std::memory_order_release);
+    condition_variable_wake_all(&jobs_condition_variable);
+    mutex_unlock(&jobs_mutex);
+
+    for (i32 idx = 1; idx < job_thread_count; ++idx)
+    {
+        thread_join(&job_threads[idx].thread);
+    }
+
+    condition_variable_destroy(&jobs_condition_variable);
+    mutex_destroy(&jobs_mutex);
+
+    for (i32 idx = 0; idx < job_threads_allocated_count; ++idx)
+    {
+        job_threads[idx].~JobThread();
+    }
+
+    memory_release(job_threads, job_threads_allocated_count * sizeof(JobThread));
+    job_threads = nullptr;
+    job_threads_allocated_count = 0;
+    job_thread_count = 0;
+}
+
+i32 jobs_get_thread_count()
+{
+    return job_thread_count;
+}
+
+i32 jobs_get_thread_index()
+{
+    return job_thread_index;
+}
+
+void job_run(JobProc proc, void* data, JobCounter* counter /* = nullptr */)
+{
+    APORIA_ASSERT_WITH_MESSAGE(job_thread_index != INDEX_INVALID,
+        "Jobs can be spawned only from the main thread or from other jobs!");
+
+    JobThread* job_thread = &job_threads[job_thread_index];
+
+    Job* job = &job_thread->jobs[job_thread->next_job & (MAX_JOBS_PER_THREAD - 1)];
+    if (job->is_pending.load(std::memory_order_acquire))
+    {
+        // @NOTE(dubgron): The ring has wrapped around onto a job, which is still queued or
+        // running. Running the new job right away is always correct, it just isn't parallel.
+        proc(data);
+        return;
+    }
+
+    job->is_pending.store(true, std::memory_order_relaxed);
+    job_thread->next_job += 1;
+
+    job->proc = proc;
+    job->data = data;
+    job->counter = counter;
+
+    if (counter)
+    {
+        counter->value.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    queued_jobs.fetch_add(1, std::memory_order_seq_cst);
+    job_deque_push(&job_thread->deque, job);
+
+    if (sleeping_workers.load(std::memory_order_seq_cst) > 0)
+    {
+        mutex_lock(&jobs_mutex);
+        condition_variable_wake_one(&jobs_condition_variable);
+        mutex_unlock(&jobs_mutex);
+    }
+}
+
+void job_wait(JobCounter* counter)
+{
+    APORIA_ASSERT_WITH_MESSAGE(job_thread_index != INDEX_INVALID,
+        "Jobs can be waited on only from the main thread or from other jobs!");
+
+    while (!job_is_done(counter))
+    {
+        if (Job* job = job_find(job_thread_index))
+        {
+            job_execute(job);
+        }
+        else
+        {
+            thread_yield();
+        }
+    }
+}
+
+bool job_is_done(const JobCounter* counter)
+{
+    return counter->value.load(std::memory_order_acquire) == 0;
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "aporia_memory.hpp"
+#include "aporia_types.hpp"
+#include "aporia_utils.hpp"
+
+// @NOTE(dubgron): The job system runs the jobs on a fixed pool of worker threads, one per
+// core (the main thread counts as one of them). Every thread has its own Chase-Lev deque:
+// it pushes and pops the jobs at the bottom of it, while the idle threads steal them from
+// the top of the other deques. The jobs can be spawned only from the threads of the pool,
+// i.e. from the main thread or from other jobs.
+//
+// The dependencies are expressed with counters. Every job spawned with a counter bumps it,
+// and decrements it after it's done. Waiting on a counter doesn't block the thread, it keeps
+// running the other jobs until the counter reaches zero.
+using JobProc = void(*)(void* data);
+
+struct JobCounter
+{
+    std::atomic<i32> value{ 0 };
+};
+
+// @NOTE(dubgron): Pass a negative worker_count to use one thread per core.
+void jobs_init(i32 worker_count = -1);
+void jobs_deinit();
+
+i32 jobs_get_thread_count();
+i32 jobs_get_thread_index();
+
+void job_run(JobProc proc, void* data, JobCounter* counter = nullptr);
+void job_wait(JobCounter* counter);
+
+bool job_is_done(const JobCounter* counter);
+
+// @NOTE(dubgron): Splits [0, count) into batches of batch_size indices and calls
+// func(begin, end) on each of them, possibly on different threads. It returns when
+// all the batches are done, so func may safely capture the locals by reference.
+template<typename F>
+void parallel_for(i64 count, i64 batch_size, const F& func)
+{
+    if (count <= 0)
+    {
+        return;
+    }
+
+    batch_size = max<i64>(batch_size, 1);
+    i64 batch_count = (count + batch_size - 1) / batch_size;
+
+    if (batch_count == 1 || jobs_get_thread_count() == 1)
+    {
+        func((i64)0, count);
+        return;
+    }
+
+    struct ParallelForBatch
+    {
+        const F* func = nullptr;
+        i64 begin = 0;
+        i64 end = 0;
+    };
+
+    ScratchArena temp = scratch_begin();
+    defer { scratch_end(temp); };
+
+    ParallelForBatch* batches = arena_push_uninitialized<ParallelForBatch>(temp.arena, batch_count);
+
+    JobCounter counter;
+    for (i64 idx = 0; idx < batch_count; ++idx)
+    {
+        ParallelForBatch* batch = &batches[idx];
+        batch->func = &func;
+        batch->begin = idx * batch_size;
+        batch->end = min(batch->begin + batch_size, count);
+
+        job_run([](void* data)
+            {
+                ParallelForBatch* batch = (ParallelForBatch*)data;
+                (*batch->func)(batch->begin, batch->end);
+            },
+            batch, &counter);
+    }
+
+    job_wait(&counter);
+}
@@ -2,6 +2,7 @@
 
 #include "aporia_debug.hpp"
 #include "aporia_utils.hpp"
+#include "platform/aporia_os.hpp"
 
 static u64 next_aligned(u64 address, u64 align)
 {
@@ -10,47 +11,281 @@ static u64 next_aligned(u64 address, u64 align)
     return aligned_address;
 }
 
-MemoryArena arena_init(u64 size)
+static void arena_commit(MemoryArena* arena, u64 new_pos)
 {
+    if (new_pos <= arena->committed)
+    {
+        return;
+    }
+
+    u64 new_committed = min(next_aligned(new_pos, ARENA_COMMIT_GRANULARITY), arena->max);
+
+    void* commit_begin = INT_TO_PTR(PTR_TO_INT(arena->memory) + arena->committed);
+    u64 commit_size = new_committed - arena->committed;
+
+    bool success = memory_commit(commit_begin, commit_size);
+    APORIA_ASSERT_WITH_MESSAGE(success, "Failed to commit % B! Committed: % B, Max: % B", commit_size, arena->committed, arena->max);
+
+    arena->committed = new_committed;
+}
+
+static void arena_decommit(MemoryArena* arena)
+{
+    if (arena->committed - arena->pos <= arena->decommit_threshold)
+    {
+        return;
+    }
+
+    u64 new_committed = next_aligned(arena->pos, ARENA_COMMIT_GRANULARITY);
+
+    void* decommit_begin = INT_TO_PTR(PTR_TO_INT(arena->memory) + new_committed);
+    u64 decommit_size = arena->committed - new_committed;
+
+    memory_decommit(decommit_begin, decommit_size);
+
+    arena->committed = new_committed;
+}
+
+#if defined(APORIA_DEBUGTOOLS)
+
+struct ArenaCallSite
+{
+    SourceLocation location;
+    u64 push_count = 0;
+    u64 pushed_bytes = 0;
+};
+
+// @NOTE(dubgron): Must be a power of 2, the call sites are stored in an open addressing table.
+constexpr i64 MAX_ARENA_CALL_SITES = 256;
+
+struct ArenaTelemetry
+{
+    SourceLocation init_location;
+    bool in_use = false;
+
+    u64 reserved = 0;
+    u64 peak_pos = 0;
+    u64 peak_committed = 0;
+
+    u64 push_count = 0;
+    u64 pushed_bytes = 0;
+
+    ArenaCallSite call_sites[MAX_ARENA_CALL_SITES];
+    i64 call_site_count = 0;
+
+    // @NOTE(dubgron): The pushes from the call sites, which didn't fit into the table.
+    u64 overflow_push_count = 0;
+    u64 overflow_pushed_bytes = 0;
+};
+
+// @NOTE(dubgron): The telemetry outlives the arenas, so after an arena is deinitialized,
+// its data is still available. An arena initialized from the same place in code reuses
+// the telemetry of the previous one, e.g. all of the temporary arenas created by a
+// function called every frame end up in the same entry.
+constexpr i64 ARENA_TELEMETRY_BLOCK_SIZE = 64;
+
+// @NOTE(dubgron): Every dynamic array, world chunk and scratch arena is an arena on its
+// own, so we can't know up front how many of them there will be. The telemetry is kept
+// in a linked list of blocks, allocated straight from the OS, because allocating them
+// from an arena would need the telemetry of that arena.
+struct ArenaTelemetryBlock
+{
+    ArenaTelemetry telemetry[ARENA_TELEMETRY_BLOCK_SIZE];
+    i64 count = 0;
+
+    ArenaTelemetryBlock* next = nullptr;
+};
+
+static ArenaTelemetryBlock* first_telemetry_block = nullptr;
+static ArenaTelemetryBlock* last_telemetry_block = nullptr;
+
+static Mutex arena_telemetry_mutex;
+static bool arena_telemetry_mutex_created = false;
+
+static bool operator==(SourceLocation a, SourceLocation b)
+{
+    return a.line == b.line && (a.file == b.file || strcmp(a.file, b.file) == 0);
+}
+
+static ArenaTelemetry* arena_telemetry_acquire(SourceLocation init_location)
+{
+    // @NOTE(dubgron): The first arena is initialized at the very beginning of engine_main,
+    // before any other threads are spawned, so it's safe to create the mutex lazily.
+    if (!arena_telemetry_mutex_created)
+    {
+        arena_telemetry_mutex = mutex_create();
+        arena_telemetry_mutex_created = true;
+    }
+
+    mutex_lock(&arena_telemetry_mutex);
+    defer { mutex_unlock(&arena_telemetry_mutex); };
+
+    for (ArenaTelemetryBlock* block = first_telemetry_block; block; block = block->next)
+    {
+        for (i64 idx = 0; idx < block->count; ++idx)
+        {
+            ArenaTelemetry* telemetry = &block->telemetry[idx];
+            if (!telemetry->in_use && telemetry->init_location == init_location)
+            {
+                telemetry->in_use = true;
+                return telemetry;
+            }
+        }
+    }
+
+    if (!last_telemetry_block || last_telemetry_block->count >= ARENA_TELEMETRY_BLOCK_SIZE)
+    {
+        u64 block_size = sizeof(ArenaTelemetryBlock);
+
+        void* block_memory = memory_reserve(block_size);
+        bool success = block_memory && memory_commit(block_memory, block_size);
+        if (!success)
+        {
+            return nullptr;
+        }
+
+        ArenaTelemetryBlock* new_block = new (block_memory) ArenaTelemetryBlock;
+        if (last_telemetry_block)
+        {
+            last_telemetry_block->next = new_block;
+        }
+        else
+        {
+            first_telemetry_block = new_block;
+        }
+        last_telemetry_block = new_block;
+    }
+
+    ArenaTelemetry* telemetry = &last_telemetry_block->telemetry[last_telemetry_block->count];
+    telemetry->init_location = init_location;
+    telemetry->in_use = true;
+
+    last_telemetry_block->count += 1;
+
+    return telemetry;
+}
+
+static void arena_telemetry_release(ArenaTelemetry* telemetry)
+{
+    mutex_lock(&arena_telemetry_mutex);
+    telemetry->in_use = false;
+    mutex_unlock(&arena_telemetry_mutex);
+}
+
+static void arena_telemetry_track_push(MemoryArena* arena, u64 size, SourceLocation location)
+{
+    ArenaTelemetry* telemetry = arena->telemetry;
+    if (!telemetry)
+    {
+        return;
+    }
+
+    telemetry->reserved = arena->max;
+    telemetry->peak_pos = max(telemetry->peak_pos, arena->pos);
+    telemetry->peak_committed = max(telemetry->peak_committed, arena->committed);
+    telemetry->push_count += 1;
+    telemetry->pushed_bytes += size;
+
+    u64 hash = PTR_TO_INT(location.file) * 31 + location.line;
+    i64 probe = 0;
+    for (; probe < MAX_ARENA_CALL_SITES; ++probe)
+    {
+        ArenaCallSite* call_site = &telemetry->call_sites[(hash + probe) & (MAX_ARENA_CALL_SITES - 1)];
+        if (call_site->location.file == nullptr)
+        {
+            call_site->location = location;
+            telemetry->call_site_count += 1;
+        }
+        else if (call_site->location.file != location.file || call_site->location.line != location.line)
+        {
+            continue;
+        }
+
+        call_site->push_count += 1;
+        call_site->pushed_bytes += size;
+        break;
+    }
+
+    if (probe == MAX_ARENA_CALL_SITES)
+    {
+        telemetry->overflow_push_count += 1;
+        telemetry->overflow_pushed_bytes += size;
+    }
+}
+
+#endif
+
+MemoryArena arena_init(u64 size, u64 decommit_threshold /* = ARENA_DEFAULT_DECOMMIT_THRESHOLD */ SOURCE_LOCATION_PARAM_NO_DEFAULT)
+{
+    u64 reserved_size = next_aligned(size, ARENA_COMMIT_GRANULARITY);
+
     MemoryArena result;
-    result.memory = malloc(size);
-    result.max = size;
+    result.memory = memory_reserve(reserved_size);
+    result.max = reserved_size;
     result.pos = 0;
+    result.committed = 0;
+    result.decommit_threshold = decommit_threshold;
     result.align = 8;
+    APORIA_ASSERT_WITH_MESSAGE(result.memory, "Failed to reserve % B!", reserved_size);
     APORIA_ASSERT(PTR_TO_INT(result.memory) % result.align == 0);
 
+#if defined(APORIA_DEBUGTOOLS)
+    result.telemetry = arena_telemetry_acquire(location);
+    if (result.telemetry)
+    {
+        result.telemetry->reserved = reserved_size;
+    }
+#endif
+
     return result;
 }
 
 void arena_deinit(MemoryArena* arena)
 {
-    free(arena->memory);
+#if defined(APORIA_DEBUGTOOLS)
+    if (arena->telemetry)
+    {
+        arena_telemetry_release(arena->telemetry);
+        arena->telemetry = nullptr;
+    }
+#endif
+
+    memory_release(arena->memory, arena->max);
     arena->memory = nullptr;
     arena->max = 0;
     arena->pos = 0;
+    arena->committed = 0;
     arena->align = 8;
 }
 
 void arena_clear(MemoryArena* arena)
 {
     arena->pos = 0;
+    arena_decommit(arena);
 }
 
-void* arena_push_uninitialized(MemoryArena* arena, u64 size)
+void* arena_push_uninitialized(MemoryArena* arena, u64 size SOURCE_LOCATION_PARAM_NO_DEFAULT)
 {
     u64 space_left = arena->max - arena->pos;
     APORIA_ASSERT_WITH_MESSAGE(size >= 0 && size <= space_left,
         "Can't allocate % B! Pos: % B, Max: % B, Left: % B", size, arena->pos, arena->max, space_left);
 
     u64 result = PTR_TO_INT(arena->memory) + arena->pos;
-    arena->pos = next_aligned(arena->pos + size, arena->align);
+    u64 new_pos = next_aligned(arena->pos + size, arena->align);
+
+    arena_commit(arena, new_pos);
+    arena->pos = new_pos;
+
+#if defined(APORIA_DEBUGTOOLS)
+    arena_telemetry_track_push(arena, size, location);
+#endif
 
     return INT_TO_PTR(result);
 }
 
-void* arena_push(MemoryArena* arena, u64 size)
+void* arena_push(MemoryArena* arena, u64 size SOURCE_LOCATION_PARAM_NO_DEFAULT)
 {
-    void* result = arena_push_uninitialized(arena, size);
+    void* result = arena_push_uninitialized(arena, size SOURCE_LOCATION_ARG);
     memset(result, 0, size);
     return result;
 }
@@ -61,28 +296,55 @@ void arena_pop(MemoryArena* arena, u64 size)
         "Can't pop % B! Pos: % B", size, arena->pos);
 
     arena->pos = next_aligned(arena->pos - size, arena->align);
+    arena_decommit(arena);
 }
 
-static MemoryArena temporary[2];
+// @NOTE(dubgron): Every thread gets its own pair of scratch arenas, so scratch memory
+// can be used freely off the main thread. The arenas are created lazily, on the first
+// call to scratch_begin on a given thread, with the size set by temporary_memory_init.
+static u64 temporary_memory_size = MEGABYTES(10);
+static thread_local MemoryArena temporary[2];
 
 void temporary_memory_init(u64 size)
+{
+    temporary_memory_size = size;
+    temporary_memory_thread_init();
+}
+
+void temporary_memory_deinit()
+{
+    temporary_memory_thread_deinit();
+}
+
+void temporary_memory_thread_init()
 {
     for (u64 idx = 0; idx < ARRAY_COUNT(temporary); ++idx)
     {
-        temporary[idx] = arena_init(size);
+        if (temporary[idx].memory == nullptr)
+        {
+            temporary[idx] = arena_init(temporary_memory_size);
+        }
     }
 }
 
-void temporary_memory_deinit()
+void temporary_memory_thread_deinit()
 {
     for (u64 idx = 0; idx < ARRAY_COUNT(temporary); ++idx)
     {
-        arena_deinit(&temporary[idx]);
+        if (temporary[idx].memory != nullptr)
+        {
+            arena_deinit(&temporary[idx]);
+        }
     }
 }
 
 ScratchArena scratch_begin(MemoryArena* conflict /* = nullptr */)
 {
+    if (temporary[0].memory == nullptr)
+    {
+        temporary_memory_thread_init();
+    }
+
     ScratchArena result;
     for (u64 idx = 0; idx < ARRAY_COUNT(temporary); ++idx)
     {
@@ -122,4 +384,187 @@ void scratch_end(ScratchArena scratch)
 #endif
 
     scratch.arena->pos = scratch.pos;
+    arena_decommit(scratch.arena);
+}
+
+#if defined(APORIA_DEBUGTOOLS)
+
+u64 arena_get_push_count(const MemoryArena* arena)
+{
+    return arena->telemetry ? arena->telemetry->push_count : 0;
+}
+
+static String source_location_to_string(MemoryArena* arena, SourceLocation location)
+{
+    String filename = extract_filename(location.file);
+    return sprintf(arena, "%:%", filename, location.line);
+}
+
+static i64 sort_call_sites(ArenaTelemetry* telemetry, ArenaCallSite** out_call_sites)
+{
+    i64 count = 0;
+    for (i64 idx = 0; idx < MAX_ARENA_CALL_SITES; ++idx)
+    {
+        ArenaCallSite* call_site = &telemetry->call_sites[idx];
+        if (call_site->location.file)
+        {
+            out_call_sites[count] = call_site;
+            count += 1;
+        }
+    }
+
+    insertion_sort(out_call_sites, count,
+        [](ArenaCallSite* const* site0, ArenaCallSite* const* site1) -> i32
+        {
+            return (*site0)->pushed_bytes < (*site1)->pushed_bytes;
+        });
+
+    return count;
+}
+
+// @NOTE(dubgron): The lock keeps the list of the telemetry blocks in place, but the pushes
+// update the counters without it. The counters of the arenas pushed onto by other threads at
+// the same time may be off by the pushes in flight, so the report is exact only when called
+// from the main thread, while the job threads are idle (e.g. outside of world_run_system).
+void debug_memory()
+{
+    ImGui::Begin("Debug | Memory");
+
+    ScratchArena temp = scratch_begin();
+
+    mutex_lock(&arena_telemetry_mutex);
+
+    if (ImGui::BeginTable("Arenas", 7, ImGuiTableFlags_Resizable | ImGuiTableFlags_RowBg))
+    {
+        ImGui::TableSetupColumn("Initialized At");
+        ImGui::TableSetupColumn("In Use");
+        ImGui::TableSetupColumn("Reserved [B]");
+        ImGui::TableSetupColumn("Peak Committed [B]");
+        ImGui::TableSetupColumn("Peak Pos [B]");
+        ImGui::TableSetupColumn("Pushes");
+        ImGui::TableSetupColumn("Pushed [B]");
+        ImGui::TableHeadersRow();
+
+        for (ArenaTelemetryBlock* block = first_telemetry_block; block; block = block->next)
+        {
+            for (i64 idx = 0; idx < block->count; ++idx)
+            {
+                ArenaTelemetry* telemetry = &block->telemetry[idx];
+
+                ImGui::TableNextRow();
+
+                ImGui::TableNextColumn();
+                String name = source_location_to_string(temp.arena, telemetry->init_location);
+                bool open = ImGui::TreeNode(telemetry, "%s", *name);
+
+                ImGui::TableNextColumn();
+                ImGui::Text("%s", telemetry->in_use ? "Yes" : "No");
+
+                ImGui::TableNextColumn();
+                ImGui::Text("%llu", telemetry->reserved);
+
+                ImGui::TableNextColumn();
+                ImGui::Text("%llu", telemetry->peak_committed);
+
+                ImGui::TableNextColumn();
+                ImGui::Text("%llu", telemetry->peak_pos);
+
+                ImGui::TableNextColumn();
+                ImGui::Text("%llu", telemetry->push_count);
+
+                ImGui::TableNextColumn();
+                ImGui::Text("%llu", telemetry->pushed_bytes);
+
+                if (open)
+                {
+                    ArenaCallSite** call_sites = arena_push_uninitialized<ArenaCallSite*>(temp.arena, MAX_ARENA_CALL_SITES);
+                    i64 call_site_count = sort_call_sites(telemetry, call_sites);
+
+                    for (i64 site_idx = 0; site_idx < call_site_count; ++site_idx)
+                    {
+                        ArenaCallSite* call_site = call_sites[site_idx];
+
+                        ImGui::TableNextRow();
+
+                        ImGui::TableNextColumn();
+                        String location = source_location_to_string(temp.arena, call_site->location);
+                        ImGui::Text("%s", *location);
+
+                        ImGui::TableSetColumnIndex(5);
+                        ImGui::Text("%llu", call_site->push_count);
+
+                        ImGui::TableNextColumn();
+                        ImGui::Text("%llu", call_site->pushed_bytes);
+                    }
+
+                    if (telemetry->overflow_push_count > 0)
+                    {
+                        ImGui::TableNextRow();
+
+                        ImGui::TableNextColumn();
+                        ImGui::Text("Call sites beyond the first %lld", MAX_ARENA_CALL_SITES);
+
+                        ImGui::TableSetColumnIndex(5);
+                        ImGui::Text("%llu", telemetry->overflow_push_count);
+
+                        ImGui::TableNextColumn();
+                        ImGui::Text("%llu", telemetry->overflow_pushed_bytes);
+                    }
+
+                    ImGui::TreePop();
+                }
+            }
+        }
+
+        ImGui::EndTable();
+    }
+
+    mutex_unlock(&arena_telemetry_mutex);
+
+    scratch_end(temp);
+
+    ImGui::End();
 }
+
+// @NOTE(dubgron): Called on shutdown, once the main loop is over and the job threads are idle.
+void log_memory_telemetry()
+{
+    ScratchArena temp = scratch_begin();
+
+    mutex_lock(&arena_telemetry_mutex);
+
+    for (ArenaTelemetryBlock* block = first_telemetry_block; block; block = block->next)
+    {
+        for (i64 idx = 0; idx < block->count; ++idx)
+        {
+            ArenaTelemetry* telemetry = &block->telemetry[idx];
+
+            String name = source_location_to_string(temp.arena, telemetry->init_location);
+            APORIA_LOG(Info, "Arena '%': reserved % B, peak committed % B, peak pos % B, % pushes, % B pushed",
+                name, telemetry->reserved, telemetry->peak_committed, telemetry->peak_pos, telemetry->push_count, telemetry->pushed_bytes);
+
+            ArenaCallSite** call_sites = arena_push_uninitialized<ArenaCallSite*>(temp.arena, MAX_ARENA_CALL_SITES);
+            i64 call_site_count = sort_call_sites(telemetry, call_sites);
+
+            for (i64 site_idx = 0; site_idx < call_site_count; ++site_idx)
+            {
+                ArenaCallSite* call_site = call_sites[site_idx];
+
+                String location = source_location_to_string(temp.arena, call_site->location);
+                APORIA_LOG(Info, "    '%': % pushes, % B pushed", location, call_site->push_count, call_site->pushed_bytes);
+            }
+
+            if (telemetry->overflow_push_count > 0)
+            {
+                APORIA_LOG(Warning, "    Call sites beyond the first %: % pushes, % B pushed",
+                    MAX_ARENA_CALL_SITES, telemetry->overflow_push_count, telemetry->overflow_pushed_bytes);
+            }
+        }
+    }
+
+    mutex_unlock(&arena_telemetry_mutex);
+
+    scratch_end(temp);
+}
+
+#endif
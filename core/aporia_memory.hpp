@@ -11,29 +11,79 @@
 #define GIGABYTES(n)  (((u64)n) << 30)
 #define TERABYTES(n)  (((u64)n) << 40)
 
+// @NOTE(dubgron): Arenas reserve their whole address range up front, but commit
+// the physical memory lazily, in chunks of ARENA_COMMIT_GRANULARITY, as their
+// position grows. The reserved range never moves, so the pointers into an arena
+// stay valid for its whole lifetime.
+constexpr u64 ARENA_COMMIT_GRANULARITY = KILOBYTES(64);
+
+// @NOTE(dubgron): After being cleared or popped, an arena gives the memory above its
+// position back to the OS, but only if there's more than this much of it. Otherwise,
+// arenas cleared every frame would keep committing and decommitting the same pages.
+constexpr u64 ARENA_DEFAULT_DECOMMIT_THRESHOLD = MEGABYTES(4);
+
+#if defined(APORIA_DEBUGTOOLS)
+
+struct SourceLocation
+{
+    const char* file = nullptr;
+    i32 line = 0;
+};
+
+// @NOTE(dubgron): In debug builds, arenas keep track of where they were initialized and
+// pushed onto from. We can't use __FILE__ and __LINE__ for that, because they would point
+// to the declaration. The builtins used as default arguments are evaluated at the call
+// site instead, so they capture the location of the caller.
+constexpr SourceLocation source_location_current(const char* file = __builtin_FILE(), i32 line = __builtin_LINE())
+{
+    return SourceLocation{ file, line };
+}
+
+#define SOURCE_LOCATION_CURRENT         source_location_current()
+
+#define SOURCE_LOCATION_PARAM           , SourceLocation location = SOURCE_LOCATION_CURRENT
+#define SOURCE_LOCATION_PARAM_NO_DEFAULT , SourceLocation location
+#define SOURCE_LOCATION_ARG             , location
+
+struct ArenaTelemetry;
+
+#else
+
+#define SOURCE_LOCATION_PARAM
+#define SOURCE_LOCATION_PARAM_NO_DEFAULT
+#define SOURCE_LOCATION_ARG
+
+#endif
+
 struct MemoryArena
 {
     void* memory = nullptr;
     u64 max = 0;
     u64 pos = 0;
+    u64 committed = 0;
+    u64 decommit_threshold = ARENA_DEFAULT_DECOMMIT_THRESHOLD;
     u64 align = 8;
+
+#if defined(APORIA_DEBUGTOOLS)
+    ArenaTelemetry* telemetry = nullptr;
+#endif
 };
 
-MemoryArena arena_init(u64 size);
+MemoryArena arena_init(u64 size, u64 decommit_threshold = ARENA_DEFAULT_DECOMMIT_THRESHOLD SOURCE_LOCATION_PARAM);
 void arena_deinit(MemoryArena* arena);
 
 void arena_clear(MemoryArena* arena);
 
-void* arena_push_uninitialized(MemoryArena* arena, u64 size);
-void* arena_push(MemoryArena* arena, u64 size);
+void* arena_push_uninitialized(MemoryArena* arena, u64 size SOURCE_LOCATION_PARAM);
+void* arena_push(MemoryArena* arena, u64 size SOURCE_LOCATION_PARAM);
 
 void arena_pop(MemoryArena* arena, u64 size);
 
 template<typename T>
-T* arena_push_uninitialized(MemoryArena* arena, u64 count = 1)
+T* arena_push_uninitialized(MemoryArena* arena, u64 count = 1 SOURCE_LOCATION_PARAM)
 {
     u64 size = count * sizeof(T);
-    return (T*)arena_push_uninitialized(arena, size);
+    return (T*)arena_push_uninitialized(arena, size SOURCE_LOCATION_ARG);
 }
 
 //template<typename T>
@@ -47,9 +97,9 @@ T* arena_push_uninitialized(MemoryArena* arena, u64 count = 1)
 // zero-initializable (i.e. it's a primitive type or is a struct without
 // any non-zero default initializers for its members).
 template<typename T>
-T* arena_push(MemoryArena* arena, u64 count = 1)
+T* arena_push(MemoryArena* arena, u64 count = 1 SOURCE_LOCATION_PARAM)
 {
-    T* result = arena_push_uninitialized<T>(arena, count);
+    T* result = arena_push_uninitialized<T>(arena, count SOURCE_LOCATION_ARG);
     for (u64 idx = 0; idx < count; ++idx)
     {
         result[idx] = T{};
@@ -63,8 +113,23 @@ struct ScratchArena
     u64 pos = 0;
 };
 
+// @NOTE(dubgron): The init/deinit pair sets the size of the scratch arenas and manages
+// the ones owned by the main thread. Threads spawned by the engine should call the
+// thread_init/thread_deinit pair when they start and before they exit, respectively.
 void temporary_memory_init(u64 size);
 void temporary_memory_deinit();
 
+void temporary_memory_thread_init();
+void temporary_memory_thread_deinit();
+
 ScratchArena scratch_begin(MemoryArena* conflict = nullptr);
 void scratch_end(ScratchArena scratch);
+
+#if defined(APORIA_DEBUGTOOLS)
+// @NOTE(dubgron): The number of pushes onto the arena since it was initialized, including the
+// pushes onto the previous arenas initialized from the same place in code.
+u64 arena_get_push_count(const MemoryArena* arena);
+
+void debug_memory();
+void log_memory_telemetry();
+#endif
@@ -8,7 +8,9 @@
 #include <time.h>
 
 // C++ Standard Library
+#include <atomic>
 #include <chrono>
+#include <new>
 #include <random>
 
 // Third-Party Libraries
@@ -36,11 +38,23 @@
 #elif defined(APORIA_UNIX)
     #include <dlfcn.h>
     #include <pthread.h>
+    #include <sched.h>
+    #include <sys/mman.h>
     #include <sys/stat.h>
     #include <sys/time.h>
     #include <sys/types.h>
+    #include <unistd.h>
 #else
     #error OS not supported!
 #endif
 
+// SIMD
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define APORIA_SSE2 1
+    #include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+    #define APORIA_NEON 1
+    #include <arm_neon.h>
+#endif
+
 #include "platform/aporia_opengl.hpp"
@@ -0,0 +1,192 @@
+#pragma once
+
+#include "aporia_debug.hpp"
+#include "aporia_memory.hpp"
+#include "aporia_types.hpp"
+
+constexpr i32 POOL_DEFAULT_SLOTS_PER_CHUNK = 64;
+
+struct PoolHandle
+{
+    i32 index = INDEX_INVALID;
+    i32 generation = 0;
+};
+
+// @NOTE(dubgron): The pool grows by pushing new chunks of slots onto its arena. The
+// chunks are never moved nor freed, so the pointers to the elements stay valid until
+// they are freed. Freed slots are reused before the pool grows, and every reuse bumps
+// the generation of the slot, so stale handles can be detected.
+template<typename T>
+struct Pool
+{
+    struct Slot
+    {
+        T value;
+        i32 generation = 0;
+        i32 next_free = INDEX_INVALID;
+        bool occupied = false;
+    };
+
+    MemoryArena* arena = nullptr;
+
+    Slot** chunks = nullptr;
+    i32 chunk_count = 0;
+    i32 chunk_max_count = 0;
+
+    i32 slots_per_chunk = 0;
+    i32 chunk_shift = 0;
+
+    // @NOTE(dubgron): The number of slots ever handed out, i.e. every valid index is
+    // lower than the capacity. Use it together with pool_get_at_index to iterate.
+    i32 capacity = 0;
+    i32 count = 0;
+
+    i32 first_free = INDEX_INVALID;
+};
+
+inline i64 pool_handle_to_id(PoolHandle handle)
+{
+    return ((u64)(u32)handle.generation << 32) | (u32)handle.index;
+}
+
+inline PoolHandle pool_handle_from_id(i64 id)
+{
+    PoolHandle result;
+    result.index = (i32)(u32)((u64)id & 0xffffffff);
+    result.generation = (i32)(u32)((u64)id >> 32);
+    return result;
+}
+
+template<typename T>
+Pool<T> pool_create(MemoryArena* arena, i32 slots_per_chunk = POOL_DEFAULT_SLOTS_PER_CHUNK)
+{
+    APORIA_ASSERT(slots_per_chunk > 0 && (slots_per_chunk & (slots_per_chunk - 1)) == 0);
+
+    Pool<T> result;
+    result.arena = arena;
+    result.slots_per_chunk = slots_per_chunk;
+
+    while ((1 << result.chunk_shift) < slots_per_chunk)
+    {
+        result.chunk_shift += 1;
+    }
+
+    return result;
+}
+
+template<typename T>
+typename Pool<T>::Slot* pool_get_slot(Pool<T>* pool, i32 index)
+{
+    i32 chunk_index = index >> pool->chunk_shift;
+    i32 slot_index = index & (pool->slots_per_chunk - 1);
+    return &pool->chunks[chunk_index][slot_index];
+}
+
+template<typename T>
+void pool_add_chunk(Pool<T>* pool)
+{
+    using PoolSlot = typename Pool<T>::Slot;
+
+    if (pool->chunk_count == pool->chunk_max_count)
+    {
+        // @NOTE(dubgron): Only the table of the chunk pointers is reallocated, the chunks
+        // themselves stay in place. The old table is left behind on the arena.
+        i32 new_chunk_max_count = pool->chunk_max_count > 0 ? pool->chunk_max_count * 2 : 8;
+        PoolSlot** new_chunks = arena_push_uninitialized<PoolSlot*>(pool->arena, new_chunk_max_count);
+
+        if (pool->chunk_count > 0)
+        {
+            memcpy(new_chunks, pool->chunks, pool->chunk_count * sizeof(PoolSlot*));
+        }
+
+        pool->chunks = new_chunks;
+        pool->chunk_max_count = new_chunk_max_count;
+    }
+
+    pool->chunks[pool->chunk_count] = arena_push<PoolSlot>(pool->arena, pool->slots_per_chunk);
+    pool->chunk_count += 1;
+}
+
+template<typename T>
+T* pool_alloc(Pool<T>* pool, PoolHandle* out_handle = nullptr)
+{
+    APORIA_ASSERT_WITH_MESSAGE(pool->arena, "The pool hasn't been created!");
+
+    i32 index = pool->first_free;
+    if (index != INDEX_INVALID)
+    {
+        pool->first_free = pool_get_slot(pool, index)->next_free;
+    }
+    else
+    {
+        if (pool->capacity == pool->chunk_count * pool->slots_per_chunk)
+        {
+            pool_add_chunk(pool);
+        }
+
+        index = pool->capacity;
+        pool->capacity += 1;
+    }
+
+    auto* slot = pool_get_slot(pool, index);
+    slot->value = T{};
+    slot->next_free = INDEX_INVALID;
+    slot->occupied = true;
+
+    pool->count += 1;
+
+    if (out_handle)
+    {
+        out_handle->index = index;
+        out_handle->generation = slot->generation;
+    }
+
+    return &slot->value;
+}
+
+template<typename T>
+T* pool_get(Pool<T>* pool, PoolHandle handle)
+{
+    if (handle.index < 0 || handle.index >= pool->capacity)
+    {
+        return nullptr;
+    }
+
+    auto* slot = pool_get_slot(pool, handle.index);
+    if (!slot->occupied || slot->generation != handle.generation)
+    {
+        return nullptr;
+    }
+
+    return &slot->value;
+}
+
+template<typename T>
+T* pool_get_at_index(Pool<T>* pool, i32 index)
+{
+    APORIA_ASSERT(index >= 0 && index < pool->capacity);
+
+    auto* slot = pool_get_slot(pool, index);
+    return slot->occupied ? &slot->value : nullptr;
+}
+
+template<typename T>
+bool pool_free(Pool<T>* pool, PoolHandle handle)
+{
+    if (!pool_get(pool, handle))
+    {
+        return false;
+    }
+
+    auto* slot = pool_get_slot(pool, handle.index);
+    slot->value = T{};
+    slot->generation += 1;
+    slot->occupied = false;
+
+    slot->next_free = pool->first_free;
+    pool->first_free = handle.index;
+
+    pool->count -= 1;
+
+    return true;
+}
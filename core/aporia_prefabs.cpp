@@ -0,0 +1,93 @@
+#include "aporia_prefabs.hpp"
+
+#include "aporia_debug.hpp"
+#include "aporia_game.hpp"
+#include "aporia_hash_table.hpp"
+#include "aporia_parser.hpp"
+#include "aporia_serialization.hpp"
+
+static constexpr i64 INITIAL_PREFAB_BUCKET_COUNT = 64;
+static HashTable<Prefab, Atom> all_prefabs;
+
+void prefabs_init(MemoryArena* arena)
+{
+    all_prefabs = hash_table_create<Prefab, Atom>(arena, INITIAL_PREFAB_BUCKET_COUNT);
+}
+
+// @TODO(dubgron): The arena should be parameterized in the future.
+void load_prefabs(String filepath)
+{
+    ScratchArena temp = scratch_begin();
+    defer { scratch_end(temp); };
+
+    ParseTreeNode* parsed_file = parse_from_file(temp.arena, filepath);
+    if (!parsed_file)
+    {
+        APORIA_LOG(Error, "Failed to load prefabs from '%'!", filepath);
+        return;
+    }
+
+    for (ParseTreeNode* node = parsed_file->child_first; node; node = node->next)
+    {
+        APORIA_ASSERT(node->type == ParseTreeNode_Category);
+        if (node->name == "prefabs")
+        {
+            for (ParseTreeNode* prefab_node = node->child_first; prefab_node; prefab_node = prefab_node->next)
+            {
+                APORIA_ASSERT(prefab_node->type == ParseTreeNode_Struct);
+
+                Prefab prefab;
+                prefab.name = atom_intern(prefab_node->name);
+
+                // @NOTE(dubgron): The prefabs live as long as the program, and so do the points
+                // of their colliders, which all the instances point to.
+                prefab.entity = entity_deserialize_from_text(&memory.persistent, prefab_node);
+                prefab.entity.id = EntityID{};
+                prefab.entity.prefab = prefab.name;
+
+                if (hash_table_find(&all_prefabs, prefab.name))
+                {
+                    APORIA_LOG(Warning, "There is more than one prefab named '%'! One of them will be overwritten!", prefab.name);
+                }
+
+                hash_table_insert(&all_prefabs, prefab.name, prefab);
+            }
+        }
+    }
+
+    APORIA_LOG(Info, "All prefabs from '%' loaded successfully", filepath);
+}
+
+Prefab* prefab_get(Atom name)
+{
+    if (atom_is_empty(name))
+    {
+        return nullptr;
+    }
+
+    return hash_table_find(&all_prefabs, name);
+}
+
+Entity prefab_get_entity(Atom name)
+{
+    if (Prefab* prefab = prefab_get(name))
+    {
+        return prefab->entity;
+    }
+
+    return Entity{};
+}
+
+EntityID prefab_instantiate(World* world, Atom name)
+{
+    Prefab* prefab = prefab_get(name);
+    APORIA_ASSERT_WITH_MESSAGE(prefab, "Failed to find the prefab named '%'!", name);
+
+    EntityID entity_id = entity_create(world);
+    entity_store(world, entity_id, prefab->entity);
+
+    // @NOTE(dubgron): There's no snapshot of the new entity yet.
+    entity_flags_set(&world->flags.data[entity_id.index], EntityFlag_SkipInterpolationNextFrame);
+
+    return entity_id;
+}
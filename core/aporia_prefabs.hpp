@@ -0,0 +1,53 @@
+#pragma once
+
+#include "aporia_atoms.hpp"
+#include "aporia_entity.hpp"
+#include "aporia_string.hpp"
+#include "aporia_world.hpp"
+
+// @NOTE(dubgron): A prefab is a template of an entity, shared by all of its instances, e.g.
+// the texture, the size, the shader, the animation and the collider of a bullet. The data of
+// the prefab lives only once, in particular the points of its polygon collider are shared by
+// all the instances. Each instance remembers its prefab (see Entity::prefab), so the
+// serializers store only the components which the instance overrides.
+//
+// The instances still get their own copy of the render and the collider in the columns of
+// the World. The systems, the culling and the draw loop stream these columns one entity after
+// another, and the instances override their fields freely (e.g. the animations change the
+// texture, the color gets tinted), so a lookup through the prefab would cost every loop an
+// indirection and a branch, only to save a few dozen bytes per entity. Only the polygon
+// points, the one part of unbounded size, are shared. So the prefabs shrink the saves and
+// the polygon colliders, but every entity takes 4 B more in memory, for the atom in the
+// prefabs column ('--benchmark world_layout' logs the bytes per entity).
+//
+// The prefabs are loaded from a file, which describes each prefab in the same way as the
+// text world format describes an entity, e.g.:
+//     [prefabs]
+//     bullet {
+//       texture "bullet_0"
+//       width 8
+//       height 8
+//       collider {
+//         type 2
+//         radius 4
+//       }
+//     }
+struct Prefab
+{
+    Atom name;
+    Entity entity;
+};
+
+void prefabs_init(MemoryArena* arena);
+
+void load_prefabs(String filepath);
+
+// @NOTE(dubgron): The prefabs are stored in a hash table, so the returned pointer is valid
+// only until the next call to load_prefabs.
+Prefab* prefab_get(Atom name);
+
+// @NOTE(dubgron): Returns the components, which an instance of the prefab starts with. If
+// there's no such prefab, returns the default entity.
+Entity prefab_get_entity(Atom name);
+
+EntityID prefab_instantiate(World* world, Atom name);
@@ -1,8 +1,10 @@
 #include "aporia_rendering.hpp"
 
+#include "aporia_atoms.hpp"
 #include "aporia_camera.hpp"
 #include "aporia_config.hpp"
 #include "aporia_debug.hpp"
+#include "aporia_dynamic_array.hpp"
 #include "aporia_game.hpp"
 #include "aporia_utils.hpp"
 #include "aporia_window.hpp"
@@ -12,12 +14,31 @@
 #include "editor/aporia_editor.hpp"
 #endif
 
+#if defined(APORIA_BENCHMARKS)
+#include "benchmarks/aporia_benchmarks.hpp"
+#endif
+
 constexpr f32 Z_ALWAYS_IN_FRONT = 1.f;
 constexpr f32 Z_ALWAYS_BEHIND = -1.f;
 
 constexpr u64 MAX_RENDER_QUEUE_SIZE = 100000;
 constexpr u64 MAX_OBJECTS_PER_DRAW_CALL = 10000;
 
+// @NOTE(dubgron): The names of the uniforms are interned once, so setting them doesn't
+// need to hash the names nor build null-terminated copies of them.
+static Atom u_atlas;
+static Atom u_vp_matrix;
+static Atom u_camera_zoom;
+static Atom u_time_since_selected;
+static Atom u_masking;
+static Atom u_viewport_size;
+static Atom u_render_surface_size;
+static Atom u_num_lights;
+static Atom u_raycasting;
+static Atom u_grid_size;
+static Atom u_game_framebuffer;
+static Atom u_ui_framebuffer;
+
 // @NOTE(dubgron); It maps texture units to texture ids.
 static u32 textures_used_in_draw_call[OPENGL_MAX_TEXTURE_UNITS] = { 0 };
 static u32 first_unused_texture_unit = 0;
@@ -79,6 +100,44 @@ struct Vertex
 #endif
 };
 
+enum SpriteShape : u8
+{
+    SpriteShape_Texture,
+    SpriteShape_Rectangle,
+    SpriteShape_Circle,
+};
+
+// @NOTE(dubgron): A quad drawn with instancing, so it takes a single instance instead of four
+// vertices. The vertex shader (see sprite.glsl) expands it into the corners.
+struct SpriteInstance
+{
+    v2 center{ 0.f };
+    f32 z = 0.f;
+
+    // @NOTE(dubgron): Two half floats, which are negative if the sprite is flipped.
+    u32 half_size = 0;
+
+    // @NOTE(dubgron): The fraction of the full counterclockwise turn, as unorm16.
+    u16 rotation = 0;
+
+    u8 tex_unit = 0;
+    SpriteShape shape = SpriteShape_Texture;
+
+    // @NOTE(dubgron): The corners u and v of the subtexture, as two pairs of unorm16. The
+    // circles store their normalized inner radius in the first value instead.
+    u32 tex_rect[2] = { 0 };
+
+    Color color = Color::White;
+
+#if defined(APORIA_EDITOR)
+    i32 editor_index = -1;
+#endif
+};
+
+#if !defined(APORIA_EDITOR)
+static_assert(sizeof(SpriteInstance) == 32);
+#endif
+
 struct IndexBuffer
 {
     u32 id = 0;
@@ -122,35 +181,129 @@ static void indexbuffer_unbind()
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 }
 
+#if !defined(APORIA_EMSCRIPTEN)
+// @NOTE(dubgron): The streaming buffers are mapped once and split into a section per frame
+// in flight. The draw data of the current frame is written straight into its section, while
+// the GPU may still read the sections of the previous frames. Before a section is reused, we
+// wait for the fence placed after the last frame which drew from it.
+constexpr i32 STREAMING_FRAMES_IN_FLIGHT = 3;
+constexpr u64 STREAMING_OBJECTS_PER_FRAME = MAX_OBJECTS_PER_DRAW_CALL * 8;
+
+constexpr GLbitfield STREAMING_BUFFER_FLAGS = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+static GLsync streaming_fences[STREAMING_FRAMES_IN_FLIGHT] = { 0 };
+static i32 streaming_frame_index = 0;
+
+static void streaming_wait_for_fence(GLsync* fence)
+{
+    if (*fence == nullptr)
+    {
+        return;
+    }
+
+    while (true)
+    {
+        GLenum result = glClientWaitSync(*fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000 /* 1 second */);
+        if (result == GL_ALREADY_SIGNALED || result == GL_CONDITION_SATISFIED)
+        {
+            break;
+        }
+
+        if (result == GL_WAIT_FAILED)
+        {
+            APORIA_LOG(Error, "Failed to wait for the GPU to finish reading the streaming buffers!");
+            break;
+        }
+    }
+
+    glDeleteSync(*fence);
+    *fence = nullptr;
+}
+
+// @NOTE(dubgron): Used when the section of the current frame runs out of space. It should
+// happen only in the frames which draw way more than usual.
+static void streaming_wait_for_gpu()
+{
+    GLsync fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    streaming_wait_for_fence(&fence);
+}
+
+static void* streaming_buffer_create(u32* out_id, i64 frame_size)
+{
+    i64 size = frame_size * STREAMING_FRAMES_IN_FLIGHT;
+
+    glCreateBuffers(1, out_id);
+    glNamedBufferStorage(*out_id, size, nullptr, STREAMING_BUFFER_FLAGS);
+
+    void* result = glMapNamedBufferRange(*out_id, 0, size, STREAMING_BUFFER_FLAGS);
+    APORIA_ASSERT_WITH_MESSAGE(result, "Failed to map the streaming buffer!");
+
+    return result;
+}
+
+static void streaming_buffer_destroy(u32* id)
+{
+    glUnmapNamedBuffer(*id);
+    glDeleteBuffers(1, id);
+}
+#endif
+
 struct VertexBuffer
 {
     u32 id = 0;
     u32 max_count = 0;
     u32 vertex_per_object = 0;
 
+    // @NOTE(dubgron): On desktop, it points into the mapped buffer, at the first vertex of
+    // the current batch.
     Vertex* data = nullptr;
     u64 count = 0;
+
+#if !defined(APORIA_EMSCRIPTEN)
+    Vertex* mapped = nullptr;
+    u64 frame_capacity = 0;
+    u64 frame_offset = 0;
+#endif
 };
 
+#if !defined(APORIA_EMSCRIPTEN)
+static u64 vertexbuffer_get_base_vertex(VertexBuffer* vertex_buffer)
+{
+    return streaming_frame_index * vertex_buffer->frame_capacity + vertex_buffer->frame_offset;
+}
+
+static void vertexbuffer_set_frame_offset(VertexBuffer* vertex_buffer, u64 frame_offset)
+{
+    vertex_buffer->frame_offset = frame_offset;
+    vertex_buffer->data = vertex_buffer->mapped + vertexbuffer_get_base_vertex(vertex_buffer);
+}
+#endif
+
 static VertexBuffer vertexbuffer_create(MemoryArena* arena, u32 max_count, u32 vertex_per_object)
 {
     VertexBuffer result;
     result.max_count = max_count;
     result.vertex_per_object = vertex_per_object;
+    result.count = 0;
 
+#if defined(APORIA_EMSCRIPTEN)
     result.data = arena_push<Vertex>(arena, result.max_count);
-    result.count = 0;
 
     i64 size = result.max_count * sizeof(Vertex);
 
-#if defined(APORIA_EMSCRIPTEN)
     glGenBuffers(1, &result.id);
     glBindBuffer(GL_ARRAY_BUFFER, result.id);
     glBufferData(GL_ARRAY_BUFFER, size, nullptr, GL_DYNAMIC_DRAW);
 #else
-    glCreateBuffers(1, &result.id);
+    result.frame_capacity = STREAMING_OBJECTS_PER_FRAME * result.vertex_per_object;
+    APORIA_ASSERT(result.frame_capacity >= result.max_count);
+
+    i64 frame_size = result.frame_capacity * sizeof(Vertex);
+
+    result.mapped = (Vertex*)streaming_buffer_create(&result.id, frame_size);
+    vertexbuffer_set_frame_offset(&result, 0);
+
     glBindBuffer(GL_ARRAY_BUFFER, result.id);
-    glNamedBufferData(result.id, size, nullptr, GL_DYNAMIC_DRAW);
 #endif
 
     return result;
@@ -158,7 +311,11 @@ static VertexBuffer vertexbuffer_create(MemoryArena* arena, u32 max_count, u32 v
 
 static void vertexbuffer_destroy(VertexBuffer* vertex_buffer)
 {
+#if defined(APORIA_EMSCRIPTEN)
     glDeleteBuffers(1, &vertex_buffer->id);
+#else
+    streaming_buffer_destroy(&vertex_buffer->id);
+#endif
 }
 
 static void vertexbuffer_bind(VertexBuffer* vertex_buffer)
@@ -209,11 +366,27 @@ static void vertexbuffer_flush(VertexBuffer* vertex_buffer)
     vertexbuffer_bind(vertex_buffer);
     glBufferSubData(GL_ARRAY_BUFFER, 0, vertex_buffer->count * sizeof(Vertex), vertex_buffer->data);
     vertexbuffer_unbind();
-#else
-    glNamedBufferSubData(vertex_buffer->id, 0, vertex_buffer->count * sizeof(Vertex), vertex_buffer->data);
 #endif
 }
 
+static void vertexbuffer_next_batch(VertexBuffer* vertex_buffer)
+{
+#if !defined(APORIA_EMSCRIPTEN)
+    // @NOTE(dubgron): Always leave the room for a whole batch, so the vertices can be
+    // written without checking for the end of the section.
+    u64 frame_offset = vertex_buffer->frame_offset + vertex_buffer->count;
+    if (frame_offset + vertex_buffer->max_count > vertex_buffer->frame_capacity)
+    {
+        streaming_wait_for_gpu();
+        frame_offset = 0;
+    }
+
+    vertexbuffer_set_frame_offset(vertex_buffer, frame_offset);
+#endif
+
+    vertex_buffer->count = 0;
+}
+
 struct VertexArray
 {
     u32 id = 0;
@@ -265,13 +438,177 @@ static void vertexarray_render(VertexArray* vertex_array)
     indexbuffer_bind(&vertex_array->index_buffer);
 
     u32 index_count = vertex_array->index_buffer.index_per_object * vertex_array->vertex_buffer.count / vertex_array->vertex_buffer.vertex_per_object;
+#if defined(APORIA_EMSCRIPTEN)
     glDrawElements(vertex_array->mode, index_count, GL_UNSIGNED_INT, nullptr);
+#else
+    i32 base_vertex = vertexbuffer_get_base_vertex(&vertex_array->vertex_buffer);
+    glDrawElementsBaseVertex(vertex_array->mode, index_count, GL_UNSIGNED_INT, nullptr, base_vertex);
+#endif
 
     indexbuffer_unbind();
     vertexarray_unbind();
 
-    // @NOTE(dubgron): Here we could also memset vertex_buffer.data and textures_used_in_draw_call to zero.
-    vertex_array->vertex_buffer.count = 0;
+    // @NOTE(dubgron): Here we could also memset textures_used_in_draw_call to zero.
+    vertexbuffer_next_batch(&vertex_array->vertex_buffer);
+    first_unused_texture_unit = 0;
+}
+
+struct SpriteArray
+{
+    u32 id = 0;
+    u32 buffer_id = 0;
+    u32 max_count = 0;
+
+    // @NOTE(dubgron): On desktop, it points into the mapped buffer, at the first instance of
+    // the current batch.
+    SpriteInstance* data = nullptr;
+    u64 count = 0;
+
+#if !defined(APORIA_EMSCRIPTEN)
+    SpriteInstance* mapped = nullptr;
+    u64 frame_capacity = 0;
+    u64 frame_offset = 0;
+#endif
+};
+
+#if !defined(APORIA_EMSCRIPTEN)
+static u64 spritearray_get_base_instance(SpriteArray* sprite_array)
+{
+    return streaming_frame_index * sprite_array->frame_capacity + sprite_array->frame_offset;
+}
+
+static void spritearray_set_frame_offset(SpriteArray* sprite_array, u64 frame_offset)
+{
+    sprite_array->frame_offset = frame_offset;
+    sprite_array->data = sprite_array->mapped + spritearray_get_base_instance(sprite_array);
+}
+#endif
+
+// @NOTE(dubgron): Points the attributes of the bound vertex array at the instances in the
+// bound buffer, starting at the given byte offset.
+static void spriteinstance_add_layout(u64 offset)
+{
+    // @NOTE(dubgron): The center and the z are read together as a vec3.
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(SpriteInstance), (void*)(offset + offsetof(SpriteInstance, center)));
+    glVertexAttribDivisor(0, 1);
+
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(SpriteInstance), (void*)(offset + offsetof(SpriteInstance, color)));
+    glVertexAttribDivisor(1, 1);
+
+    // @NOTE(dubgron): The texture unit and the shape are read together.
+#if defined(APORIA_EMSCRIPTEN)
+    glEnableVertexAttribArray(2);
+    glVertexAttribPointer(2, 2, GL_UNSIGNED_BYTE, GL_FALSE, sizeof(SpriteInstance), (void*)(offset + offsetof(SpriteInstance, tex_unit)));
+    glVertexAttribDivisor(2, 1);
+#else
+    glEnableVertexAttribArray(2);
+    glVertexAttribIPointer(2, 2, GL_UNSIGNED_BYTE, sizeof(SpriteInstance), (void*)(offset + offsetof(SpriteInstance, tex_unit)));
+    glVertexAttribDivisor(2, 1);
+#endif
+
+    glEnableVertexAttribArray(3);
+    glVertexAttribPointer(3, 4, GL_UNSIGNED_SHORT, GL_TRUE, sizeof(SpriteInstance), (void*)(offset + offsetof(SpriteInstance, tex_rect)));
+    glVertexAttribDivisor(3, 1);
+
+    glEnableVertexAttribArray(4);
+    glVertexAttribPointer(4, 2, GL_HALF_FLOAT, GL_FALSE, sizeof(SpriteInstance), (void*)(offset + offsetof(SpriteInstance, half_size)));
+    glVertexAttribDivisor(4, 1);
+
+#if defined(APORIA_EDITOR)
+    glEnableVertexAttribArray(5);
+    glVertexAttribIPointer(5, 1, GL_INT, sizeof(SpriteInstance), (void*)(offset + offsetof(SpriteInstance, editor_index)));
+    glVertexAttribDivisor(5, 1);
+#endif
+
+    glEnableVertexAttribArray(6);
+    glVertexAttribPointer(6, 1, GL_UNSIGNED_SHORT, GL_TRUE, sizeof(SpriteInstance), (void*)(offset + offsetof(SpriteInstance, rotation)));
+    glVertexAttribDivisor(6, 1);
+}
+
+static SpriteArray spritearray_create(MemoryArena* arena, u32 max_count)
+{
+    SpriteArray result;
+    result.max_count = max_count;
+    result.count = 0;
+
+    glGenVertexArrays(1, &result.id);
+    glBindVertexArray(result.id);
+
+#if defined(APORIA_EMSCRIPTEN)
+    result.data = arena_push<SpriteInstance>(arena, result.max_count);
+
+    i64 size = result.max_count * sizeof(SpriteInstance);
+
+    glGenBuffers(1, &result.buffer_id);
+    glBindBuffer(GL_ARRAY_BUFFER, result.buffer_id);
+    glBufferData(GL_ARRAY_BUFFER, size, nullptr, GL_DYNAMIC_DRAW);
+#else
+    result.frame_capacity = STREAMING_OBJECTS_PER_FRAME;
+    APORIA_ASSERT(result.frame_capacity >= result.max_count);
+
+    i64 frame_size = result.frame_capacity * sizeof(SpriteInstance);
+
+    result.mapped = (SpriteInstance*)streaming_buffer_create(&result.buffer_id, frame_size);
+    spritearray_set_frame_offset(&result, 0);
+
+    glBindBuffer(GL_ARRAY_BUFFER, result.buffer_id);
+#endif
+
+    spriteinstance_add_layout(0);
+
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    return result;
+}
+
+static void spritearray_destroy(SpriteArray* sprite_array)
+{
+    glDeleteVertexArrays(1, &sprite_array->id);
+
+#if defined(APORIA_EMSCRIPTEN)
+    glDeleteBuffers(1, &sprite_array->buffer_id);
+#else
+    streaming_buffer_destroy(&sprite_array->buffer_id);
+#endif
+}
+
+static void spritearray_next_batch(SpriteArray* sprite_array)
+{
+#if !defined(APORIA_EMSCRIPTEN)
+    u64 frame_offset = sprite_array->frame_offset + sprite_array->count;
+    if (frame_offset + sprite_array->max_count > sprite_array->frame_capacity)
+    {
+        streaming_wait_for_gpu();
+        frame_offset = 0;
+    }
+
+    spritearray_set_frame_offset(sprite_array, frame_offset);
+#endif
+
+    sprite_array->count = 0;
+}
+
+static void spritearray_render(SpriteArray* sprite_array)
+{
+#if defined(APORIA_EMSCRIPTEN)
+    glBindBuffer(GL_ARRAY_BUFFER, sprite_array->buffer_id);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, sprite_array->count * sizeof(SpriteInstance), sprite_array->data);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+#endif
+
+    glBindVertexArray(sprite_array->id);
+#if defined(APORIA_EMSCRIPTEN)
+    glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, sprite_array->count);
+#else
+    u32 base_instance = spritearray_get_base_instance(sprite_array);
+    glDrawArraysInstancedBaseInstance(GL_TRIANGLE_STRIP, 0, 4, sprite_array->count, base_instance);
+#endif
+    glBindVertexArray(0);
+
+    spritearray_next_batch(sprite_array);
     first_unused_texture_unit = 0;
 }
 
@@ -309,137 +646,741 @@ static void uniformbuffer_destroy(UniformBuffer* uniform_buffer)
     glDeleteBuffers(1, &uniform_buffer->id);
 }
 
-static void uniformbuffer_bind_to_shader(UniformBuffer* uniform_buffer, u32 shader_id)
-{
-    u32 buffer_index = glGetUniformBlockIndex(shader_id, *uniform_buffer->block_name);
-    glUniformBlockBinding(shader_id, buffer_index, uniform_buffer->binding_index);
-}
+static void uniformbuffer_bind_to_shader(UniformBuffer* uniform_buffer, u32 shader_id)
+{
+    u32 buffer_index = glGetUniformBlockIndex(shader_id, *uniform_buffer->block_name);
+    glUniformBlockBinding(shader_id, buffer_index, uniform_buffer->binding_index);
+}
+
+static void uniformbuffer_set_data(UniformBuffer* uniform_buffer, void* data, u64 size)
+{
+#if defined(APORIA_EMSCRIPTEN)
+    glBindBuffer(GL_UNIFORM_BUFFER, uniform_buffer->id);
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, size, data);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+#else
+    glNamedBufferSubData(uniform_buffer->id, 0, size, data);
+#endif
+}
+
+// Index for VertexArray in Renderer
+enum class BufferType : u8
+{
+    Quads = 0,
+    Lines = 1,
+
+    // @NOTE(dubgron): Drawn from the sprite_array instead of the vertex_arrays.
+    Sprites = 2,
+};
+
+struct RenderQueueKey
+{
+    BufferType buffer = BufferType::Quads;
+    u32 shader_id = 0;
+    u32 texture_id = 0;
+
+    union
+    {
+        Vertex vertex[4] = {};
+        SpriteInstance sprite;
+    };
+
+    // @HACK(dubgron): Until Clang-17 and GCC-13, those compilers didn't properly
+    // compile anonymous unions of structs without default constructors.
+    RenderQueueKey() {};
+};
+
+// @NOTE(dubgron): The keys are sorted in the ascending order, from the most significant bits:
+//     | depth (24) | buffer (4) | shader (16) | texture (20) |
+// The depth is the z of the first vertex, mapped onto an unsigned integer which sorts in
+// the same order as the float, and cut down to its 24 top bits. This quantizes it to
+// about 15 bits of the mantissa, so the draws at (almost) the same depth are batched by
+// their buffer, shader and texture. The sort is stable, so the ties keep the order in
+// which the draws were submitted.
+static constexpr u64 RENDER_QUEUE_DEPTH_BITS = 24;
+static constexpr u64 RENDER_QUEUE_BUFFER_BITS = 4;
+static constexpr u64 RENDER_QUEUE_SHADER_BITS = 16;
+static constexpr u64 RENDER_QUEUE_TEXTURE_BITS = 20;
+
+static_assert(RENDER_QUEUE_DEPTH_BITS + RENDER_QUEUE_BUFFER_BITS + RENDER_QUEUE_SHADER_BITS + RENDER_QUEUE_TEXTURE_BITS == 64);
+
+struct RenderQueue
+{
+    RenderQueueKey* data = nullptr;
+    u64 max_count = 0;
+    u64 count = 0;
+
+    // @NOTE(dubgron): The draws stay where they were added, only their packed sort keys
+    // and indices are moved around by the sort.
+    u64* sort_keys = nullptr;
+    u32* indices = nullptr;
+
+    u64* temp_sort_keys = nullptr;
+    u32* temp_indices = nullptr;
+};
+
+static RenderQueue render_queue;
+static VertexArray vertex_arrays[2];
+static SpriteArray sprite_array;
+
+static VertexArray* get_vao_from_buffer(BufferType buffer_type)
+{
+    APORIA_ASSERT(buffer_type != BufferType::Sprites);
+    return &vertex_arrays[(u64)buffer_type];
+}
+
+static bool is_buffer_full(BufferType buffer_type)
+{
+    if (buffer_type == BufferType::Sprites)
+    {
+        return sprite_array.count == sprite_array.max_count;
+    }
+
+    VertexBuffer* vertex_buffer = &get_vao_from_buffer(buffer_type)->vertex_buffer;
+    return vertex_buffer->count + vertex_buffer->vertex_per_object > vertex_buffer->max_count;
+}
+
+static void render_buffer(BufferType buffer_type)
+{
+    if (buffer_type == BufferType::Sprites)
+    {
+        spritearray_render(&sprite_array);
+    }
+    else
+    {
+        vertexarray_render(get_vao_from_buffer(buffer_type));
+    }
+}
+
+#if !defined(APORIA_EMSCRIPTEN)
+static void streaming_frame_begin()
+{
+    // @NOTE(dubgron): Mark the end of the previous frame and move to the next section, which
+    // was last drawn from STREAMING_FRAMES_IN_FLIGHT - 1 frames ago.
+    streaming_fences[streaming_frame_index] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    streaming_frame_index = (streaming_frame_index + 1) % STREAMING_FRAMES_IN_FLIGHT;
+    streaming_wait_for_fence(&streaming_fences[streaming_frame_index]);
+
+    for (u64 idx = 0; idx < ARRAY_COUNT(vertex_arrays); ++idx)
+    {
+        VertexBuffer* vertex_buffer = &vertex_arrays[idx].vertex_buffer;
+        APORIA_ASSERT(vertex_buffer->count == 0);
+        vertexbuffer_set_frame_offset(vertex_buffer, 0);
+    }
+
+    APORIA_ASSERT(sprite_array.count == 0);
+    spritearray_set_frame_offset(&sprite_array, 0);
+}
+#endif
+
+static RenderQueue renderqueue_create(MemoryArena* arena, u64 in_count)
+{
+    RenderQueue result;
+    result.data = arena_push_uninitialized<RenderQueueKey>(arena, in_count);
+    result.max_count = in_count;
+    result.count = 0;
+
+    result.sort_keys = arena_push_uninitialized<u64>(arena, in_count);
+    result.indices = arena_push_uninitialized<u32>(arena, in_count);
+    result.temp_sort_keys = arena_push_uninitialized<u64>(arena, in_count);
+    result.temp_indices = arena_push_uninitialized<u32>(arena, in_count);
+
+    return result;
+}
+
+static u32 depth_to_sortable_bits(f32 depth)
+{
+    u32 bits;
+    memcpy(&bits, &depth, sizeof(u32));
+
+    // @NOTE(dubgron): Flip all the bits of the negative floats and only the sign bit of the
+    // positive ones, so the unsigned integers sort in the same order as the floats.
+    return (bits & 0x80000000) ? ~bits : (bits | 0x80000000);
+}
+
+static u64 renderqueue_make_sort_key(f32 z, BufferType buffer, u32 shader_id, u32 texture_id)
+{
+    APORIA_ASSERT(shader_id < (1ull << RENDER_QUEUE_SHADER_BITS));
+    APORIA_ASSERT(texture_id < (1ull << RENDER_QUEUE_TEXTURE_BITS));
+
+    u64 depth = depth_to_sortable_bits(z) >> (32 - RENDER_QUEUE_DEPTH_BITS);
+
+    u64 result = depth;
+    result = (result << RENDER_QUEUE_BUFFER_BITS) | (u64)buffer;
+    result = (result << RENDER_QUEUE_SHADER_BITS) | (u64)shader_id;
+    result = (result << RENDER_QUEUE_TEXTURE_BITS) | (u64)texture_id;
+    return result;
+}
+
+static u64 renderqueue_make_sort_key(const RenderQueueKey& key)
+{
+    f32 z = key.buffer == BufferType::Sprites ? key.sprite.z : key.vertex[0].position.z;
+    return renderqueue_make_sort_key(z, key.buffer, key.shader_id, key.texture_id);
+}
+
+static void renderqueue_add(RenderQueue* render_queue, const RenderQueueKey& key)
+{
+    APORIA_ASSERT(render_queue->count < render_queue->max_count);
+    render_queue->data[render_queue->count] = key;
+    render_queue->sort_keys[render_queue->count] = renderqueue_make_sort_key(key);
+    render_queue->indices[render_queue->count] = render_queue->count;
+    render_queue->count += 1;
+}
+
+// @NOTE(dubgron): Writes only the instance, without building the whole RenderQueueKey first.
+static void renderqueue_add_sprite(RenderQueue* render_queue, u32 texture_id, const SpriteInstance& sprite)
+{
+    APORIA_ASSERT(render_queue->count < render_queue->max_count);
+
+    RenderQueueKey* key = &render_queue->data[render_queue->count];
+    key->buffer = BufferType::Sprites;
+    key->shader_id = sprite_shader;
+    key->texture_id = texture_id;
+    key->sprite = sprite;
+
+    render_queue->sort_keys[render_queue->count] = renderqueue_make_sort_key(*key);
+    render_queue->indices[render_queue->count] = render_queue->count;
+    render_queue->count += 1;
+}
+
+static u16 rotation_to_unorm16(f32 rotation)
+{
+    f32 turns = rotation / (2.f * M_PI);
+    turns -= std::floor(turns);
+
+    // @NOTE(dubgron): The full turn wraps around to zero.
+    return (u16)(u32)(turns * 65536.f);
+}
+
+static SpriteInstance entity_make_sprite(EntityID entity_id, const EntityTransform& transform, const EntityRender& render, Color color, u32* out_texture_id)
+{
+    v2 size = v2{ transform.width, transform.height } * transform.scale;
+    v2 offset_to_center = size * (0.5f - transform.center_of_rotation);
+
+    SpriteInstance sprite;
+    sprite.z = transform.z;
+    sprite.half_size = glm::packHalf2x16(size * 0.5f);
+    sprite.color = color;
+
+    if (transform.rotation != 0.f)
+    {
+        f32 sin = std::sin(transform.rotation);
+        f32 cos = std::cos(transform.rotation);
+
+        sprite.center = transform.position + v2{ cos, sin } * offset_to_center.x + v2{ -sin, cos } * offset_to_center.y;
+        sprite.rotation = rotation_to_unorm16(transform.rotation);
+    }
+    else
+    {
+        sprite.center = transform.position + offset_to_center;
+    }
+
+#if defined(APORIA_EDITOR)
+    sprite.editor_index = entity_id.index;
+#endif
+
+    *out_texture_id = 0;
+    if (Texture* texture = get_texture(render.texture.texture_index))
+    {
+        *out_texture_id = texture->id;
+
+        sprite.tex_rect[0] = glm::packUnorm2x16(render.texture.u);
+        sprite.tex_rect[1] = glm::packUnorm2x16(render.texture.v);
+    }
+
+    return sprite;
+}
+
+#if defined(APORIA_EMSCRIPTEN)
+static constexpr u64 STATIC_SPRITES_ARENA_SIZE = MEGABYTES(8);
+#else
+static constexpr u64 STATIC_SPRITES_ARENA_SIZE = MEGABYTES(128);
+#endif
+
+// @NOTE(dubgron): The static entities are baked into a single instance buffer, sorted by the
+// same keys as the render queue, and rebuilt only when the static entities of the world
+// change. The buffer is split into batches of consecutive instances, which use at most
+// OPENGL_MAX_TEXTURE_UNITS textures, so the texture units can be baked into the instances.
+// The render queue draws the static instances in between its own draws, so everything is
+// still drawn in the order of the sort keys.
+//
+// The instances with the same sort key are ordered by the cell of the grid their center lies
+// in, and the batches are split at the cells as well, so every batch covers a small part of
+// the level. The batches outside of the camera view are skipped, so the cost of drawing the
+// static entities depends on the size of the view and not on the size of the level.
+static constexpr f32 STATIC_SPRITES_CELL_SIZE = 1024.f;
+
+struct StaticSpriteBatch
+{
+    u64 first = 0;
+    u64 count = 0;
+
+    u64 cell = 0;
+    Collider_AABB bounds;
+    bool is_visible = true;
+
+    // @NOTE(dubgron): The indices of the textures (see get_texture) bound to the consecutive
+    // texture units. The ids are looked up when drawing, since they change on reload.
+    i64 texture_indices[OPENGL_MAX_TEXTURE_UNITS] = { 0 };
+    u32 texture_count = 0;
+};
+
+struct StaticSprites
+{
+    u32 id = 0;
+    u32 buffer_id = 0;
+
+    MemoryArena arena;
+
+    u64* sort_keys = nullptr;
+    u64 count = 0;
+
+    StaticSpriteBatch* batches = nullptr;
+    u64 batch_count = 0;
+
+    // @NOTE(dubgron): The instance of every entity of the world, indexed by EntityID::index,
+    // or INDEX_INVALID if the entity isn't drawn from the static batches.
+    u32* entity_instances = nullptr;
+    i32 entity_count = 0;
+
+    // @NOTE(dubgron): The first instance, which hasn't been drawn during the current flush
+    // of the render queue yet, and the batch it belongs to.
+    u64 next_to_draw = 0;
+    u64 next_batch = 0;
+
+    u64 static_entities_version = 0;
+};
+
+static StaticSprites static_sprites;
+
+static StaticSprites staticsprites_create()
+{
+    StaticSprites result;
+    result.arena = arena_init(STATIC_SPRITES_ARENA_SIZE);
+
+    glGenVertexArrays(1, &result.id);
+    glBindVertexArray(result.id);
+
+#if defined(APORIA_EMSCRIPTEN)
+    glGenBuffers(1, &result.buffer_id);
+#else
+    glCreateBuffers(1, &result.buffer_id);
+#endif
+    glBindBuffer(GL_ARRAY_BUFFER, result.buffer_id);
+
+    spriteinstance_add_layout(0);
+
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    return result;
+}
+
+static void staticsprites_destroy(StaticSprites* static_sprites)
+{
+    glDeleteVertexArrays(1, &static_sprites->id);
+    glDeleteBuffers(1, &static_sprites->buffer_id);
+
+    arena_deinit(&static_sprites->arena);
+}
+
+static u64 staticsprites_get_cell(const Collider_AABB& bounds)
+{
+    v2 center = bounds.base + v2{ bounds.width, bounds.height } * 0.5f;
+    i32 cell_x = (i32)std::floor(center.x / STATIC_SPRITES_CELL_SIZE);
+    i32 cell_y = (i32)std::floor(center.y / STATIC_SPRITES_CELL_SIZE);
+    return ((u64)(u32)cell_y << 32) | (u64)(u32)cell_x;
+}
+
+static void staticsprites_rebuild(StaticSprites* static_sprites, World* world)
+{
+    arena_clear(&static_sprites->arena);
+
+    ScratchArena temp = scratch_begin(&static_sprites->arena);
+    defer { scratch_end(temp); };
+
+    WorldQuery query = world_query(temp.arena, world, EntityFlag_Visible | EntityFlag_Static);
+
+    u32* entity_instances = arena_push_uninitialized<u32>(&static_sprites->arena, world->entity_count);
+    memset(entity_instances, 0xff, world->entity_count * sizeof(u32));
+
+    // @NOTE(dubgron): Order the entities by their cells first. The radix sort is stable, so
+    // after sorting them by the sort keys, the entities with the same key stay in that order.
+    u64* cells = arena_push_uninitialized<u64>(temp.arena, query.count);
+    u32* entity_indices = arena_push_uninitialized<u32>(temp.arena, query.count);
+
+    u64 count = 0;
+    for (i64 query_idx = 0; query_idx < query.count; ++query_idx)
+    {
+        i32 idx = query.indices[query_idx];
+        if (!is_drawn_from_static_batches(world->flags.data[idx], world->renders.data[idx], world->animators.data[idx]))
+        {
+            continue;
+        }
+
+        cells[count] = staticsprites_get_cell(entity_transform_get_bounds(world->transforms.data[idx]));
+        entity_indices[count] = idx;
+        count += 1;
+    }
+
+    u64* temp_sort_keys = arena_push_uninitialized<u64>(temp.arena, count);
+    u32* temp_indices = arena_push_uninitialized<u32>(temp.arena, count);
+    radix_sort(cells, entity_indices, count, temp_sort_keys, temp_indices);
+
+    SpriteInstance* sprites = arena_push_uninitialized<SpriteInstance>(temp.arena, count);
+    i64* texture_indices = arena_push_uninitialized<i64>(temp.arena, count);
+    Collider_AABB* bounds = arena_push_uninitialized<Collider_AABB>(temp.arena, count);
+    u64* sort_keys = arena_push_uninitialized<u64>(&static_sprites->arena, count);
+    u32* indices = arena_push_uninitialized<u32>(temp.arena, count);
+
+    for (u64 idx = 0; idx < count; ++idx)
+    {
+        i32 entity_idx = entity_indices[idx];
+
+        const EntityTransform& transform = world->transforms.data[entity_idx];
+        const EntityRender& render = world->renders.data[entity_idx];
+
+        u32 texture_id = 0;
+        sprites[idx] = entity_make_sprite(world->ids.data[entity_idx], transform, render, render.color, &texture_id);
+        texture_indices[idx] = render.texture.texture_index;
+        bounds[idx] = entity_transform_get_bounds(transform);
+
+        sort_keys[idx] = renderqueue_make_sort_key(sprites[idx].z, BufferType::Sprites, sprite_shader, texture_id);
+        indices[idx] = idx;
+    }
+
+    radix_sort(sort_keys, indices, count, temp_sort_keys, temp_indices);
+
+    // @NOTE(dubgron): Every batch ends either at the last instance of a run of the instances
+    // from the same cell, or at an instance with its OPENGL_MAX_TEXTURE_UNITS + 1 texture.
+    u64 cell_run_count = 0;
+    for (u64 idx = 0; idx < count; ++idx)
+    {
+        if (idx == 0 || cells[indices[idx]] != cells[indices[idx - 1]])
+        {
+            cell_run_count += 1;
+        }
+    }
+
+    u64 max_batch_count = count / (OPENGL_MAX_TEXTURE_UNITS + 1) + cell_run_count + 1;
+    StaticSpriteBatch* batches = arena_push_uninitialized<StaticSpriteBatch>(&static_sprites->arena, max_batch_count);
+    u64 batch_count = 0;
+
+    SpriteInstance* sorted_sprites = arena_push_uninitialized<SpriteInstance>(temp.arena, count);
+    for (u64 idx = 0; idx < count; ++idx)
+    {
+        SpriteInstance sprite = sprites[indices[idx]];
+        i64 texture_index = texture_indices[indices[idx]];
+        u64 cell = cells[indices[idx]];
+
+        StaticSpriteBatch* batch = batch_count > 0 ? &batches[batch_count - 1] : nullptr;
+        if (batch && batch->cell != cell)
+        {
+            batch = nullptr;
+        }
+
+        u32 texture_unit = INDEX_INVALID;
+        if (batch)
+        {
+            for (u32 unit = 0; unit < batch->texture_count; ++unit)
+            {
+                if (batch->texture_indices[unit] == texture_index)
+                {
+                    texture_unit = unit;
+                    break;
+                }
+            }
+        }
+
+        if (texture_unit == INDEX_INVALID)
+        {
+            if (!batch || batch->texture_count == OPENGL_MAX_TEXTURE_UNITS)
+            {
+                APORIA_ASSERT(batch_count < max_batch_count);
+                batch = &batches[batch_count];
+                batch_count += 1;
+
+                *batch = StaticSpriteBatch{};
+                batch->first = idx;
+                batch->cell = cell;
+                batch->bounds = bounds[indices[idx]];
+            }
+
+            texture_unit = batch->texture_count;
+            batch->texture_indices[texture_unit] = texture_index;
+            batch->texture_count += 1;
+        }
+
+        sprite.tex_unit = texture_unit;
+        sorted_sprites[idx] = sprite;
+        batch->count += 1;
+        batch->bounds = aabb_union(batch->bounds, bounds[indices[idx]]);
+
+        entity_instances[entity_indices[indices[idx]]] = idx;
+    }
+
+    i64 size = count * sizeof(SpriteInstance);
+
+#if defined(APORIA_EMSCRIPTEN)
+    glBindBuffer(GL_ARRAY_BUFFER, static_sprites->buffer_id);
+    glBufferData(GL_ARRAY_BUFFER, size, sorted_sprites, GL_STATIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+#else
+    glNamedBufferData(static_sprites->buffer_id, size, sorted_sprites, GL_STATIC_DRAW);
+#endif
+
+    static_sprites->sort_keys = sort_keys;
+    static_sprites->count = count;
+    static_sprites->batches = batches;
+    static_sprites->batch_count = batch_count;
+    static_sprites->entity_instances = entity_instances;
+    static_sprites->entity_count = world->entity_count;
+    static_sprites->static_entities_version = world->static_entities_version;
+}
+
+// @NOTE(dubgron): Writes the instance of a static entity, which has only been moved, rotated
+// or scaled since the last rebuild, in place. The bounds of its batch only ever grow, until
+// the next rebuild. Returns false if the entity has to be rebuilt instead, e.g. because its
+// sort key has changed.
+static bool staticsprites_update_entity(StaticSprites* static_sprites, World* world, EntityID entity_id)
+{
+    if (!entity_is_valid(world, entity_id) || entity_id.index >= static_sprites->entity_count)
+    {
+        return false;
+    }
+
+    i32 entity_idx = entity_id.index;
+
+    u32 instance = static_sprites->entity_instances[entity_idx];
+    if (instance == (u32)INDEX_INVALID)
+    {
+        return false;
+    }
+
+    const EntityTransform& transform = world->transforms.data[entity_idx];
+    const EntityRender& render = world->renders.data[entity_idx];
+
+    if (!is_drawn_from_static_batches(world->flags.data[entity_idx], render, world->animators.data[entity_idx]))
+    {
+        return false;
+    }
+
+    u32 texture_id = 0;
+    SpriteInstance sprite = entity_make_sprite(entity_id, transform, render, render.color, &texture_id);
+
+    u64 sort_key = renderqueue_make_sort_key(sprite.z, BufferType::Sprites, sprite_shader, texture_id);
+    if (sort_key != static_sprites->sort_keys[instance])
+    {
+        return false;
+    }
+
+    // @NOTE(dubgron): Find the last batch, which begins at or before the instance.
+    u64 first_batch = 0;
+    u64 last_batch = static_sprites->batch_count;
+    while (last_batch - first_batch > 1)
+    {
+        u64 middle_batch = (first_batch + last_batch) / 2;
+        if (static_sprites->batches[middle_batch].first <= instance)
+        {
+            first_batch = middle_batch;
+        }
+        else
+        {
+            last_batch = middle_batch;
+        }
+    }
+
+    StaticSpriteBatch* batch = &static_sprites->batches[first_batch];
+
+    u32 texture_unit = INDEX_INVALID;
+    for (u32 unit = 0; unit < batch->texture_count; ++unit)
+    {
+        if (batch->texture_indices[unit] == render.texture.texture_index)
+        {
+            texture_unit = unit;
+            break;
+        }
+    }
+
+    if (texture_unit == INDEX_INVALID)
+    {
+        return false;
+    }
+
+    sprite.tex_unit = texture_unit;
+    batch->bounds = aabb_union(batch->bounds, entity_transform_get_bounds(transform));
+
+    i64 offset = instance * sizeof(SpriteInstance);
+
+#if defined(APORIA_EMSCRIPTEN)
+    glBindBuffer(GL_ARRAY_BUFFER, static_sprites->buffer_id);
+    glBufferSubData(GL_ARRAY_BUFFER, offset, sizeof(SpriteInstance), &sprite);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+#else
+    glNamedBufferSubData(static_sprites->buffer_id, offset, sizeof(SpriteInstance), &sprite);
+#endif
+
+    return true;
+}
+
+static void staticsprites_update(StaticSprites* static_sprites, World* world, const Collider_AABB& view_bounds)
+{
+    if (static_sprites->static_entities_version != world->static_entities_version)
+    {
+        staticsprites_rebuild(static_sprites, world);
+    }
+
+    for (u64 idx = 0; idx < static_sprites->batch_count; ++idx)
+    {
+        StaticSpriteBatch* batch = &static_sprites->batches[idx];
+        batch->is_visible = collision_aabb_to_aabb(view_bounds, batch->bounds);
+    }
+
+    static_sprites->next_to_draw = 0;
+    static_sprites->next_batch = 0;
+}
+
+// @NOTE(dubgron): Draws the static instances, which are sorted before the given key. The
+// texture units are reassigned, so the pending draws have to be rendered beforehand.
+static void staticsprites_render_before(StaticSprites* static_sprites, u64 sort_key)
+{
+    while (static_sprites->next_to_draw < static_sprites->count && static_sprites->sort_keys[static_sprites->next_to_draw] < sort_key)
+    {
+        const StaticSpriteBatch& batch = static_sprites->batches[static_sprites->next_batch];
+        u64 batch_end = batch.first + batch.count;
+
+        if (!batch.is_visible)
+        {
+            static_sprites->next_to_draw = batch_end;
+            static_sprites->next_batch += 1;
+            continue;
+        }
+
+        u64 first = static_sprites->next_to_draw;
+        u64 end = first + 1;
+        while (end < batch_end && static_sprites->sort_keys[end] < sort_key)
+        {
+            end += 1;
+        }
+
+        for (u32 texture_unit = 0; texture_unit < batch.texture_count; ++texture_unit)
+        {
+            Texture* texture = get_texture(batch.texture_indices[texture_unit]);
+            u32 texture_id = texture ? texture->id : 0;
+
+            textures_used_in_draw_call[texture_unit] = texture_id;
 
-static void uniformbuffer_set_data(UniformBuffer* uniform_buffer, void* data, u64 size)
-{
 #if defined(APORIA_EMSCRIPTEN)
-    glBindBuffer(GL_UNIFORM_BUFFER, uniform_buffer->id);
-    glBufferSubData(GL_UNIFORM_BUFFER, 0, size, data);
-    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+            glActiveTexture(GL_TEXTURE0 + texture_unit);
+            glBindTexture(GL_TEXTURE_2D, texture_id);
 #else
-    glNamedBufferSubData(uniform_buffer->id, 0, size, data);
+            glBindTextureUnit(texture_unit, texture_id);
 #endif
-}
-
-// Index for VertexArray in Renderer
-enum class BufferType : u8
-{
-    Quads = 0,
-    Lines = 1,
-};
+        }
+        first_unused_texture_unit = batch.texture_count;
 
-struct RenderQueueKey
-{
-    BufferType buffer = BufferType::Quads;
-    u32 shader_id = 0;
-    u32 texture_id = 0;
+        bind_shader(sprite_shader);
+        glBindVertexArray(static_sprites->id);
 
-    Vertex vertex[4];
-};
+#if defined(APORIA_EMSCRIPTEN)
+        // @NOTE(dubgron): There's no base instance in GLES 3.0, so the attributes are moved.
+        glBindBuffer(GL_ARRAY_BUFFER, static_sprites->buffer_id);
+        spriteinstance_add_layout(first * sizeof(SpriteInstance));
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
 
-struct RenderQueue
-{
-    RenderQueueKey* data = nullptr;
-    u64 max_count = 0;
-    u64 count = 0;
-};
+        glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, end - first);
+#else
+        glDrawArraysInstancedBaseInstance(GL_TRIANGLE_STRIP, 0, 4, end - first, first);
+#endif
 
-static RenderQueue render_queue;
-static VertexArray vertex_arrays[2];
+        glBindVertexArray(0);
+        first_unused_texture_unit = 0;
 
-static VertexArray* get_vao_from_buffer(BufferType buffer_type)
-{
-    return &vertex_arrays[(u64)buffer_type];
+        static_sprites->next_to_draw = end;
+        if (end == batch_end)
+        {
+            static_sprites->next_batch += 1;
+        }
+    }
 }
 
-static RenderQueue renderqueue_create(MemoryArena* arena, u64 in_count)
+static void renderqueue_flush(RenderQueue* render_queue, StaticSprites* static_sprites = nullptr)
 {
-    RenderQueue result;
-    result.data = arena_push_uninitialized<RenderQueueKey>(arena, in_count);
-    result.max_count = in_count;
-    result.count = 0;
-    return result;
-}
+    if (render_queue->count == 0 && !static_sprites)
+        return;
 
-static void renderqueue_add(RenderQueue* render_queue, const RenderQueueKey& key)
-{
-    APORIA_ASSERT(render_queue->count < render_queue->max_count);
-    render_queue->data[render_queue->count] = key;
-    render_queue->count += 1;
-}
+    radix_sort(render_queue->sort_keys, render_queue->indices, render_queue->count,
+        render_queue->temp_sort_keys, render_queue->temp_indices);
 
-static void renderqueue_flush(RenderQueue* render_queue)
-{
-    if (render_queue->count == 0)
-        return;
+    RenderQueueKey* prev_key = nullptr;
+    for (u64 idx = 0; idx < render_queue->count; ++idx)
+    {
+        RenderQueueKey* key = &render_queue->data[render_queue->indices[idx]];
 
-    intro_sort(render_queue->data, render_queue->count,
-        [](const RenderQueueKey* key0, const RenderQueueKey* key1) -> i32
+        if (static_sprites && static_sprites->next_to_draw < static_sprites->count
+            && static_sprites->sort_keys[static_sprites->next_to_draw] < render_queue->sort_keys[idx])
         {
-            f32 z_diff = key0->vertex[0].position.z - key1->vertex[0].position.z;
-            if (z_diff < FLT_EPSILON && z_diff > -FLT_EPSILON)
+            if (prev_key)
             {
-                i32 buffer_diff = (i32)key0->buffer - (i32)key1->buffer;
-                if (buffer_diff == 0)
-                {
-                    i32 shader_diff = key0->shader_id - key1->shader_id;
-                    if (shader_diff == 0)
-                    {
-                        uintptr_t ptr_diff = PTR_TO_INT(key0) - PTR_TO_INT(key1);
-                        return ptr_diff;
-                    }
-                    return shader_diff;
-                }
-                return buffer_diff;
+                bind_shader(prev_key->shader_id);
+                render_buffer(prev_key->buffer);
+                prev_key = nullptr;
             }
-            return z_diff > 0.f ? 1 : -1;
-        });
 
-    RenderQueueKey* prev_key = &render_queue->data[0];
-    for (u64 idx = 0; idx < render_queue->count; ++idx)
-    {
-        RenderQueueKey* key = &render_queue->data[idx];
+            staticsprites_render_before(static_sprites, render_queue->sort_keys[idx]);
+        }
 
-        if (key->shader_id != prev_key->shader_id || key->buffer != prev_key->buffer)
+        if (prev_key && (key->shader_id != prev_key->shader_id || key->buffer != prev_key->buffer))
         {
             bind_shader(prev_key->shader_id);
-            vertexarray_render(get_vao_from_buffer(prev_key->buffer));
+            render_buffer(prev_key->buffer);
         }
 
-        VertexArray* vertex_array = get_vao_from_buffer(key->buffer);
-        VertexBuffer* vertex_buffer = &vertex_array->vertex_buffer;
-
         u32 texture_unit = find_or_assign_texture_unit(key->texture_id);
 
         bool no_available_texture_units = (texture_unit == INDEX_INVALID);
-        bool vertex_buffer_overflow = (vertex_buffer->count + vertex_buffer->vertex_per_object > vertex_buffer->max_count);
+        bool buffer_overflow = is_buffer_full(key->buffer);
 
-        if (no_available_texture_units || vertex_buffer_overflow)
+        if (no_available_texture_units || buffer_overflow)
         {
             bind_shader(key->shader_id);
-            vertexarray_render(vertex_array);
+            render_buffer(key->buffer);
 
             texture_unit = find_or_assign_texture_unit(key->texture_id);
         }
 
-        for (u64 i = 0; i < vertex_buffer->vertex_per_object; ++i)
+        if (key->buffer == BufferType::Sprites)
+        {
+            key->sprite.tex_unit = texture_unit;
+
+            sprite_array.data[sprite_array.count] = key->sprite;
+            sprite_array.count += 1;
+        }
+        else
         {
-            key->vertex[i].tex_unit = texture_unit;
+            VertexBuffer* vertex_buffer = &get_vao_from_buffer(key->buffer)->vertex_buffer;
+            for (u64 i = 0; i < vertex_buffer->vertex_per_object; ++i)
+            {
+                key->vertex[i].tex_unit = texture_unit;
 
-            vertex_buffer->data[vertex_buffer->count] = key->vertex[i];
-            vertex_buffer->count += 1;
+                vertex_buffer->data[vertex_buffer->count] = key->vertex[i];
+                vertex_buffer->count += 1;
+            }
         }
 
         prev_key = key;
     }
 
-    bind_shader(prev_key->shader_id);
-    vertexarray_render(get_vao_from_buffer(prev_key->buffer));
+    if (prev_key)
+    {
+        bind_shader(prev_key->shader_id);
+        render_buffer(prev_key->buffer);
+    }
+
+    if (static_sprites)
+    {
+        staticsprites_render_before(static_sprites, UINT64_MAX);
+    }
 
     render_queue->count = 0;
 }
@@ -588,21 +1529,20 @@ static void framebuffer_flush(u32 shader_id)
     vertexarray_render(quads);
 }
 
-struct LightSourceArray
-{
-    LightSource* data = nullptr;
-    u64 max_count = 0;
-    u64 count = 0;
-};
+// @NOTE(dubgron): This is only the size of the reserved address space, the array
+// commits the memory as it grows.
+static constexpr i64 MAX_LIGHT_SOURCES = 65536;
 
-static constexpr u64 MAX_LIGHT_SOURCES = 1000;
+// @NOTE(dubgron): This has to match MAX_LIGHTS in raycasting.glsl and shadowcasting.glsl.
+// The shaders can't read more lights than that, so the rest of them is not uploaded (with a warning).
+static constexpr i64 MAX_LIGHT_SOURCES_PER_FRAME = 100;
 
 // @TODO(dubgron): Move the lighting code to the separate file.
 static bool lighting_enabled = false;
 static Framebuffer masking;
 static Framebuffer raycasting;
 static UniformBuffer lights_uniform_buffer;
-static LightSourceArray light_sources;
+static DynamicArray<LightSource> light_sources;
 
 bool is_lighting_enabled()
 {
@@ -613,14 +1553,12 @@ void enable_lighting()
 {
     lighting_enabled = true;
 
-    if (light_sources.data == nullptr)
+    if (!dynamic_array_is_created(&light_sources))
     {
-        light_sources.data = arena_push_uninitialized<LightSource>(&memory.persistent, MAX_LIGHT_SOURCES);
-        light_sources.max_count = MAX_LIGHT_SOURCES;
-        light_sources.count = 0;
+        light_sources = dynamic_array_create<LightSource>(MAX_LIGHT_SOURCES);
     }
 
-    lights_uniform_buffer = uniformbuffer_create(MAX_LIGHT_SOURCES * sizeof(LightSource), 0, "Lights");
+    lights_uniform_buffer = uniformbuffer_create(MAX_LIGHT_SOURCES_PER_FRAME * sizeof(LightSource), 0, "Lights");
     uniformbuffer_bind_to_shader(&lights_uniform_buffer, raycasting_shader);
     uniformbuffer_bind_to_shader(&lights_uniform_buffer, shadowcasting_shader);
 }
@@ -632,7 +1570,7 @@ void disable_lighting()
     framebuffer_destroy(&masking);
     framebuffer_destroy(&raycasting);
 
-    light_sources.count = 0;
+    dynamic_array_clear(&light_sources);
 
     uniformbuffer_destroy(&lights_uniform_buffer);
 }
@@ -641,14 +1579,26 @@ void add_light_source(LightSource source)
 {
     if (lighting_enabled)
     {
-        APORIA_ASSERT(light_sources.count < light_sources.max_count);
-        light_sources.data[light_sources.count] = source;
-        light_sources.count += 1;
+        dynamic_array_push(&light_sources, source);
     }
 }
 
 void rendering_init(MemoryArena* arena)
 {
+    // Intern the names of the uniforms
+    u_atlas               = ATOM_LITERAL("u_atlas");
+    u_vp_matrix           = ATOM_LITERAL("u_vp_matrix");
+    u_camera_zoom         = ATOM_LITERAL("u_camera_zoom");
+    u_time_since_selected = ATOM_LITERAL("u_time_since_selected");
+    u_masking             = ATOM_LITERAL("u_masking");
+    u_viewport_size       = ATOM_LITERAL("u_viewport_size");
+    u_render_surface_size = ATOM_LITERAL("u_render_surface_size");
+    u_num_lights          = ATOM_LITERAL("u_num_lights");
+    u_raycasting          = ATOM_LITERAL("u_raycasting");
+    u_grid_size           = ATOM_LITERAL("u_grid_size");
+    u_game_framebuffer    = ATOM_LITERAL("u_game_framebuffer");
+    u_ui_framebuffer      = ATOM_LITERAL("u_ui_framebuffer");
+
     render_queue = renderqueue_create(arena, MAX_RENDER_QUEUE_SIZE);
 
     // Set VertexArray for Quads
@@ -711,6 +1661,9 @@ void rendering_init(MemoryArena* arena)
         vertexarray_unbind();
     }
 
+    sprite_array = spritearray_create(arena, MAX_OBJECTS_PER_DRAW_CALL);
+    static_sprites = staticsprites_create();
+
 #if defined(APORIA_EMSCRIPTEN)
 #define SHADERS_DIRECTORY "content/shaders_gles/"
 #else
@@ -722,6 +1675,7 @@ void rendering_init(MemoryArena* arena)
     rectangle_shader        = load_shader(SHADERS_DIRECTORY "rectangle.glsl");
     line_shader             = load_shader(SHADERS_DIRECTORY "line.glsl");
     circle_shader           = load_shader(SHADERS_DIRECTORY "circle.glsl");
+    sprite_shader           = load_shader(SHADERS_DIRECTORY "sprite.glsl");
     font_shader             = load_shader(SHADERS_DIRECTORY "font.glsl");
     postprocessing_shader   = load_shader(SHADERS_DIRECTORY "postprocessing.glsl");
 
@@ -744,6 +1698,19 @@ void rendering_deinit()
     {
         vertexarray_destroy(&vertex_arrays[idx]);
     }
+    spritearray_destroy(&sprite_array);
+    staticsprites_destroy(&static_sprites);
+
+#if !defined(APORIA_EMSCRIPTEN)
+    for (u64 idx = 0; idx < STREAMING_FRAMES_IN_FLIGHT; ++idx)
+    {
+        if (streaming_fences[idx])
+        {
+            glDeleteSync(streaming_fences[idx]);
+            streaming_fences[idx] = nullptr;
+        }
+    }
+#endif
 
     framebuffer_destroy(&ui_framebuffer);
     framebuffer_destroy(&game_framebuffer);
@@ -768,9 +1735,38 @@ i32 game_render_height = 0;
 i32 ui_render_width = 0;
 i32 ui_render_height = 0;
 
+CullingStats culling_stats;
+
+static Collider_AABB culling_view_bounds;
+static bool culling_enabled = false;
+
+bool is_in_camera_view(const Collider_AABB& bounds)
+{
+    if (!culling_enabled)
+    {
+        return true;
+    }
+
+    bool is_visible = collision_aabb_to_aabb(culling_view_bounds, bounds);
+    if (is_visible)
+    {
+        culling_stats.visible_count += 1;
+    }
+    else
+    {
+        culling_stats.culled_count += 1;
+    }
+
+    return is_visible;
+}
+
 void rendering_frame_begin()
 {
-    light_sources.count = 0;
+#if !defined(APORIA_EMSCRIPTEN)
+    streaming_frame_begin();
+#endif
+
+    dynamic_array_clear(&light_sources);
 
     // @TODO(dubgron): We need to check it every frame only for the editor.
     // Maybe we should make it simpler in builds without the editor.
@@ -878,6 +1874,11 @@ void rendering_frame_begin()
             framebuffer_resize(&ui_framebuffer, ui_render_width, ui_render_height);
         }
     }
+
+    // @NOTE(dubgron): The camera is expected to stay in place until rendering_frame_end.
+    culling_view_bounds = camera_get_view_bounds(&active_camera);
+    culling_enabled = true;
+    culling_stats = CullingStats{};
 }
 
 void rendering_frame_end()
@@ -898,38 +1899,48 @@ void rendering_frame_end()
         16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31 };
 
     bind_shader(default_shader);
-    shader_set_int_array("u_atlas", sampler, OPENGL_MAX_TEXTURE_UNITS);
-    shader_set_mat4("u_vp_matrix", view_projection_matrix);
+    shader_set_int_array(u_atlas, sampler, OPENGL_MAX_TEXTURE_UNITS);
+    shader_set_mat4(u_vp_matrix, view_projection_matrix);
 
     bind_shader(rectangle_shader);
-    shader_set_mat4("u_vp_matrix", view_projection_matrix);
+    shader_set_mat4(u_vp_matrix, view_projection_matrix);
 
     bind_shader(line_shader);
-    shader_set_mat4("u_vp_matrix", view_projection_matrix);
+    shader_set_mat4(u_vp_matrix, view_projection_matrix);
 
     bind_shader(circle_shader);
-    shader_set_mat4("u_vp_matrix", view_projection_matrix);
+    shader_set_mat4(u_vp_matrix, view_projection_matrix);
+
+    bind_shader(sprite_shader);
+    shader_set_int_array(u_atlas, sampler, OPENGL_MAX_TEXTURE_UNITS);
+    shader_set_mat4(u_vp_matrix, view_projection_matrix);
 
     bind_shader(font_shader);
-    shader_set_int_array("u_atlas", sampler, OPENGL_MAX_TEXTURE_UNITS);
-    shader_set_mat4("u_vp_matrix", view_projection_matrix);
-    shader_set_float("u_camera_zoom", camera_zoom);
+    shader_set_int_array(u_atlas, sampler, OPENGL_MAX_TEXTURE_UNITS);
+    shader_set_mat4(u_vp_matrix, view_projection_matrix);
+    shader_set_float(u_camera_zoom, camera_zoom);
 
 #if defined(APORIA_EDITOR)
     if (editor_is_open && selected_entity_id.index != INDEX_INVALID)
     {
         bind_shader(editor_selected_shader);
-        shader_set_int_array("u_atlas", sampler, OPENGL_MAX_TEXTURE_UNITS);
-        shader_set_mat4("u_vp_matrix", view_projection_matrix);
-        shader_set_float("u_time_since_selected", time_since_selected);
+        shader_set_int_array(u_atlas, sampler, OPENGL_MAX_TEXTURE_UNITS);
+        shader_set_mat4(u_vp_matrix, view_projection_matrix);
+        shader_set_float(u_time_since_selected, time_since_selected);
 
         editor_draw_selected_entity();
     }
 #endif
 
-    renderqueue_flush(&render_queue);
+    staticsprites_update(&static_sprites, &current_world, culling_view_bounds);
+
+    renderqueue_flush(&render_queue, &static_sprites);
     framebuffer_unbind();
 
+    // @NOTE(dubgron): The entities outside of the view can still block the light, so the
+    // masking pass has to draw all of them.
+    culling_enabled = false;
+
 #if defined(APORIA_EDITOR)
     if (!editor_is_open && lighting_enabled)
 #else
@@ -942,32 +1953,47 @@ void rendering_frame_end()
         framebuffer_bind(masking);
         framebuffer_clear(Color::Transparent);
 
-        for (u64 idx = 0; idx < current_world.entity_count; ++idx)
+        ScratchArena temp = scratch_begin();
+
+        WorldQuery blocking_light = world_query(temp.arena, &current_world, EntityFlag_Visible | EntityFlag_BlockingLight);
+        for (i64 query_idx = 0; query_idx < blocking_light.count; ++query_idx)
         {
-            const Entity& entity = current_world.entity_array[idx];
-            if (entity_flags_has_all(entity, EntityFlag_Active | EntityFlag_Visible | EntityFlag_BlockingLight))
-            {
-                draw_entity(entity);
-            }
+            i32 idx = blocking_light.indices[query_idx];
+            draw_entity(current_world.ids.data[idx], current_world.transforms.data[idx], current_world.renders.data[idx]);
         }
 
+        scratch_end(temp);
+
         renderqueue_flush(&render_queue);
         framebuffer_unbind();
 
         //////////////////////////////////////////////////
         // Raycasting Shader
 
-        uniformbuffer_set_data(&lights_uniform_buffer, light_sources.data, light_sources.count * sizeof(LightSource));
+        u32 light_sources_count = min(light_sources.count, MAX_LIGHT_SOURCES_PER_FRAME);
+
+        // @NOTE(dubgron): Log only when the number of dropped lights changes, so we don't flood the log every frame.
+        static i64 last_dropped_light_count = 0;
+        i64 dropped_light_count = light_sources.count - light_sources_count;
+        if (dropped_light_count != last_dropped_light_count)
+        {
+            if (dropped_light_count > 0)
+            {
+                APORIA_LOG(Warning, "Too many light sources! Only % out of % are rendered.", light_sources_count, light_sources.count);
+            }
+            last_dropped_light_count = dropped_light_count;
+        }
+        uniformbuffer_set_data(&lights_uniform_buffer, light_sources.data, light_sources_count * sizeof(LightSource));
 
         u32 masking_unit = find_or_assign_texture_unit(masking.color_buffer_id);
 
         bind_shader(raycasting_shader);
-        shader_set_mat4("u_vp_matrix", view_projection_matrix);
-        shader_set_int("u_masking", masking_unit);
-        shader_set_float("u_camera_zoom", active_camera.projection.zoom);
-        shader_set_float2("u_viewport_size", viewport_width, viewport_height);
-        shader_set_float2("u_render_surface_size", game_render_width, game_render_height);
-        shader_set_uint("u_num_lights", light_sources.count);
+        shader_set_mat4(u_vp_matrix, view_projection_matrix);
+        shader_set_int(u_masking, masking_unit);
+        shader_set_float(u_camera_zoom, active_camera.projection.zoom);
+        shader_set_float2(u_viewport_size, viewport_width, viewport_height);
+        shader_set_float2(u_render_surface_size, game_render_width, game_render_height);
+        shader_set_uint(u_num_lights, light_sources_count);
 
         framebuffer_bind(raycasting);
         framebuffer_clear(Color::Black);
@@ -980,12 +2006,12 @@ void rendering_frame_end()
         u32 raycasting_unit = find_or_assign_texture_unit(raycasting.color_buffer_id);
 
         bind_shader(shadowcasting_shader);
-        shader_set_mat4("u_vp_matrix", view_projection_matrix);
-        shader_set_int("u_raycasting", raycasting_unit);
-        shader_set_float("u_camera_zoom", active_camera.projection.zoom);
-        shader_set_float2("u_viewport_size", viewport_width, viewport_height);
-        shader_set_float2("u_render_surface_size", game_render_width, game_render_height);
-        shader_set_uint("u_num_lights", light_sources.count);
+        shader_set_mat4(u_vp_matrix, view_projection_matrix);
+        shader_set_int(u_raycasting, raycasting_unit);
+        shader_set_float(u_camera_zoom, active_camera.projection.zoom);
+        shader_set_float2(u_viewport_size, viewport_width, viewport_height);
+        shader_set_float2(u_render_surface_size, game_render_width, game_render_height);
+        shader_set_uint(u_num_lights, light_sources_count);
 
         framebuffer_bind(game_framebuffer);
         framebuffer_flush(shadowcasting_shader);
@@ -1009,22 +2035,26 @@ void rendering_ui_end()
         16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31 };
 
     bind_shader(default_shader);
-    shader_set_int_array("u_atlas", sampler, OPENGL_MAX_TEXTURE_UNITS);
-    shader_set_mat4("u_vp_matrix", screen_to_clip);
+    shader_set_int_array(u_atlas, sampler, OPENGL_MAX_TEXTURE_UNITS);
+    shader_set_mat4(u_vp_matrix, screen_to_clip);
 
     bind_shader(rectangle_shader);
-    shader_set_mat4("u_vp_matrix", screen_to_clip);
+    shader_set_mat4(u_vp_matrix, screen_to_clip);
 
     bind_shader(line_shader);
-    shader_set_mat4("u_vp_matrix", screen_to_clip);
+    shader_set_mat4(u_vp_matrix, screen_to_clip);
 
     bind_shader(circle_shader);
-    shader_set_mat4("u_vp_matrix", screen_to_clip);
+    shader_set_mat4(u_vp_matrix, screen_to_clip);
+
+    bind_shader(sprite_shader);
+    shader_set_int_array(u_atlas, sampler, OPENGL_MAX_TEXTURE_UNITS);
+    shader_set_mat4(u_vp_matrix, screen_to_clip);
 
     bind_shader(font_shader);
-    shader_set_int_array("u_atlas", sampler, OPENGL_MAX_TEXTURE_UNITS);
-    shader_set_mat4("u_vp_matrix", screen_to_clip);
-    shader_set_float("u_camera_zoom", 1.f);
+    shader_set_int_array(u_atlas, sampler, OPENGL_MAX_TEXTURE_UNITS);
+    shader_set_mat4(u_vp_matrix, screen_to_clip);
+    shader_set_float(u_camera_zoom, 1.f);
 
     renderqueue_flush(&render_queue);
     framebuffer_unbind();
@@ -1042,8 +2072,8 @@ void rendering_flush_to_screen()
         const m4& view_projection_matrix = camera_calculate_view_projection_matrix(&active_camera);
 
         bind_shader(editor_grid_shader);
-        shader_set_mat4("u_vp_matrix", view_projection_matrix);
-        shader_set_float("u_grid_size", editor_config.editor_grid_size);
+        shader_set_mat4(u_vp_matrix, view_projection_matrix);
+        shader_set_float(u_grid_size, editor_config.editor_grid_size);
 
         VertexArray* quads = get_vao_from_buffer(BufferType::Quads);
 
@@ -1064,8 +2094,8 @@ void rendering_flush_to_screen()
         u32 ui_framebuffer_unit = find_or_assign_texture_unit(ui_framebuffer.color_buffer_id);
 
         bind_shader(postprocessing_shader);
-        shader_set_int("u_game_framebuffer", game_framebuffer_unit);
-        shader_set_int("u_ui_framebuffer", ui_framebuffer_unit);
+        shader_set_int(u_game_framebuffer, game_framebuffer_unit);
+        shader_set_int(u_ui_framebuffer, ui_framebuffer_unit);
 
         framebuffer_flush(postprocessing_shader);
     }
@@ -1085,22 +2115,26 @@ void rendering_flush_to_screen()
             16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31 };
 
         bind_shader(default_shader);
-        shader_set_int_array("u_atlas", sampler, OPENGL_MAX_TEXTURE_UNITS);
-        shader_set_mat4("u_vp_matrix", viewport_to_clip);
+        shader_set_int_array(u_atlas, sampler, OPENGL_MAX_TEXTURE_UNITS);
+        shader_set_mat4(u_vp_matrix, viewport_to_clip);
 
         bind_shader(rectangle_shader);
-        shader_set_mat4("u_vp_matrix", viewport_to_clip);
+        shader_set_mat4(u_vp_matrix, viewport_to_clip);
 
         bind_shader(line_shader);
-        shader_set_mat4("u_vp_matrix", viewport_to_clip);
+        shader_set_mat4(u_vp_matrix, viewport_to_clip);
 
         bind_shader(circle_shader);
-        shader_set_mat4("u_vp_matrix", viewport_to_clip);
+        shader_set_mat4(u_vp_matrix, viewport_to_clip);
+
+        bind_shader(sprite_shader);
+        shader_set_int_array(u_atlas, sampler, OPENGL_MAX_TEXTURE_UNITS);
+        shader_set_mat4(u_vp_matrix, viewport_to_clip);
 
         bind_shader(font_shader);
-        shader_set_int_array("u_atlas", sampler, OPENGL_MAX_TEXTURE_UNITS);
-        shader_set_mat4("u_vp_matrix", viewport_to_clip);
-        shader_set_float("u_camera_zoom", camera_zoom);
+        shader_set_int_array(u_atlas, sampler, OPENGL_MAX_TEXTURE_UNITS);
+        shader_set_mat4(u_vp_matrix, viewport_to_clip);
+        shader_set_float(u_camera_zoom, camera_zoom);
 
         editor_draw_gizmos();
 
@@ -1163,20 +2197,36 @@ void rendering_flush_to_screen()
 static i32 forced_entity_index = INDEX_INVALID;
 #endif
 
-void draw_entity(const Entity& entity)
+static void draw_entity_sprite(EntityID entity_id, const EntityTransform& transform, const EntityRender& render, Color color)
+{
+    u32 texture_id = 0;
+    SpriteInstance sprite = entity_make_sprite(entity_id, transform, render, color, &texture_id);
+
+    renderqueue_add_sprite(&render_queue, texture_id, sprite);
+}
+
+static void draw_entity_quad(EntityID entity_id, const EntityTransform& transform, const EntityRender& render, Color color)
 {
-    f32 sin = std::sin(entity.rotation);
-    f32 cos = std::cos(entity.rotation);
+    // @NOTE(dubgron): Only the predefined shaders have the instanced variant, the custom
+    // ones still get the vertices.
+    if (render.shader_id == default_shader)
+    {
+        draw_entity_sprite(entity_id, transform, render, color);
+        return;
+    }
 
-    v3 right_offset = v3{ cos, sin, 0.f } * entity.width * entity.scale.x;
-    v3 up_offset = v3{ -sin, cos, 0.f } * entity.height * entity.scale.y;
+    f32 sin = std::sin(transform.rotation);
+    f32 cos = std::cos(transform.rotation);
 
-    v3 offset_from_center = right_offset * entity.center_of_rotation.x + up_offset * entity.center_of_rotation.y;
-    v3 base_offset = v3{ entity.position, entity.z } - offset_from_center;
+    v3 right_offset = v3{ cos, sin, 0.f } * transform.width * transform.scale.x;
+    v3 up_offset = v3{ -sin, cos, 0.f } * transform.height * transform.scale.y;
+
+    v3 offset_from_center = right_offset * transform.center_of_rotation.x + up_offset * transform.center_of_rotation.y;
+    v3 base_offset = v3{ transform.position, transform.z } - offset_from_center;
 
     RenderQueueKey key;
     key.buffer = BufferType::Quads;
-    key.shader_id = entity.shader_id;
+    key.shader_id = render.shader_id;
 
     key.vertex[0].position = base_offset;
     key.vertex[1].position = base_offset + right_offset;
@@ -1185,26 +2235,57 @@ void draw_entity(const Entity& entity)
 
     for (i64 idx = 0; idx < ARRAY_COUNT(key.vertex); ++idx)
     {
-        key.vertex[idx].color = entity.color;
+        key.vertex[idx].color = color;
 
 #if defined(APORIA_EDITOR)
-        key.vertex[idx].editor_index = entity.id.index;
+        key.vertex[idx].editor_index = entity_id.index;
 #endif
     }
 
-    if (Texture* texture = get_texture(entity.texture.texture_index))
+    if (Texture* texture = get_texture(render.texture.texture_index))
     {
         key.texture_id = texture->id;
 
-        key.vertex[0].tex_coord = v2{ entity.texture.u.x, entity.texture.v.y };
-        key.vertex[1].tex_coord = entity.texture.v;
-        key.vertex[2].tex_coord = v2{ entity.texture.v.x, entity.texture.u.y };
-        key.vertex[3].tex_coord = entity.texture.u;
+        key.vertex[0].tex_coord = v2{ render.texture.u.x, render.texture.v.y };
+        key.vertex[1].tex_coord = render.texture.v;
+        key.vertex[2].tex_coord = v2{ render.texture.v.x, render.texture.u.y };
+        key.vertex[3].tex_coord = render.texture.u;
     }
 
     renderqueue_add(&render_queue, key);
 }
 
+bool is_drawn_from_static_batches(EntityFlags flags, const EntityRender& render, const Animator& animator)
+{
+    return entity_flags_has_all(flags, EntityFlag_Static) && render.shader_id == default_shader && !animation_is_playing(animator);
+}
+
+void rendering_update_static_entity(World* world, EntityID entity_id)
+{
+    // @NOTE(dubgron): The batches are out of date anyway, so they'll be rebuilt all at once.
+    if (static_sprites.static_entities_version != world->static_entities_version)
+    {
+        return;
+    }
+
+    if (!staticsprites_update_entity(&static_sprites, world, entity_id))
+    {
+        world_mark_static_entities_changed(world);
+    }
+}
+
+void draw_entity(EntityID entity_id, const EntityTransform& transform, const EntityRender& render)
+{
+    draw_entity_quad(entity_id, transform, render, render.color);
+}
+
+void draw_entity_interpolated(EntityID entity_id, const EntitySnapshot& last_frame, const EntityTransform& transform, const EntityRender& render, f32 alpha)
+{
+    EntityTransform transform_interpolated = entity_transform_lerp(last_frame.transform, transform, alpha);
+    Color color_interpolated = lerp(last_frame.color, render.color, alpha);
+    draw_entity_quad(entity_id, transform_interpolated, render, color_interpolated);
+}
+
 void draw_rectangle(v2 position, f32 width, f32 height, Color color /* = Color::White */, u32 shader_id /* = rectangle_shader */)
 {
     v2 right = v2{ width, 0.f };
@@ -1215,6 +2296,39 @@ void draw_rectangle(v2 position, f32 width, f32 height, Color color /* = Color::
 
 void draw_rectangle(v2 base, v2 right, v2 up, Color color /* = Color::White */, u32 shader_id /* = rectangle_shader */)
 {
+    if (!is_in_camera_view(aabb_from_parallelogram(base, right, up)))
+    {
+        return;
+    }
+
+    f32 width = glm::length(right);
+    f32 height = glm::length(up);
+
+    // @NOTE(dubgron): The sprites can't be skewed, so only the actual rectangles are instanced.
+    constexpr f32 max_skew = 0.001f;
+    bool is_rectangle = std::abs(glm::dot(right, up)) <= max_skew * width * height;
+
+    if (shader_id == rectangle_shader && is_rectangle)
+    {
+        // @NOTE(dubgron): If up is clockwise from right, the rectangle is mirrored.
+        f32 winding = right.x * up.y - right.y * up.x < 0.f ? -1.f : 1.f;
+
+        SpriteInstance sprite;
+        sprite.center = base + (right + up) * 0.5f;
+        sprite.z = Z_ALWAYS_IN_FRONT;
+        sprite.half_size = glm::packHalf2x16(v2{ width, height * winding } * 0.5f);
+        sprite.rotation = rotation_to_unorm16(std::atan2(right.y, right.x));
+        sprite.shape = SpriteShape_Rectangle;
+        sprite.color = color;
+
+#if defined(APORIA_EDITOR)
+        sprite.editor_index = forced_entity_index;
+#endif
+
+        renderqueue_add_sprite(&render_queue, 0, sprite);
+        return;
+    }
+
     RenderQueueKey key;
     key.buffer = BufferType::Quads;
     key.shader_id = shader_id;
@@ -1247,6 +2361,20 @@ void draw_rectangle(v2 base, v2 right, v2 up, Color color /* = Color::White */,
 
 void draw_line(v2 begin, v2 end, f32 thickness /* = 1.f */, Color color /* = Color::White */, u32 shader_id /* = line_shader */)
 {
+    {
+        f32 half_thickness = thickness / 2.f;
+
+        Collider_AABB bounds;
+        bounds.base = glm::min(begin, end) - half_thickness;
+        bounds.width = std::abs(end.x - begin.x) + thickness;
+        bounds.height = std::abs(end.y - begin.y) + thickness;
+
+        if (!is_in_camera_view(bounds))
+        {
+            return;
+        }
+    }
+
     v2 direction = glm::normalize(end - begin);
     v2 normal = v2{ -direction.y, direction.x };
 
@@ -1294,6 +2422,35 @@ void draw_circle(v2 position, f32 radius, f32 inner_radius, Color color /* = Col
     APORIA_ASSERT(inner_radius >= 0.f && inner_radius < radius);
     f32 inner_radius_normalized = inner_radius / radius;
 
+    {
+        Collider_AABB bounds;
+        bounds.base = position - radius;
+        bounds.width = bounds.height = radius * 2.f;
+
+        if (!is_in_camera_view(bounds))
+        {
+            return;
+        }
+    }
+
+    if (shader_id == circle_shader)
+    {
+        SpriteInstance sprite;
+        sprite.center = position;
+        sprite.z = Z_ALWAYS_IN_FRONT;
+        sprite.half_size = glm::packHalf2x16(v2{ radius, radius });
+        sprite.shape = SpriteShape_Circle;
+        sprite.tex_rect[0] = glm::packUnorm2x16(v2{ inner_radius_normalized, 0.f });
+        sprite.color = color;
+
+#if defined(APORIA_EDITOR)
+        sprite.editor_index = forced_entity_index;
+#endif
+
+        renderqueue_add_sprite(&render_queue, 0, sprite);
+        return;
+    }
+
     v3 base_offset = v3{ position, Z_ALWAYS_IN_FRONT };
     v3 right_half_offset = v3{ -radius, 0.f, 0.f };
     v3 up_half_offset = v3{ 0.f, radius, 0.f };
@@ -1441,6 +2598,23 @@ void draw_text(const Text& text)
     f32 total_text_height = (line_count - 1) * font.metrics.line_height + x_height;
     v2 center_offset = v2{ max_line_alignment, total_text_height } * text.center_of_rotation;
 
+    // @NOTE(dubgron): The glyphs can stick out of their lines (e.g. below the baseline), so
+    // the bounds of the text are padded with the height of a line.
+    {
+        f32 padding = font.metrics.line_height;
+        v2 lower = -center_offset - padding;
+        v2 size = v2{ max_line_alignment, total_text_height } + padding * 2.f;
+
+        v2 right = v2{ cos, sin } * text.font_size;
+        v2 up = v2{ -sin, cos } * text.font_size;
+
+        v2 base = text.position + right * lower.x + up * lower.y;
+        if (!is_in_camera_view(aabb_from_parallelogram(base, right * size.x, up * size.y)))
+        {
+            return;
+        }
+    }
+
     u64 current_line = 0;
     v2 advance{ 0.f, total_text_height - x_height };
     for (u64 idx = 0; idx < text.caption.length; ++idx)
@@ -1565,6 +2739,21 @@ void draw_text(const Text& text)
 
 void draw_triangle(v2 p0, v2 p1, v2 p2, Color color /* = Color::White */, u32 shader_id /* = rectangle_shader */)
 {
+    {
+        v2 lower = glm::min(p0, glm::min(p1, p2));
+        v2 upper = glm::max(p0, glm::max(p1, p2));
+
+        Collider_AABB bounds;
+        bounds.base = lower;
+        bounds.width = upper.x - lower.x;
+        bounds.height = upper.y - lower.y;
+
+        if (!is_in_camera_view(bounds))
+        {
+            return;
+        }
+    }
+
     RenderQueueKey key;
     key.buffer = BufferType::Quads;
     key.shader_id = shader_id;
@@ -1593,8 +2782,41 @@ void draw_triangle(v2 p0, v2 p1, v2 p2, Color color /* = Color::White */, u32 sh
 
 void draw_quad(v2 position, f32 width, f32 height, SubTexture* subtexture /* = nullptr */, Color color /* = Color::White */, u32 shader_id /* = default_shader */)
 {
+    if (!is_in_camera_view(aabb_from_parallelogram(position, v2{ width, 0.f }, v2{ 0.f, height })))
+    {
+        return;
+    }
+
     constexpr f32 z = 1.f;
 
+    if (shader_id == default_shader)
+    {
+        SpriteInstance sprite;
+        sprite.center = position + v2{ width, height } * 0.5f;
+        sprite.z = z;
+        sprite.half_size = glm::packHalf2x16(v2{ width, height } * 0.5f);
+        sprite.color = color;
+
+#if defined(APORIA_EDITOR)
+        sprite.editor_index = forced_entity_index;
+#endif
+
+        u32 texture_id = 0;
+        if (subtexture)
+        {
+            if (Texture* texture = get_texture(subtexture->texture_index))
+            {
+                texture_id = texture->id;
+
+                sprite.tex_rect[0] = glm::packUnorm2x16(subtexture->u);
+                sprite.tex_rect[1] = glm::packUnorm2x16(subtexture->v);
+            }
+        }
+
+        renderqueue_add_sprite(&render_queue, texture_id, sprite);
+        return;
+    }
+
     RenderQueueKey key;
     key.buffer = BufferType::Quads;
     key.shader_id = shader_id;
@@ -1657,3 +2879,94 @@ void set_editor_index(i32 editor_index)
     forced_entity_index = editor_index;
 }
 #endif
+
+#if defined(APORIA_BENCHMARKS)
+// @NOTE(dubgron): Compares the sort of the render queue against the intro_sort of the whole
+// RenderQueueKeys with the comparator, which renderqueue_flush used before. The draws are
+// generated like the ones of a typical scene: a few shaders, a few textures and most of the
+// sprites on a handful of layers.
+void benchmark_render_queue_sort()
+{
+    const i64 draw_counts[] = { 10000, 100000, 1000000 };
+
+    for (i64 draw_count : draw_counts)
+    {
+        RenderQueue queue = renderqueue_create(&memory.frame, draw_count);
+        RenderQueueKey* reference_keys = arena_push_uninitialized<RenderQueueKey>(&memory.frame, draw_count);
+
+        for (i64 idx = 0; idx < draw_count; ++idx)
+        {
+            RenderQueueKey key;
+            key.buffer = random_range(0, 9) == 0 ? BufferType::Lines : BufferType::Quads;
+            key.shader_id = random_range(1, 4);
+            key.texture_id = random_range(1, 8);
+            key.vertex[0].position.z = random_range(0, 15) * 0.5f;
+            renderqueue_add(&queue, key);
+        }
+
+        const i64 repeat_count = draw_count >= 1000000 ? 3 : 20;
+
+        f32 sort_ns = 0.f, reference_sort_ns = 0.f;
+        for (i64 repeat_idx = 0; repeat_idx < repeat_count; ++repeat_idx)
+        {
+            memcpy(reference_keys, queue.data, draw_count * sizeof(RenderQueueKey));
+
+            Timer timer;
+            intro_sort(reference_keys, draw_count, [](const RenderQueueKey* key0, const RenderQueueKey* key1) -> i32
+            {
+                f32 z_diff = key0->vertex[0].position.z - key1->vertex[0].position.z;
+                if (z_diff < FLT_EPSILON && z_diff > -FLT_EPSILON)
+                {
+                    i32 buffer_diff = (i32)key0->buffer - (i32)key1->buffer;
+                    if (buffer_diff == 0)
+                    {
+                        i32 shader_diff = key0->shader_id - key1->shader_id;
+                        if (shader_diff == 0)
+                        {
+                            uintptr_t ptr_diff = PTR_TO_INT(key0) - PTR_TO_INT(key1);
+                            return ptr_diff;
+                        }
+                        return shader_diff;
+                    }
+                    return buffer_diff;
+                }
+                return z_diff > 0.f ? 1 : -1;
+            });
+            reference_sort_ns += benchmark_nanoseconds(timer);
+
+            // @NOTE(dubgron): The keys are built again, because renderqueue_add builds them
+            // in the real frame too.
+            timer.reset();
+            for (i64 idx = 0; idx < draw_count; ++idx)
+            {
+                queue.sort_keys[idx] = renderqueue_make_sort_key(queue.data[idx]);
+                queue.indices[idx] = idx;
+            }
+            radix_sort(queue.sort_keys, queue.indices, draw_count, queue.temp_sort_keys, queue.temp_indices);
+            sort_ns += benchmark_nanoseconds(timer);
+        }
+
+        i64 texture_changes = 0, reference_texture_changes = 0;
+        bool is_sorted = true;
+        for (i64 idx = 1; idx < draw_count; ++idx)
+        {
+            const RenderQueueKey& prev_key = queue.data[queue.indices[idx - 1]];
+            const RenderQueueKey& key = queue.data[queue.indices[idx]];
+
+            texture_changes += key.texture_id != prev_key.texture_id;
+            reference_texture_changes += reference_keys[idx].texture_id != reference_keys[idx - 1].texture_id;
+
+            is_sorted &= prev_key.vertex[0].position.z <= key.vertex[0].position.z;
+            is_sorted &= queue.sort_keys[idx - 1] != queue.sort_keys[idx] || queue.indices[idx - 1] < queue.indices[idx];
+        }
+        APORIA_ASSERT(is_sorted);
+
+        const f32 ns_to_ms = 0.000001f / repeat_count;
+        APORIA_LOG(Info, "% draws (% B per RenderQueueKey): radix sort % ms (intro_sort % ms), texture changes % (intro_sort %)",
+            draw_count, sizeof(RenderQueueKey), sort_ns * ns_to_ms, reference_sort_ns * ns_to_ms,
+            texture_changes, reference_texture_changes);
+
+        arena_clear(&memory.frame);
+    }
+}
+#endif
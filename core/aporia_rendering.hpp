@@ -5,6 +5,8 @@
 #include "aporia_shaders.hpp"
 #include "aporia_textures.hpp"
 
+struct World;
+
 struct LightSource
 {
     v2 origin{ 0.f };
@@ -21,6 +23,19 @@ void disable_lighting();
 
 void add_light_source(LightSource light_source);
 
+// @NOTE(dubgron): The number of objects tested against the camera view in the last frame,
+// split by whether they were drawn or culled.
+struct CullingStats
+{
+    i64 visible_count = 0;
+    i64 culled_count = 0;
+};
+
+// @NOTE(dubgron): Between rendering_frame_begin and rendering_frame_end, the draw functions
+// skip everything outside of the view of the active camera, before it gets into the
+// render queue. Returns true outside of that range.
+bool is_in_camera_view(const Collider_AABB& bounds);
+
 void rendering_init(MemoryArena* arena);
 void rendering_deinit();
 
@@ -32,7 +47,19 @@ void rendering_ui_end();
 
 void rendering_flush_to_screen();
 
-void draw_entity(const Entity& entity);
+// @NOTE(dubgron): The static entities with the default shader are drawn from the static
+// batches by rendering_frame_end, so they shouldn't be passed to draw_entity. The ones with
+// a playing animation aren't, because their texture changes every few frames and the batches
+// would have to be rebuilt each time.
+bool is_drawn_from_static_batches(EntityFlags flags, const EntityRender& render, const Animator& animator);
+
+// @NOTE(dubgron): Keeps the static batches in sync with a static entity, which is being moved,
+// rotated or scaled, e.g. dragged around in the editor. Its instance is written in place, so
+// the batches aren't rebuilt every frame. Otherwise, the static entities are marked as changed.
+void rendering_update_static_entity(World* world, EntityID entity_id);
+
+void draw_entity(EntityID entity_id, const EntityTransform& transform, const EntityRender& render);
+void draw_entity_interpolated(EntityID entity_id, const EntitySnapshot& last_frame, const EntityTransform& transform, const EntityRender& render, f32 alpha);
 void draw_rectangle(v2 position, f32 width, f32 height, Color color = Color::White, u32 shader_id = rectangle_shader);
 void draw_rectangle(v2 base, v2 right, v2 up, Color color = Color::White, u32 shader_id = rectangle_shader);
 void draw_line(v2 begin, v2 end, f32 thickness = 1.f, Color color = Color::White, u32 shader_id = line_shader);
@@ -59,3 +86,5 @@ extern i32 game_render_height;
 
 extern i32 ui_render_width;
 extern i32 ui_render_height;
+
+extern CullingStats culling_stats;
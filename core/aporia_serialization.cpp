@@ -1,8 +1,17 @@
 #include "aporia_serialization.hpp"
 
+#include "aporia_atoms.hpp"
+#include "aporia_debug.hpp"
 #include "aporia_parser.hpp"
+#include "aporia_prefabs.hpp"
 #include "aporia_utils.hpp"
 
+// @NOTE(dubgron): The older saves started with entity_max_count, which is always positive,
+// so the version of the format is stored negated in its place. The saves from before the
+// prefabs are read as the version 0, and store every field of every entity.
+static constexpr i32 WORLD_BINARY_FORMAT_VERSION_NO_PREFABS = 0;
+static constexpr i32 WORLD_BINARY_FORMAT_VERSION = 1;
+
 template<typename T>
 static void serialize_write(Serializer* serializer, T value)
 {
@@ -62,6 +71,18 @@ static void serialize_read(Serializer* serializer, String* string)
     serialize_read_array(serializer, &string->data, string->length);
 }
 
+static void serialize_write(Serializer* serializer, Atom atom)
+{
+    serialize_write(serializer, atom_get_string(atom));
+}
+
+static void serialize_read(Serializer* serializer, Atom* atom)
+{
+    String string;
+    serialize_read(serializer, &string);
+    *atom = atom_intern(string);
+}
+
 static void serialize_write(Serializer* serializer, const SubTexture& subtexture)
 {
     String subtexture_name;
@@ -76,10 +97,9 @@ static void serialize_read(Serializer* serializer, SubTexture* subtexture)
 {
     String subtexture_name;
     serialize_read(serializer, &subtexture_name);
-    if (subtexture_name.length > 0)
-    {
-        *subtexture = *get_subtexture(subtexture_name);
-    }
+
+    // @NOTE(dubgron): An instance may override the texture of its prefab with no texture.
+    *subtexture = subtexture_name.length > 0 ? *get_subtexture(atom_intern(subtexture_name)) : SubTexture{};
 }
 
 static void serialize_write(Serializer* serializer, const Animator& animator)
@@ -134,49 +154,185 @@ static void serialize_read(Serializer* serializer, Collider* collider)
     }
 }
 
+enum EntityField_ : u32
+{
+    EntityField_Flags               = 0x0001,
+
+    EntityField_Position            = 0x0010,
+    EntityField_Z                   = 0x0020,
+    EntityField_Rotation            = 0x0040,
+    EntityField_CenterOfRotation    = 0x0080,
+    EntityField_Width               = 0x0100,
+    EntityField_Height              = 0x0200,
+    EntityField_Scale               = 0x0400,
+
+    EntityField_Texture             = 0x1000,
+    EntityField_Color               = 0x2000,
+    EntityField_ShaderID            = 0x4000,
+
+    EntityField_Animator            = 0x10000,
+    EntityField_Collider            = 0x20000,
+};
+
+static bool collider_equals(const Collider& collider_a, const Collider& collider_b)
+{
+    if (collider_a.type != collider_b.type)
+    {
+        return false;
+    }
+
+    switch (collider_a.type)
+    {
+        case ColliderType_AABB:
+        {
+            return collider_a.aabb.base == collider_b.aabb.base
+                && collider_a.aabb.width == collider_b.aabb.width
+                && collider_a.aabb.height == collider_b.aabb.height;
+        }
+
+        case ColliderType_Circle:
+        {
+            return collider_a.circle.base == collider_b.circle.base
+                && collider_a.circle.radius == collider_b.circle.radius;
+        }
+
+        case ColliderType_Polygon:
+        {
+            // @NOTE(dubgron): The instances of a prefab share the points with the prefab.
+            const Collider_Polygon& polygon_a = collider_a.polygon;
+            const Collider_Polygon& polygon_b = collider_b.polygon;
+            return polygon_a.point_count == polygon_b.point_count
+                && (polygon_a.points == polygon_b.points || memcmp(polygon_a.points, polygon_b.points, polygon_a.point_count * sizeof(v2)) == 0);
+        }
+    }
+
+    return true;
+}
+
+static bool animator_equals(const Animator& animator_a, const Animator& animator_b)
+{
+    return animator_a.current_animation == animator_b.current_animation
+        && animator_a.requested_animation == animator_b.requested_animation
+        && animator_a.current_frame == animator_b.current_frame
+        && animator_a.elapsed_time == animator_b.elapsed_time;
+}
+
+// @NOTE(dubgron): Returns the mask of the fields, in which the entity differs from its base,
+// i.e. its prefab or the default entity.
+static u32 entity_get_overridden_fields(const Entity& entity, const Entity& base)
+{
+    u32 result = 0;
+
+    if (entity.flags != base.flags)                                             result |= EntityField_Flags;
+
+    if (entity.transform.position != base.transform.position)                   result |= EntityField_Position;
+    if (entity.transform.z != base.transform.z)                                 result |= EntityField_Z;
+    if (entity.transform.rotation != base.transform.rotation)                   result |= EntityField_Rotation;
+    if (entity.transform.center_of_rotation != base.transform.center_of_rotation) result |= EntityField_CenterOfRotation;
+    if (entity.transform.width != base.transform.width)                         result |= EntityField_Width;
+    if (entity.transform.height != base.transform.height)                       result |= EntityField_Height;
+    if (entity.transform.scale != base.transform.scale)                         result |= EntityField_Scale;
+
+    if (!(entity.render.texture == base.render.texture))                        result |= EntityField_Texture;
+    if (entity.render.color != base.render.color)                               result |= EntityField_Color;
+    if (entity.render.shader_id != base.render.shader_id)                       result |= EntityField_ShaderID;
+
+    if (!animator_equals(entity.animator, base.animator))                       result |= EntityField_Animator;
+    if (!collider_equals(entity.collider, base.collider))                       result |= EntityField_Collider;
+
+    return result;
+}
+
+static Entity entity_get_base(Atom prefab)
+{
+    if (!atom_is_empty(prefab) && !prefab_get(prefab))
+    {
+        APORIA_LOG(Warning, "Failed to find the prefab named '%'! The entity will use the default values instead.", prefab);
+    }
+
+    Entity result = prefab_get_entity(prefab);
+    result.prefab = prefab;
+    return result;
+}
+
 static void entity_serialize(Serializer* serializer, const Entity& entity)
 {
+    const Entity base = prefab_get_entity(entity.prefab);
+    u32 fields = entity_get_overridden_fields(entity, base);
+
     serialize_write(serializer, entity.id);
+    serialize_write(serializer, entity.prefab);
+    serialize_write(serializer, fields);
 
-    serialize_write(serializer, entity.flags);
+    if (fields & EntityField_Flags)             serialize_write(serializer, entity.flags);
+
+    if (fields & EntityField_Position)          serialize_write(serializer, entity.transform.position);
+    if (fields & EntityField_Z)                 serialize_write(serializer, entity.transform.z);
+    if (fields & EntityField_Rotation)          serialize_write(serializer, entity.transform.rotation);
+    if (fields & EntityField_CenterOfRotation)  serialize_write(serializer, entity.transform.center_of_rotation);
+    if (fields & EntityField_Width)             serialize_write(serializer, entity.transform.width);
+    if (fields & EntityField_Height)            serialize_write(serializer, entity.transform.height);
+    if (fields & EntityField_Scale)             serialize_write(serializer, entity.transform.scale);
+
+    if (fields & EntityField_Texture)           serialize_write(serializer, entity.render.texture);
+    if (fields & EntityField_Color)             serialize_write(serializer, entity.render.color);
+    if (fields & EntityField_ShaderID)          serialize_write(serializer, entity.render.shader_id);
+
+    if (fields & EntityField_Animator)          serialize_write(serializer, entity.animator);
+    if (fields & EntityField_Collider)          serialize_write(serializer, entity.collider);
+}
+
+static void entity_deserialize(Serializer* serializer, Entity* entity)
+{
+    EntityID entity_id;
+    serialize_read(serializer, &entity_id);
 
-    serialize_write(serializer, entity.position);
-    serialize_write(serializer, entity.z);
+    Atom prefab;
+    serialize_read(serializer, &prefab);
 
-    serialize_write(serializer, entity.rotation);
-    serialize_write(serializer, entity.center_of_rotation);
+    *entity = entity_get_base(prefab);
+    entity->id = entity_id;
 
-    serialize_write(serializer, entity.width);
-    serialize_write(serializer, entity.height);
-    serialize_write(serializer, entity.scale);
+    u32 fields;
+    serialize_read(serializer, &fields);
 
-    serialize_write(serializer, entity.texture);
-    serialize_write(serializer, entity.color);
-    serialize_write(serializer, entity.shader_id);
+    if (fields & EntityField_Flags)             serialize_read(serializer, &entity->flags);
 
-    serialize_write(serializer, entity.animator);
-    serialize_write(serializer, entity.collider);
+    if (fields & EntityField_Position)          serialize_read(serializer, &entity->transform.position);
+    if (fields & EntityField_Z)                 serialize_read(serializer, &entity->transform.z);
+    if (fields & EntityField_Rotation)          serialize_read(serializer, &entity->transform.rotation);
+    if (fields & EntityField_CenterOfRotation)  serialize_read(serializer, &entity->transform.center_of_rotation);
+    if (fields & EntityField_Width)             serialize_read(serializer, &entity->transform.width);
+    if (fields & EntityField_Height)            serialize_read(serializer, &entity->transform.height);
+    if (fields & EntityField_Scale)             serialize_read(serializer, &entity->transform.scale);
+
+    if (fields & EntityField_Texture)           serialize_read(serializer, &entity->render.texture);
+    if (fields & EntityField_Color)             serialize_read(serializer, &entity->render.color);
+    if (fields & EntityField_ShaderID)          serialize_read(serializer, &entity->render.shader_id);
+
+    if (fields & EntityField_Animator)          serialize_read(serializer, &entity->animator);
+    if (fields & EntityField_Collider)          serialize_read(serializer, &entity->collider);
 }
 
-static void entity_deserialize(Serializer* serializer, Entity* entity, World* world)
+static void entity_deserialize_no_prefabs(Serializer* serializer, Entity* entity)
 {
     serialize_read(serializer, &entity->id);
 
     serialize_read(serializer, &entity->flags);
 
-    serialize_read(serializer, &entity->position);
-    serialize_read(serializer, &entity->z);
+    serialize_read(serializer, &entity->transform.position);
+    serialize_read(serializer, &entity->transform.z);
 
-    serialize_read(serializer, &entity->rotation);
-    serialize_read(serializer, &entity->center_of_rotation);
+    serialize_read(serializer, &entity->transform.rotation);
+    serialize_read(serializer, &entity->transform.center_of_rotation);
 
-    serialize_read(serializer, &entity->width);
-    serialize_read(serializer, &entity->height);
-    serialize_read(serializer, &entity->scale);
+    serialize_read(serializer, &entity->transform.width);
+    serialize_read(serializer, &entity->transform.height);
+    serialize_read(serializer, &entity->transform.scale);
 
-    serialize_read(serializer, &entity->texture);
-    serialize_read(serializer, &entity->color);
-    serialize_read(serializer, &entity->shader_id);
+    serialize_read(serializer, &entity->render.texture);
+    serialize_read(serializer, &entity->render.color);
+    serialize_read(serializer, &entity->render.shader_id);
 
     serialize_read(serializer, &entity->animator);
 
@@ -188,12 +344,14 @@ String world_serialize(MemoryArena* arena, const World& world)
     Serializer serializer;
     serializer.buffer = push_string(arena, MEGABYTES(5));
 
-    serialize_write(&serializer, world.entity_max_count);
+    serialize_write(&serializer, -WORLD_BINARY_FORMAT_VERSION);
     serialize_write(&serializer, world.entity_count);
 
     for (i32 idx = 0; idx < world.entity_count; ++idx)
     {
-        entity_serialize(&serializer, world.entity_array[idx]);
+        Entity entity;
+        entity_load(&world, world.ids.data[idx], &entity);
+        entity_serialize(&serializer, entity);
     }
 
     i64 unused_memory = serializer.buffer.length - serializer.offset;
@@ -207,31 +365,43 @@ World world_deserialize(String serialized)
     Serializer serializer;
     serializer.buffer = serialized;
 
-    i32 entity_max_count;
-    serialize_read(&serializer, &entity_max_count);
-    World world = world_init(entity_max_count);
-
-    serializer.arena = &world.arena;
+    i32 version;
+    serialize_read(&serializer, &version);
+    version = version >= 0 ? WORLD_BINARY_FORMAT_VERSION_NO_PREFABS : -version;
 
-    serialize_read(&serializer, &world.entity_count);
+    World world = world_init();
 
-    for (i32 idx = 0; idx < world.entity_count; ++idx)
+    if (version > WORLD_BINARY_FORMAT_VERSION)
     {
-        Entity* entity = &world.entity_array[idx];
-        entity_deserialize(&serializer, entity, &world);
+        APORIA_LOG(Error, "Can't deserialize the world! Expected the format version up to %, but got %!", WORLD_BINARY_FORMAT_VERSION, version);
+        return world;
     }
 
-    world.free_list = nullptr;
+    serializer.arena = &world.arena;
+
+    i32 entity_count;
+    serialize_read(&serializer, &entity_count);
+    world_resize(&world, entity_count);
+
     for (i32 idx = 0; idx < world.entity_count; ++idx)
     {
-        Entity* entity = &world.entity_array[idx];
-        if (!entity_flags_has_any(*entity, EntityFlag_Active))
+        Entity entity;
+        if (version == WORLD_BINARY_FORMAT_VERSION_NO_PREFABS)
         {
-            entity->next = world.free_list;
-            world.free_list = entity;
+            entity_deserialize_no_prefabs(&serializer, &entity);
         }
+        else
+        {
+            entity_deserialize(&serializer, &entity);
+        }
+
+        world.ids.data[idx] = entity.id;
+        entity_store(&world, entity.id, entity);
+        world.flags.data[idx] = entity.flags;
     }
 
+    world_rebuild_entity_lists(&world);
+
     return world;
 }
 
@@ -289,7 +459,8 @@ static void serialize_text_write_as_hex(StringList* builder, MemoryArena* arena,
 
 static void entity_serialize_to_text(MemoryArena* arena, StringList* builder, const Entity& entity)
 {
-    const Entity default_entity;
+    const Entity base = prefab_get_entity(entity.prefab);
+    u32 fields = entity_get_overridden_fields(entity, base);
 
     ScratchArena temp = scratch_begin(arena);
     defer { scratch_end(temp); };
@@ -298,48 +469,55 @@ static void entity_serialize_to_text(MemoryArena* arena, StringList* builder, co
 
     serialize_text_write(builder, arena, "  id", entity.id.index, entity.id.generation);
 
-    if (entity.flags != default_entity.flags)
+    if (!atom_is_empty(entity.prefab))
+        serialize_text_write(builder, arena, "  prefab", atom_get_string(entity.prefab));
+
+    if (fields & EntityField_Flags)
         serialize_text_write_as_hex(builder, arena, "  flags", entity.flags);
 
-    if (entity.position != default_entity.position)
-        serialize_text_write_as_hex(builder, arena, "  position", entity.position.x, entity.position.y);
+    if (fields & EntityField_Position)
+        serialize_text_write_as_hex(builder, arena, "  position", entity.transform.position.x, entity.transform.position.y);
 
-    if (entity.z != default_entity.z)
-        serialize_text_write_as_hex(builder, arena, "  z", entity.z);
+    if (fields & EntityField_Z)
+        serialize_text_write_as_hex(builder, arena, "  z", entity.transform.z);
 
-    if (entity.rotation != default_entity.rotation)
-        serialize_text_write_as_hex(builder, arena, "  rotation", entity.rotation);
+    if (fields & EntityField_Rotation)
+        serialize_text_write_as_hex(builder, arena, "  rotation", entity.transform.rotation);
 
-    if (entity.center_of_rotation != default_entity.center_of_rotation)
-        serialize_text_write_as_hex(builder, arena, "  center_of_rotation", entity.center_of_rotation.x, entity.center_of_rotation.y);
+    if (fields & EntityField_CenterOfRotation)
+        serialize_text_write_as_hex(builder, arena, "  center_of_rotation", entity.transform.center_of_rotation.x, entity.transform.center_of_rotation.y);
 
-    if (entity.width != default_entity.width)
-        serialize_text_write_as_hex(builder, arena, "  width", entity.width);
+    if (fields & EntityField_Width)
+        serialize_text_write_as_hex(builder, arena, "  width", entity.transform.width);
 
-    if (entity.height != default_entity.height)
-        serialize_text_write_as_hex(builder, arena, "  height", entity.height);
+    if (fields & EntityField_Height)
+        serialize_text_write_as_hex(builder, arena, "  height", entity.transform.height);
 
-    if (entity.scale != default_entity.scale)
-        serialize_text_write_as_hex(builder, arena, "  scale", entity.scale.x, entity.scale.y);
+    if (fields & EntityField_Scale)
+        serialize_text_write_as_hex(builder, arena, "  scale", entity.transform.scale.x, entity.transform.scale.y);
 
-    if (entity.texture.texture_index != INDEX_INVALID)
+    if (fields & EntityField_Texture)
     {
-        String subtexture_name = get_subtexture_name(entity.texture);
+        String subtexture_name;
+        if (entity.render.texture.texture_index != INDEX_INVALID)
+        {
+            subtexture_name = get_subtexture_name(entity.render.texture);
+        }
         serialize_text_write(builder, arena, "  texture", subtexture_name);
     }
 
-    if (entity.color != default_entity.color)
-        serialize_text_write_as_hex(builder, arena, "  color", entity.color);
+    if (fields & EntityField_Color)
+        serialize_text_write_as_hex(builder, arena, "  color", entity.render.color);
 
-    if (entity.shader_id != default_entity.shader_id)
-        serialize_text_write(builder, arena, "  shader_id", entity.shader_id);
+    if (fields & EntityField_ShaderID)
+        serialize_text_write(builder, arena, "  shader_id", entity.render.shader_id);
 
-    if (entity.animator.current_animation != default_entity.animator.current_animation)
+    if (fields & EntityField_Animator)
     {
         serialize_text_write(builder, arena, "  animator {");
 
-        serialize_text_write(builder, arena, "    current_animation", entity.animator.current_animation);
-        serialize_text_write(builder, arena, "    requested_animation", entity.animator.requested_animation);
+        serialize_text_write(builder, arena, "    current_animation", atom_get_string(entity.animator.current_animation));
+        serialize_text_write(builder, arena, "    requested_animation", atom_get_string(entity.animator.requested_animation));
 
         serialize_text_write(builder, arena, "    current_frame", entity.animator.current_frame);
         serialize_text_write_as_hex(builder, arena, "    elapsed_time", entity.animator.elapsed_time);
@@ -347,7 +525,7 @@ static void entity_serialize_to_text(MemoryArena* arena, StringList* builder, co
         serialize_text_write(builder, arena, "  }");
     }
 
-    if (entity.collider.type != ColliderType_None)
+    if (fields & EntityField_Collider)
     {
         serialize_text_write(builder, arena, "  collider {");
 
@@ -408,7 +586,9 @@ String world_serialize_to_text(MemoryArena* arena, const World& world)
         serialize_text_write(&builder, &temp, "entity_array");
         for (i32 idx = 0; idx < world.entity_count; ++idx)
         {
-            entity_serialize_to_text(&temp, &builder, world.entity_array[idx]);
+            Entity entity;
+            entity_load(&world, world.ids.data[idx], &entity);
+            entity_serialize_to_text(&temp, &builder, entity);
         }
     }
 
@@ -418,9 +598,22 @@ String world_serialize_to_text(MemoryArena* arena, const World& world)
     return result;
 }
 
-static Entity entity_deserialize_from_text(World* world, ParseTreeNode* field)
+Entity entity_deserialize_from_text(MemoryArena* arena, ParseTreeNode* field)
 {
-    Entity entity;
+    // @NOTE(dubgron): The prefab has to be applied first, because the other fields override it.
+    Atom prefab;
+    for (ParseTreeNode* node = field->child_first; node; node = node->next)
+    {
+        if (node->name == "prefab")
+        {
+            String prefab_name;
+            get_value_from_field(node, &prefab_name);
+            prefab = atom_intern(prefab_name);
+            break;
+        }
+    }
+
+    Entity entity = entity_get_base(prefab);
 
     for (ParseTreeNode* node = field->child_first; node; node = node->next)
     {
@@ -434,71 +627,69 @@ static Entity entity_deserialize_from_text(World* world, ParseTreeNode* field)
         }
         else if (node->name == "position")
         {
-            get_value_from_field(node, (f32*)&entity.position, 2);
+            get_value_from_field(node, (f32*)&entity.transform.position, 2);
         }
         else if (node->name == "z")
         {
-            get_value_from_field(node, &entity.z);
+            get_value_from_field(node, &entity.transform.z);
         }
         else if (node->name == "rotation")
         {
-            get_value_from_field(node, &entity.rotation);
+            get_value_from_field(node, &entity.transform.rotation);
         }
         else if (node->name == "center_of_rotation")
         {
-            get_value_from_field(node, (f32*)&entity.center_of_rotation, 2);
+            get_value_from_field(node, (f32*)&entity.transform.center_of_rotation, 2);
         }
         else if (node->name == "width")
         {
-            get_value_from_field(node, &entity.width);
+            get_value_from_field(node, &entity.transform.width);
         }
         else if (node->name == "height")
         {
-            get_value_from_field(node, &entity.height);
+            get_value_from_field(node, &entity.transform.height);
         }
         else if (node->name == "scale")
         {
-            get_value_from_field(node, &entity.scale[0], 2);
+            get_value_from_field(node, &entity.transform.scale[0], 2);
         }
         else if (node->name == "texture")
         {
             String subtexture_name;
             get_value_from_field(node, &subtexture_name);
-            if (subtexture_name.length > 0)
-            {
-                entity.texture = *get_subtexture(subtexture_name);
-            }
+            entity.render.texture = subtexture_name.length > 0 ? *get_subtexture(atom_intern(subtexture_name)) : SubTexture{};
         }
         else if (node->name == "color")
         {
             if (node->child_count == 1 && node->child_first->value_flags & ValueFlag_Hex)
             {
-                get_value_from_field(node, (u32*)&entity.color);
+                get_value_from_field(node, (u32*)&entity.render.color);
             }
             else
             {
-                get_value_from_field(node, &entity.color.r, node->child_count);
+                get_value_from_field(node, &entity.render.color.r, node->child_count);
             }
         }
         else if (node->name == "shader_id")
         {
-            get_value_from_field(node, &entity.shader_id);
+            get_value_from_field(node, &entity.render.shader_id);
         }
         else if (node->name == "animator")
         {
+            entity.animator = Animator{};
             for (ParseTreeNode* anim_node = node->child_first; anim_node; anim_node = anim_node->next)
             {
                 if (anim_node->name == "current_animation")
                 {
                     String current_animation;
                     get_value_from_field(anim_node, &current_animation);
-                    entity.animator.current_animation = push_string(&world->arena, current_animation);
+                    entity.animator.current_animation = atom_intern(current_animation);
                 }
                 else if (anim_node->name == "requested_animation")
                 {
                     String requested_animation;
                     get_value_from_field(anim_node, &requested_animation);
-                    entity.animator.requested_animation = push_string(&world->arena, requested_animation);
+                    entity.animator.requested_animation = atom_intern(requested_animation);
                 }
                 else if (anim_node->name == "current_frame")
                 {
@@ -512,6 +703,7 @@ static Entity entity_deserialize_from_text(World* world, ParseTreeNode* field)
         }
         else if (node->name == "collider")
         {
+            entity.collider = Collider{};
             for (ParseTreeNode* coll_node = node->child_first; coll_node; coll_node = coll_node->next)
             {
                 if (coll_node->name == "type")
@@ -570,7 +762,7 @@ static Entity entity_deserialize_from_text(World* world, ParseTreeNode* field)
                         }
                     }
 
-                    entity.collider.polygon.points = arena_push_uninitialized<v2>(&world->arena, entity.collider.polygon.point_count);
+                    entity.collider.polygon.points = arena_push_uninitialized<v2>(arena, entity.collider.polygon.point_count);
 
                     for (ParseTreeNode* coll_node = node->child_first; coll_node; coll_node = coll_node->next)
                     {
@@ -599,32 +791,31 @@ World world_deserialize_from_text(String serialized)
     {
         if (category->name == "world")
         {
-            for (ParseTreeNode* field = category->child_first; field; field = field->next)
-            {
-                if (field->name == "entity_max_count")
-                {
-                    get_value_from_field(field, &world.entity_max_count);
-                    break;
-                }
-            }
-
-            world = world_init(world.entity_max_count);
+            // @NOTE(dubgron): The entity_max_count is ignored, the world grows on demand.
+            world = world_init();
 
             for (ParseTreeNode* field = category->child_first; field; field = field->next)
             {
                 if (field->name == "entity_count")
                 {
-                    get_value_from_field(field, &world.entity_count);
+                    i32 entity_count;
+                    get_value_from_field(field, &entity_count);
+                    world_resize(&world, entity_count);
                 }
                 else if (field->name == "entity_array")
                 {
                     for (ParseTreeNode* node = field->child_first; node; node = node->next)
                     {
-                        Entity entity = entity_deserialize_from_text(&world, node);
-                        world.entity_array[entity.id.index] = entity;
+                        Entity entity = entity_deserialize_from_text(&world.arena, node);
+
+                        world.ids.data[entity.id.index] = entity.id;
+                        entity_store(&world, entity.id, entity);
+                        world.flags.data[entity.id.index] = entity.flags;
                     }
                 }
             }
+
+            world_rebuild_entity_lists(&world);
         }
     }
 
@@ -20,3 +20,8 @@ World world_deserialize(String serialized);
 
 String world_serialize_to_text(MemoryArena* arena, const World& world);
 World world_deserialize_from_text(String serialized);
+
+// @NOTE(dubgron): Reads a single entity in the text format, e.g. an element of the entity
+// array or a prefab. The points of its polygon collider are allocated on the arena.
+struct ParseTreeNode;
+Entity entity_deserialize_from_text(MemoryArena* arena, ParseTreeNode* field);
@@ -3,6 +3,7 @@
 #include "aporia_assets.hpp"
 #include "aporia_config.hpp"
 #include "aporia_debug.hpp"
+#include "aporia_dynamic_array.hpp"
 #include "aporia_utils.hpp"
 #include "platform/aporia_opengl.hpp"
 
@@ -10,6 +11,7 @@ u32 default_shader = 0;
 u32 rectangle_shader = 0;
 u32 line_shader = 0;
 u32 circle_shader = 0;
+u32 sprite_shader = 0;
 u32 font_shader = 0;
 u32 postprocessing_shader = 0;
 u32 raycasting_shader = 0;
@@ -20,9 +22,12 @@ u32 editor_grid_shader = 0;
 u32 editor_selected_shader = 0;
 #endif
 
-static constexpr u64 MAX_SHADERS = 128;
+// @NOTE(dubgron): The shaders are indexed by their OpenGL program names, so the array
+// has to be as long as the greatest name. This is only the size of the reserved
+// address space, the array commits the memory as it grows.
+static constexpr i64 MAX_SHADERS = 65536;
 
-static ShaderInfo* shaders = nullptr;
+static DynamicArray<ShaderInfo> shaders;
 static u32 active_shader_id = 0;
 
 SubShaderType string_to_subshader_type(String type)
@@ -224,7 +229,7 @@ static u32 compile_subshader(const SubShaderData& subshader)
 
 static bool is_shader_valid(u32 shader_id)
 {
-    return shader_id < MAX_SHADERS && shaders[shader_id].shader_id != 0;
+    return shader_id < shaders.count && shaders.data[shader_id].shader_id != 0;
 }
 
 static void apply_shader_properties(u32 shader_id)
@@ -232,7 +237,7 @@ static void apply_shader_properties(u32 shader_id)
     APORIA_ASSERT_WITH_MESSAGE(is_shader_valid(shader_id),
         "Shader (with ID: %) is not valid!", shader_id);
 
-    const ShaderProperties& properties = shaders[shader_id].properties;
+    const ShaderProperties& properties = shaders.data[shader_id].properties;
 
     if (properties.blend[0] != ShaderBlend::Off)
     {
@@ -258,24 +263,41 @@ static void apply_shader_properties(u32 shader_id)
     }
 }
 
-static i32 get_uniform_location(String name)
+static i32 get_uniform_location(Atom name)
 {
     APORIA_ASSERT_WITH_MESSAGE(is_shader_valid(active_shader_id),
         "No active shader!");
 
-    i32 location = glGetUniformLocation(active_shader_id, *name);
+    ShaderInfo* shader = &shaders.data[active_shader_id];
+    for (i64 idx = 0; idx < shader->uniforms_count; ++idx)
+    {
+        if (shader->uniforms[idx].name == name)
+        {
+            return shader->uniforms[idx].location;
+        }
+    }
+
+    i32 location = glGetUniformLocation(active_shader_id, atom_get_cstring(name));
 
     if (location == -1)
     {
         APORIA_LOG(Error, "'%' does not correspond to an active uniform variable in shader %!", name, active_shader_id);
     }
 
+    // @NOTE(dubgron): The invalid locations are cached too, so the error is logged only once.
+    if (shader->uniforms_count < MAX_CACHED_UNIFORMS)
+    {
+        shader->uniforms[shader->uniforms_count].name = name;
+        shader->uniforms[shader->uniforms_count].location = location;
+        shader->uniforms_count += 1;
+    }
+
     return location;
 }
 
-void shaders_init(MemoryArena* arena)
+void shaders_init()
 {
-    shaders = arena_push<ShaderInfo>(arena, MAX_SHADERS);
+    shaders = dynamic_array_create<ShaderInfo>(MAX_SHADERS);
 }
 
 static bool is_shader_status_ok(u32 shader_id, u32 status_type)
@@ -469,7 +491,12 @@ static u32 load_shader_from_file(String filepath, u64 subshaders_count)
         shader_info.properties.depth_write = shader_config.default_properties.depth_write;
     }
 
-    shaders[shader_id] = shader_info;
+    if (shader_id >= shaders.count)
+    {
+        dynamic_array_resize(&shaders, shader_id + 1);
+    }
+
+    shaders.data[shader_id] = shader_info;
 
     return shader_id;
 }
@@ -488,9 +515,9 @@ bool reload_shader_asset(Asset* shader_asset)
 {
     APORIA_ASSERT(shader_asset->type == AssetType::Shader);
 
-    for (u64 idx = 0; idx < MAX_SHADERS; ++idx)
+    for (i64 idx = 0; idx < shaders.count; ++idx)
     {
-        ShaderInfo* shader = &shaders[idx];
+        ShaderInfo* shader = &shaders.data[idx];
         if (shader->source_file == shader_asset->source_file)
         {
             bool reloaded_successfully = reload_shader(shader->shader_id);
@@ -509,7 +536,7 @@ bool reload_shader(u32 shader_id)
     APORIA_ASSERT_WITH_MESSAGE(is_shader_valid(shader_id),
         "Shader (with ID: %) is not valid!", shader_id);
 
-    ShaderInfo* shader = &shaders[shader_id];
+    ShaderInfo* shader = &shaders.data[shader_id];
 
     glDeleteProgram(shader->shader_id);
     shader->shader_id = 0;
@@ -523,15 +550,15 @@ void remove_shader(u32 shader_id)
         "Shader (with ID: %) is not valid!", shader_id);
 
     glDeleteProgram(shader_id);
-    shaders[shader_id].shader_id = 0;
+    shaders.data[shader_id].shader_id = 0;
 }
 
 void remove_all_shaders()
 {
-    for (u64 idx = 0; idx < MAX_SHADERS; ++idx)
+    for (i64 idx = 0; idx < shaders.count; ++idx)
     {
-        glDeleteProgram(shaders[idx].shader_id);
-        shaders[idx].shader_id = 0;
+        glDeleteProgram(shaders.data[idx].shader_id);
+        shaders.data[idx].shader_id = 0;
     }
 }
 
@@ -550,124 +577,124 @@ void unbind_shader()
     active_shader_id = 0;
 }
 
-void shader_set_float(String name, f32 value)
+void shader_set_float(Atom name, f32 value)
 {
     glUniform1f(get_uniform_location(name), value);
 }
 
-void shader_set_float2(String name, v2 value)
+void shader_set_float2(Atom name, v2 value)
 {
     glUniform2f(get_uniform_location(name), value.x, value.y);
 }
 
-void shader_set_float2(String name, f32 value_1, f32 value_2)
+void shader_set_float2(Atom name, f32 value_1, f32 value_2)
 {
     glUniform2f(get_uniform_location(name), value_1, value_2);
 }
 
-void shader_set_float3(String name, v3 value)
+void shader_set_float3(Atom name, v3 value)
 {
     glUniform3f(get_uniform_location(name), value.x, value.y, value.z);
 }
 
-void shader_set_float4(String name, v4 value)
+void shader_set_float4(Atom name, v4 value)
 {
     glUniform4f(get_uniform_location(name), value.x, value.y, value.z, value.w);
 }
 
-void shader_set_float_array(String name, f32* value, i32 count)
+void shader_set_float_array(Atom name, f32* value, i32 count)
 {
     glUniform1fv(get_uniform_location(name), count, value);
 }
 
 #if !defined(APORIA_EMSCRIPTEN)
-void shader_set_double(String name, f64 value)
+void shader_set_double(Atom name, f64 value)
 {
     glUniform1d(get_uniform_location(name), value);
 }
 
-void shader_set_double2(String name, v2_f64 value)
+void shader_set_double2(Atom name, v2_f64 value)
 {
     glUniform2d(get_uniform_location(name), value.x, value.y);
 }
 
-void shader_set_double3(String name, v3_f64 value)
+void shader_set_double3(Atom name, v3_f64 value)
 {
     glUniform3d(get_uniform_location(name), value.x, value.y, value.z);
 }
 
-void shader_set_double4(String name, v4_f64 value)
+void shader_set_double4(Atom name, v4_f64 value)
 {
     glUniform4d(get_uniform_location(name), value.x, value.y, value.z, value.w);
 }
 
-void shader_set_double_array(String name, f64* value, i32 count)
+void shader_set_double_array(Atom name, f64* value, i32 count)
 {
     glUniform1dv(get_uniform_location(name), count, value);
 }
 #endif
 
-void shader_set_int(String name, i32 value)
+void shader_set_int(Atom name, i32 value)
 {
     glUniform1i(get_uniform_location(name), value);
 }
 
-void shader_set_int2(String name, v2_i32 value)
+void shader_set_int2(Atom name, v2_i32 value)
 {
     glUniform2i(get_uniform_location(name), value.x, value.y);
 }
 
-void shader_set_int3(String name, v3_i32 value)
+void shader_set_int3(Atom name, v3_i32 value)
 {
     glUniform3i(get_uniform_location(name), value.x, value.y, value.z);
 }
 
-void shader_set_int4(String name, v4_i32 value)
+void shader_set_int4(Atom name, v4_i32 value)
 {
     glUniform4i(get_uniform_location(name), value.x, value.y, value.z, value.w);
 }
 
-void shader_set_int_array(String name, i32* value, i32 count)
+void shader_set_int_array(Atom name, i32* value, i32 count)
 {
     glUniform1iv(get_uniform_location(name), count, value);
 }
 
-void shader_set_uint(String name, u32 value)
+void shader_set_uint(Atom name, u32 value)
 {
     glUniform1ui(get_uniform_location(name), value);
 }
 
-void shader_set_uint2(String name, v2_u32 value)
+void shader_set_uint2(Atom name, v2_u32 value)
 {
     glUniform2ui(get_uniform_location(name), value.x, value.y);
 }
 
-void shader_set_uint3(String name, v3_u32 value)
+void shader_set_uint3(Atom name, v3_u32 value)
 {
     glUniform3ui(get_uniform_location(name), value.x, value.y, value.z);
 }
 
-void shader_set_uint4(String name, v4_u32 value)
+void shader_set_uint4(Atom name, v4_u32 value)
 {
     glUniform4ui(get_uniform_location(name), value.x, value.y, value.z, value.w);
 }
 
-void shader_set_uint_array(String name, u32* value, i32 count)
+void shader_set_uint_array(Atom name, u32* value, i32 count)
 {
     glUniform1uiv(get_uniform_location(name), count, value);
 }
 
-void shader_set_mat2(String name, m2 value, bool transpose /* = false */, i32 count /* = 1 */)
+void shader_set_mat2(Atom name, m2 value, bool transpose /* = false */, i32 count /* = 1 */)
 {
     glUniformMatrix2fv(get_uniform_location(name), count, transpose ? GL_TRUE : GL_FALSE, &value[0][0]);
 }
 
-void shader_set_mat3(String name, m3 value, bool transpose /* = false */, i32 count /* = 1 */)
+void shader_set_mat3(Atom name, m3 value, bool transpose /* = false */, i32 count /* = 1 */)
 {
     glUniformMatrix3fv(get_uniform_location(name), count, transpose ? GL_TRUE : GL_FALSE, &value[0][0]);
 }
 
-void shader_set_mat4(String name, m4 value, bool transpose /* = false */, i32 count /* = 1 */)
+void shader_set_mat4(Atom name, m4 value, bool transpose /* = false */, i32 count /* = 1 */)
 {
     glUniformMatrix4fv(get_uniform_location(name), count, transpose ? GL_TRUE : GL_FALSE, &value[0][0]);
 }
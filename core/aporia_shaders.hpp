@@ -1,6 +1,7 @@
 #pragma once
 
 #include "aporia_assets.hpp"
+#include "aporia_atoms.hpp"
 #include "aporia_string.hpp"
 #include "aporia_types.hpp"
 
@@ -101,15 +102,28 @@ struct ShaderData
     ShaderProperties properties;
 };
 
+struct ShaderUniform
+{
+    Atom name;
+    i32 location = -1;
+};
+
+// @NOTE(dubgron): The shaders use only a handful of uniforms each, so a linear search
+// through the cached locations is cheaper than asking the driver every time.
+constexpr i64 MAX_CACHED_UNIFORMS = 32;
+
 struct ShaderInfo
 {
     u32 shader_id = 0;
     u32 subshaders_count = 0;
     ShaderProperties properties;
     String source_file;
+
+    ShaderUniform uniforms[MAX_CACHED_UNIFORMS];
+    i64 uniforms_count = 0;
 };
 
-void shaders_init(MemoryArena* arena);
+void shaders_init();
 
 u32 load_shader(String filepath, u64 subshaders_count = 2);
 
@@ -122,42 +136,43 @@ void remove_all_shaders();
 void bind_shader(u32 shader_id);
 void unbind_shader();
 
-void shader_set_float(String name, f32 value);
-void shader_set_float2(String name, v2 value);
-void shader_set_float2(String name, f32 value_1, f32 value_2);
-void shader_set_float3(String name, v3 value);
-void shader_set_float4(String name, v4 value);
-void shader_set_float_array(String name, f32* value, i32 count);
+void shader_set_float(Atom name, f32 value);
+void shader_set_float2(Atom name, v2 value);
+void shader_set_float2(Atom name, f32 value_1, f32 value_2);
+void shader_set_float3(Atom name, v3 value);
+void shader_set_float4(Atom name, v4 value);
+void shader_set_float_array(Atom name, f32* value, i32 count);
 
 #if !defined(APORIA_EMSCRIPTEN)
-void shader_set_double(String name, f64 value);
-void shader_set_double2(String name, v2_f64 value);
-void shader_set_double3(String name, v3_f64 value);
-void shader_set_double4(String name, v4_f64 value);
-void shader_set_double_array(String name, f64* value, i32 count);
+void shader_set_double(Atom name, f64 value);
+void shader_set_double2(Atom name, v2_f64 value);
+void shader_set_double3(Atom name, v3_f64 value);
+void shader_set_double4(Atom name, v4_f64 value);
+void shader_set_double_array(Atom name, f64* value, i32 count);
 #endif
 
-void shader_set_int(String name, i32 value);
-void shader_set_int2(String name, v2_i32 value);
-void shader_set_int3(String name, v3_i32 value);
-void shader_set_int4(String name, v4_i32 value);
-void shader_set_int_array(String name, i32* value, i32 count);
+void shader_set_int(Atom name, i32 value);
+void shader_set_int2(Atom name, v2_i32 value);
+void shader_set_int3(Atom name, v3_i32 value);
+void shader_set_int4(Atom name, v4_i32 value);
+void shader_set_int_array(Atom name, i32* value, i32 count);
 
-void shader_set_uint(String name, u32 value);
-void shader_set_uint2(String name, v2_u32 value);
-void shader_set_uint3(String name, v3_u32 value);
-void shader_set_uint4(String name, v4_u32 value);
-void shader_set_uint_array(String name, u32* value, i32 count);
+void shader_set_uint(Atom name, u32 value);
+void shader_set_uint2(Atom name, v2_u32 value);
+void shader_set_uint3(Atom name, v3_u32 value);
+void shader_set_uint4(Atom name, v4_u32 value);
+void shader_set_uint_array(Atom name, u32* value, i32 count);
 
-void shader_set_mat2(String name, m2 value, bool transpose = false, i32 count = 1);
-void shader_set_mat3(String name, m3 value, bool transpose = false, i32 count = 1);
-void shader_set_mat4(String name, m4 value, bool transpose = false, i32 count = 1);
+void shader_set_mat2(Atom name, m2 value, bool transpose = false, i32 count = 1);
+void shader_set_mat3(Atom name, m3 value, bool transpose = false, i32 count = 1);
+void shader_set_mat4(Atom name, m4 value, bool transpose = false, i32 count = 1);
 
 // Predefined shaders
 extern u32 default_shader;
 extern u32 rectangle_shader;
 extern u32 line_shader;
 extern u32 circle_shader;
+extern u32 sprite_shader;
 extern u32 font_shader;
 extern u32 postprocessing_shader;
 extern u32 raycasting_shader;
@@ -20,19 +20,22 @@ static void* stbi_realloc(void* ptr, u64 new_size)
 
 #include "aporia_assets.hpp"
 #include "aporia_debug.hpp"
+#include "aporia_dynamic_array.hpp"
 #include "aporia_game.hpp"
 #include "aporia_parser.hpp"
 #include "aporia_utils.hpp"
 
-static constexpr u64 MAX_TEXTURES = 32;
-static constexpr u64 MAX_SUBTEXTURES = 2048;
+// @NOTE(dubgron): This is only the size of the reserved address space, the array
+// commits the memory as it grows.
+static constexpr i64 MAX_TEXTURES = 4096;
+static constexpr i64 INITIAL_SUBTEXTURE_BUCKET_COUNT = 256;
 
 // @NOTE(dubgron): The number of textures would be low, so we don't need to use
-// hash tables. Using a non-resizable array also gives us pointer stability.
-static Texture textures[MAX_TEXTURES];
-static u64 last_valid_texture_idx = 0;
+// hash tables. The dynamic array never moves its elements, which gives us pointer
+// stability.
+static DynamicArray<Texture> textures;
 
-HashTable<SubTexture> subtextures;
+HashTable<SubTexture, Atom> subtextures;
 
 Bitmap load_bitmap(MemoryArena* arena, String filepath)
 {
@@ -117,13 +120,13 @@ i64 load_texture_atlas(String filepath)
 
     if (!hash_table_is_created(&subtextures))
     {
-        subtextures = hash_table_create<SubTexture>(&memory.persistent, MAX_SUBTEXTURES);
+        subtextures = hash_table_create<SubTexture, Atom>(&memory.persistent, INITIAL_SUBTEXTURE_BUCKET_COUNT);
     }
 
     for (ParseTreeNode* subtexture_node = subtextures_node->child_first; subtexture_node; subtexture_node = subtexture_node->next)
     {
         APORIA_ASSERT(subtexture_node->type == ParseTreeNode_Struct && subtexture_node->child_count == 2);
-        String name = push_string(&memory.persistent, subtexture_node->name);
+        Atom name = atom_intern(subtexture_node->name);
 
         if (hash_table_find(&subtextures, name) != nullptr)
         {
@@ -153,10 +156,17 @@ i64 load_texture_atlas(String filepath)
 
 static i64 add_texture(const Texture& texture)
 {
+    if (!dynamic_array_is_created(&textures))
+    {
+        textures = dynamic_array_create<Texture>(MAX_TEXTURES);
+    }
+
+    // @NOTE(dubgron): In the headless mode none of the textures have an OpenGL id, so only
+    // the spots which don't have a source file are free.
     i64 found_spot = INDEX_INVALID;
-    for (u64 idx = 0; idx < last_valid_texture_idx; ++idx)
+    for (i64 idx = 0; idx < textures.count; ++idx)
     {
-        if (textures[idx].id == 0)
+        if (textures.data[idx].id == 0 && textures.data[idx].source_file.length == 0)
         {
             found_spot = idx;
             break;
@@ -165,18 +175,17 @@ static i64 add_texture(const Texture& texture)
 
     if (found_spot == INDEX_INVALID)
     {
-        APORIA_ASSERT(last_valid_texture_idx < MAX_TEXTURES);
-        found_spot = last_valid_texture_idx;
-        last_valid_texture_idx += 1;
+        found_spot = textures.count;
+        dynamic_array_push(&textures);
     }
 
     APORIA_ASSERT(found_spot != INDEX_INVALID);
-    textures[found_spot] = texture;
+    textures.data[found_spot] = texture;
 
     return found_spot;
 }
 
-static i64 load_texture_from_bitmap(Bitmap bitmap)
+static u32 create_opengl_texture(Bitmap bitmap)
 {
     u32 sized_format, base_format;
     switch (bitmap.channels)
@@ -226,6 +235,19 @@ static i64 load_texture_from_bitmap(Bitmap bitmap)
     glTextureParameteri(id, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
 #endif
 
+    return id;
+}
+
+static i64 load_texture_from_bitmap(Bitmap bitmap)
+{
+    // @NOTE(dubgron): The headless mode has no OpenGL context, so we only keep the size of
+    // the texture, which the gameplay code may depend on.
+    u32 id = 0;
+    if (!engine_is_headless)
+    {
+        id = create_opengl_texture(bitmap);
+    }
+
     Texture texture;
     texture.id = id;
     texture.width = bitmap.width;
@@ -251,9 +273,11 @@ static i64 load_texture_from_file(String filepath)
 
     // @NOTE(dubgron): The texture doesn't take an ownership over the filepath.
     // We have to make sure the texture doesn't outlive it.
-    textures[texture_index].source_file = filepath;
-
-    if (texture_index == INDEX_INVALID)
+    if (texture_index != INDEX_INVALID)
+    {
+        textures.data[texture_index].source_file = filepath;
+    }
+    else
     {
         APORIA_LOG(Error, "Failed to create OpenGL texture from '%'!", filepath);
     }
@@ -263,10 +287,10 @@ static i64 load_texture_from_file(String filepath)
 
 i64 find_or_load_texture_index(String filepath)
 {
-    for (i64 idx = 0; idx < last_valid_texture_idx; ++idx)
+    for (i64 idx = 0; idx < textures.count; ++idx)
     {
         // Texture already loaded.
-        if (textures[idx].source_file == filepath)
+        if (textures.data[idx].source_file == filepath)
         {
             return idx;
         }
@@ -285,16 +309,20 @@ bool reload_texture_asset(Asset* texture_asset)
 {
     APORIA_ASSERT(texture_asset->type == AssetType::Texture);
 
-    for (i64 idx = 0; idx < last_valid_texture_idx; ++idx)
+    for (i64 idx = 0; idx < textures.count; ++idx)
     {
-        Texture* texture = &textures[idx];
+        Texture* texture = &textures.data[idx];
         if (texture->source_file == texture_asset->source_file)
         {
-            glDeleteTextures(1, &texture->id);
+            if (!engine_is_headless)
+            {
+                glDeleteTextures(1, &texture->id);
+            }
             texture->id = 0;
+            texture->source_file = String{};
 
-            // @NOTE(dubgron): This should reload the new texture into the
-            // same spot as an old one because its ID has been zeroed out.
+            // @NOTE(dubgron): This should reload the new texture into the same spot
+            // as an old one because both its ID and its source file have been cleared.
             i64 reloaded_texture = load_texture_from_file(texture_asset->source_file);
             texture_asset->status = reloaded_texture != INDEX_INVALID ? AssetStatus::Loaded : AssetStatus::NotLoaded;
 
@@ -308,15 +336,15 @@ bool reload_texture_asset(Asset* texture_asset)
 
 Texture* get_texture(i64 index)
 {
-    if (index != INDEX_INVALID && index < last_valid_texture_idx)
+    if (index != INDEX_INVALID && index < textures.count)
     {
-        return &textures[index];
+        return &textures.data[index];
     }
 
     return nullptr;
 }
 
-SubTexture* get_subtexture(String name)
+SubTexture* get_subtexture(Atom name)
 {
     SubTexture* subtexture = hash_table_find(&subtextures, name);
     if (!subtexture)
@@ -342,9 +370,9 @@ String get_subtexture_name(const SubTexture& subtexture)
 
     for (i64 idx = 0; idx < subtextures.bucket_count; ++idx)
     {
-        if (subtexture == subtextures.buckets[idx].value)
+        if (hash_table_is_bucket_valid(&subtextures, idx) && subtexture == subtextures.buckets[idx].value)
         {
-            return subtextures.buckets[idx].key;
+            return atom_get_string(subtextures.buckets[idx].key);
         }
     }
 
@@ -1004,11 +1032,16 @@ static u8* uncompress_data_from_file(BinaryFile* file, MemoryArena* arena)
     strm.next_in = file->buffer.data + file->offset;
     strm.avail_in = file->buffer.length - file->offset;
 
-    i64 space_left = arena->max - arena->pos;
-    u8* result = arena_push_uninitialized<u8>(arena, space_left);
+    // @NOTE(dubgron): We don't know the size of the uncompressed data up front, so we
+    // grow the output buffer in chunks. The arena is contiguous and nothing else is
+    // pushed onto it in the meantime, so the consecutive chunks form a single buffer.
+    constexpr u64 chunk_size = KILOBYTES(64);
+
+    u8* result = arena_push_uninitialized<u8>(arena, chunk_size);
+    u64 output_size = chunk_size;
 
     strm.next_out = result;
-    strm.avail_out = space_left;
+    strm.avail_out = chunk_size;
 
     ScratchArena temp = scratch_begin(arena);
     {
@@ -1018,13 +1051,21 @@ static u8* uncompress_data_from_file(BinaryFile* file, MemoryArena* arena)
         APORIA_ASSERT(result == Z_OK);
 
         result = inflate(&strm, Z_FINISH);
+        while ((result == Z_OK || result == Z_BUF_ERROR) && strm.avail_out == 0)
+        {
+            arena_push_uninitialized<u8>(arena, chunk_size);
+            output_size += chunk_size;
+            strm.avail_out = chunk_size;
+
+            result = inflate(&strm, Z_FINISH);
+        }
         APORIA_ASSERT(result == Z_STREAM_END);
 
         inflateEnd(&strm);
     }
     scratch_end(temp);
 
-    arena_pop(arena, space_left - strm.total_out);
+    arena_pop(arena, output_size - strm.total_out);
     file->offset += strm.total_in;
 
     return result;
@@ -1068,7 +1109,13 @@ static void read_properties_from_file(BinaryFile* file, MemoryArena* arena, Asep
                 {
                     array->types = arena_push_uninitialized<u16>(arena, array->count);
 
-                    i64 max_needed_size = arena->max - arena->pos;
+                    i64 max_type_size_in_bytes = 0;
+                    for (i64 type_size_in_bytes : aseprite_type_size_in_bytes)
+                    {
+                        max_type_size_in_bytes = max(max_type_size_in_bytes, type_size_in_bytes);
+                    }
+
+                    i64 max_needed_size = array->count * max_type_size_in_bytes;
                     array->elements = arena_push_uninitialized<u8>(arena, max_needed_size);
 
                     i64 actual_needed_size = 0;
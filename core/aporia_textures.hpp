@@ -1,6 +1,7 @@
 #pragma once
 
 #include "aporia_assets.hpp"
+#include "aporia_atoms.hpp"
 #include "aporia_hash_table.hpp"
 #include "aporia_string.hpp"
 #include "aporia_types.hpp"
@@ -33,7 +34,9 @@ struct SubTexture
     i64 texture_index = INDEX_INVALID;
 };
 
-extern HashTable<SubTexture> subtextures;
+// @NOTE(dubgron): The subtextures are looked up by the atoms of their names, so the lookup
+// hashes an integer instead of the whole name.
+extern HashTable<SubTexture, Atom> subtextures;
 
 bool operator==(const SubTexture& tex0, const SubTexture& tex1);
 
@@ -44,6 +47,6 @@ i64 find_or_load_texture_index(String filepath);
 bool reload_texture_asset(Asset* texture_asset);
 
 Texture* get_texture(i64 index);
-SubTexture* get_subtexture(String name);
+SubTexture* get_subtexture(Atom name);
 void get_subtexture_size(const SubTexture& subtexture, f32* width, f32* height);
 String get_subtexture_name(const SubTexture& subtexture);
@@ -101,33 +101,95 @@ void fix_eol(String* filepath)
     filepath->length = dst;
 }
 
-constexpr u64 FNV_64_PRIME = 0x100000001b3;
-constexpr u64 FNV_64_OFFSET_BIAS = 0xcbf29ce484222325;
+u32 get_hash(String string)
+{
+    return hash_bytes((const char*)string.data, string.length);
+}
 
-static u64 fnv1a_hash(u64 value, u64 hash = FNV_64_OFFSET_BIAS)
+u32 get_hash(void* data, u64 size)
 {
-    hash ^= value;
-    return hash * FNV_64_PRIME;
+    String s{ (u8*)data, size };
+    return get_hash(s);
 }
 
-static u64 fnv1a_hash(String string, u64 hash = FNV_64_OFFSET_BIAS)
+u32 count_trailing_zeros(u64 value)
 {
-    for (u64 idx = 0; idx < string.length; ++idx)
-    {
-        hash = fnv1a_hash(string.data[idx], hash);
-    }
-    return hash;
+    APORIA_ASSERT(value != 0);
+
+#if defined(_MSC_VER)
+    unsigned long result;
+    _BitScanForward64(&result, value);
+    return result;
+#else
+    return __builtin_ctzll(value);
+#endif
 }
 
-u32 get_hash(String string)
+u32 count_set_bits(u64 value)
 {
-    return (u32)fnv1a_hash(string);
+#if defined(_MSC_VER)
+    return (u32)__popcnt64(value);
+#else
+    return __builtin_popcountll(value);
+#endif
 }
 
-u32 get_hash(void* data, u64 size)
+void radix_sort(u64* keys, u32* values, i64 count, u64* temp_keys, u32* temp_values)
 {
-    String s{ (u8*)data, size };
-    return get_hash(s);
+    constexpr i32 PASS_COUNT = sizeof(u64);
+    constexpr i32 BUCKET_COUNT = 256;
+
+    // @NOTE(dubgron): Count the bytes for all of the passes at once, so the keys are read
+    // only once before the scattering.
+    u32 histograms[PASS_COUNT][BUCKET_COUNT] = {};
+    for (i64 idx = 0; idx < count; ++idx)
+    {
+        u64 key = keys[idx];
+        for (i32 pass = 0; pass < PASS_COUNT; ++pass)
+        {
+            histograms[pass][(key >> (pass * 8)) & 0xff] += 1;
+        }
+    }
+
+    u64* src_keys = keys;
+    u32* src_values = values;
+    u64* dst_keys = temp_keys;
+    u32* dst_values = temp_values;
+
+    for (i32 pass = 0; pass < PASS_COUNT; ++pass)
+    {
+        u32* histogram = histograms[pass];
+        i32 shift = pass * 8;
+
+        if (count == 0 || histogram[(src_keys[0] >> shift) & 0xff] == count)
+        {
+            continue;
+        }
+
+        u32 offset = 0;
+        for (i32 bucket = 0; bucket < BUCKET_COUNT; ++bucket)
+        {
+            u32 bucket_count = histogram[bucket];
+            histogram[bucket] = offset;
+            offset += bucket_count;
+        }
+
+        for (i64 idx = 0; idx < count; ++idx)
+        {
+            u32 dst_idx = histogram[(src_keys[idx] >> shift) & 0xff]++;
+            dst_keys[dst_idx] = src_keys[idx];
+            dst_values[dst_idx] = src_values[idx];
+        }
+
+        swap(&src_keys, &dst_keys);
+        swap(&src_values, &dst_values);
+    }
+
+    if (src_keys != keys)
+    {
+        memcpy(keys, src_keys, count * sizeof(u64));
+        memcpy(values, src_values, count * sizeof(u32));
+    }
 }
 
 const Color Color::Black       = Color{  0,   0,   0,  255 };
@@ -2,6 +2,7 @@
 
 #include <chrono>
 #include <random>
+#include <type_traits>
 
 #include "aporia_debug.hpp"
 #include "aporia_memory.hpp"
@@ -81,9 +82,86 @@ String extract_filename(String filepath);
 void fix_path_slashes(String* filepath);
 void fix_eol(String* filepath);
 
+constexpr u64 HASH_SEED = 0x9e3779b97f4a7c15;
+constexpr u64 HASH_PRIME_1 = 0xbf58476d1ce4e5b9;
+constexpr u64 HASH_PRIME_2 = 0x94d049bb133111eb;
+
+// @NOTE(dubgron): Reads the bytes as a little-endian word. At runtime, it's a single load,
+// which assumes that the platform is little-endian (all of the supported ones are). The
+// compile-time version assembles the word byte by byte.
+template<typename T>
+constexpr u64 hash_read(const char* data)
+{
+    if (!std::is_constant_evaluated())
+    {
+        T result;
+        memcpy(&result, data, sizeof(T));
+        return result;
+    }
+
+    u64 result = 0;
+    for (u64 idx = 0; idx < sizeof(T); ++idx)
+    {
+        result |= (u64)(u8)data[idx] << (idx * 8);
+    }
+    return result;
+}
+
+constexpr u64 hash_mix(u64 hash, u64 word)
+{
+    hash = (hash ^ word) * HASH_PRIME_1;
+    return hash ^ (hash >> 32);
+}
+
+// @NOTE(dubgron): Hashes the data a word at a time. It's constexpr, so the hashes of the
+// string literals can be computed at compile time (see 'hash_literal'), and they always
+// agree with the ones computed at runtime by 'get_hash'.
+constexpr u32 hash_bytes(const char* data, u64 length)
+{
+    u64 hash = HASH_SEED ^ (length * HASH_PRIME_1);
+
+    // @NOTE(dubgron): The last word overlaps the previous one, instead of reading the
+    // remaining bytes one by one. The length is a part of the seed, so it's fine.
+    if (length >= 8)
+    {
+        for (u64 offset = 0; offset + 8 < length; offset += 8)
+        {
+            hash = hash_mix(hash, hash_read<u64>(data + offset));
+        }
+        hash = hash_mix(hash, hash_read<u64>(data + length - 8));
+    }
+    else if (length >= 4)
+    {
+        hash = hash_mix(hash, (hash_read<u32>(data) << 32) | hash_read<u32>(data + length - 4));
+    }
+    else if (length > 0)
+    {
+        hash = hash_mix(hash, ((u64)(u8)data[0] << 16) | ((u64)(u8)data[length / 2] << 8) | (u8)data[length - 1]);
+    }
+
+    // Finalize the hash, so every bit of the input affects every bit of the result.
+    hash ^= hash >> 30;
+    hash *= HASH_PRIME_1;
+    hash ^= hash >> 27;
+    hash *= HASH_PRIME_2;
+    hash ^= hash >> 31;
+
+    return (u32)hash;
+}
+
+template<u64 N>
+consteval u32 hash_literal(const char (&literal)[N])
+{
+    return hash_bytes(literal, N - 1);
+}
+
 u32 get_hash(String string);
 u32 get_hash(void* data, u64 size);
 
+// @NOTE(dubgron): The value must not be zero.
+u32 count_trailing_zeros(u64 value);
+u32 count_set_bits(u64 value);
+
 struct Color
 {
     u8 r = 255;
@@ -370,3 +448,9 @@ void intro_sort(T* data, i64 count, F comp)
     i64 max_depth = floor(log2(count)) * 2;
     intro_sort(data, count, comp, max_depth);
 }
+
+// @NOTE(dubgron): A stable LSD radix sort of 64-bit keys, one byte per pass, which moves the
+// values together with the keys. The passes over the bytes that are the same in every key
+// are skipped. The temp arrays have to fit count elements each. The sorted keys and values
+// end up back in the keys and values arrays.
+void radix_sort(u64* keys, u32* values, i64 count, u64* temp_keys, u32* temp_values);
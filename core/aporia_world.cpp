@@ -1,79 +1,730 @@
 #include "aporia_world.hpp"
 
 #include "aporia_debug.hpp"
+#include "aporia_jobs.hpp"
 
 World current_world;
 
-World world_init(i32 max_entities /* = 10000 */)
+static std::atomic<u64> last_static_entities_version{ 0 };
+
+#if defined(APORIA_EMSCRIPTEN)
+static constexpr i32 WORLD_MAX_ENTITIES = 1 << 16;
+static constexpr u64 WORLD_ARENA_SIZE = MEGABYTES(4);
+static constexpr u64 WORLD_CHUNK_ARENA_SIZE = KILOBYTES(64);
+static constexpr u64 WORLD_STEP_ARENA_SIZE = MEGABYTES(1);
+static constexpr u64 WORLD_COLLIDER_ARENA_SIZE = MEGABYTES(4);
+#else
+static constexpr i32 WORLD_MAX_ENTITIES = 1 << 22;
+static constexpr u64 WORLD_ARENA_SIZE = MEGABYTES(256);
+static constexpr u64 WORLD_CHUNK_ARENA_SIZE = MEGABYTES(8);
+static constexpr u64 WORLD_STEP_ARENA_SIZE = MEGABYTES(256);
+static constexpr u64 WORLD_COLLIDER_ARENA_SIZE = MEGABYTES(256);
+#endif
+
+// @NOTE(dubgron): The smallest class fits 4 points, which covers the boxes and the triangles.
+static constexpr i64 WORLD_COLLIDER_MIN_POINT_COUNT = 4;
+
+// @NOTE(dubgron): The number of live entities after which a chunk gets closed. With about
+// 50 bytes of the transform alone per entity, this keeps a chunk well within the L2 cache.
+static constexpr i32 WORLD_CHUNK_ENTITY_COUNT = 1024;
+
+enum WorldCommandType : u8
+{
+    WorldCommandType_Create,
+    WorldCommandType_Destroy,
+    WorldCommandType_Store,
+    WorldCommandType_SetTransform,
+    WorldCommandType_SetRender,
+    WorldCommandType_SetAnimator,
+    WorldCommandType_SetCollider,
+};
+
+// @NOTE(dubgron): The payload of the command (if any) is stored right after it.
+struct WorldCommand
 {
+    WorldCommandType type;
+    EntityID entity_id;
+
+    WorldCommand* next = nullptr;
+};
+
+// @NOTE(dubgron): The placeholder ids returned by entity_create_deferred have the index of
+// the entity within its chunk, and the index of the chunk encoded in a negative generation.
+// The real ids never have a negative generation, so entity_is_valid returns false for the
+// placeholders, and the accessors return nullptr. Passing one to entity_destroy is an
+// assertion failure.
+static constexpr i32 WORLD_PLACEHOLDER_GENERATION = -2;
+
+static bool entity_id_is_placeholder(EntityID entity_id)
+{
+    return entity_id.generation <= WORLD_PLACEHOLDER_GENERATION;
+}
+
+static i32 world_placeholder_get_chunk_index(EntityID entity_id)
+{
+    return WORLD_PLACEHOLDER_GENERATION - entity_id.generation;
+}
+
+template<typename T>
+static T* world_command_get_payload(WorldCommand* command)
+{
+    static_assert(sizeof(WorldCommand) % alignof(T) == 0);
+    return (T*)(command + 1);
+}
+
+static i32 world_collider_points_get_class(i64 point_count)
+{
+    i32 result = 0;
+    while ((WORLD_COLLIDER_MIN_POINT_COUNT << result) < point_count)
+    {
+        result += 1;
+    }
+
+    APORIA_ASSERT_WITH_MESSAGE(result < WORLD_COLLIDER_POINT_CLASS_COUNT, "The polygon has too many points (%)!", point_count);
+    return result;
+}
+
+static v2* world_collider_points_alloc(World* world, i64 point_count)
+{
+    i32 point_class = world_collider_points_get_class(point_count);
+
+    v2* result = world->free_collider_points[point_class];
+    if (result)
+    {
+        // @NOTE(dubgron): The free points store the pointer to the next free points in place.
+        world->free_collider_points[point_class] = *(v2**)result;
+    }
+    else
+    {
+        result = arena_push_uninitialized<v2>(&world->collider_arena, WORLD_COLLIDER_MIN_POINT_COUNT << point_class);
+    }
+
+    return result;
+}
+
+static void world_collider_points_free(World* world, v2* points, i64 point_count)
+{
+    static_assert(sizeof(v2) >= sizeof(v2*));
+
+    i32 point_class = world_collider_points_get_class(point_count);
+
+    *(v2**)points = world->free_collider_points[point_class];
+    world->free_collider_points[point_class] = points;
+}
+
+World world_init(i32 history_depth /* = 1 */)
+{
+    APORIA_ASSERT(history_depth > 0);
+
     World world;
-    world.entity_max_count = max_entities;
+    world.entity_max_count = WORLD_MAX_ENTITIES;
+    world.history_depth = history_depth;
+
+    world.arena = arena_init(WORLD_ARENA_SIZE);
+    world.step_arena = arena_init(WORLD_STEP_ARENA_SIZE);
+
+    world.ids = dynamic_array_create<EntityID>(world.entity_max_count);
+    world.flags = dynamic_array_create<EntityFlags>(world.entity_max_count);
+    world.types = dynamic_array_create<EntityType>(world.entity_max_count);
+    world.prefabs = dynamic_array_create<Atom>(world.entity_max_count);
+    world.transforms = dynamic_array_create<EntityTransform>(world.entity_max_count);
+    world.renders = dynamic_array_create<EntityRender>(world.entity_max_count);
+    world.animators = dynamic_array_create<Animator>(world.entity_max_count);
+    world.colliders = dynamic_array_create<Collider>(world.entity_max_count);
+
+    world.world_colliders = dynamic_array_create<Collider>(world.entity_max_count);
+    world.world_bounds = dynamic_array_create<Collider_AABB>(world.entity_max_count);
+    world.render_bounds = dynamic_array_create<Collider_AABB>(world.entity_max_count);
+    world.collider_arena = arena_init(WORLD_COLLIDER_ARENA_SIZE);
+
+    world.live_bits = dynamic_array_create<u64>((world.entity_max_count + 63) / 64);
+    world.free_indices = dynamic_array_create<i32>(world.entity_max_count);
+    world.pending_free_indices = dynamic_array_create<i32>(world.entity_max_count);
 
-    // @TODO(dubgron): The count of the world arena should be more planned out.
-    i64 world_arena_size = world.entity_max_count * sizeof(Entity) * 4;
-    world.arena = arena_init(world_arena_size);
-    APORIA_LOG(Info, "World has allocated % B of memory.", world_arena_size);
+    world.history = arena_push<DynamicArray<EntitySnapshot>>(&world.arena, world.history_depth);
+    for (i32 idx = 0; idx < world.history_depth; ++idx)
+    {
+        world.history[idx] = dynamic_array_create<EntitySnapshot>(world.entity_max_count);
+    }
+
+    world.chunks = dynamic_array_create<WorldChunk>((world.entity_max_count + 63) / 64);
 
-    world.entity_array = arena_push<Entity>(&world.arena, world.entity_max_count);
-    world.entity_array_last_frame = arena_push<Entity>(&world.arena, world.entity_max_count);
+    world_mark_static_entities_changed(&world);
 
     return world;
 }
 
 void world_deinit(World* world)
 {
+    for (i64 idx = 0; idx < world->chunks.count; ++idx)
+    {
+        arena_deinit(&world->chunks.data[idx].arena);
+    }
+    dynamic_array_destroy(&world->chunks);
+
+    for (i32 idx = 0; idx < world->history_depth; ++idx)
+    {
+        dynamic_array_destroy(&world->history[idx]);
+    }
+
+    dynamic_array_destroy(&world->pending_free_indices);
+    dynamic_array_destroy(&world->free_indices);
+    dynamic_array_destroy(&world->live_bits);
+
+    arena_deinit(&world->collider_arena);
+    dynamic_array_destroy(&world->render_bounds);
+    dynamic_array_destroy(&world->world_bounds);
+    dynamic_array_destroy(&world->world_colliders);
+
+    dynamic_array_destroy(&world->colliders);
+    dynamic_array_destroy(&world->animators);
+    dynamic_array_destroy(&world->renders);
+    dynamic_array_destroy(&world->transforms);
+    dynamic_array_destroy(&world->prefabs);
+    dynamic_array_destroy(&world->types);
+    dynamic_array_destroy(&world->flags);
+    dynamic_array_destroy(&world->ids);
+
+    arena_deinit(&world->step_arena);
     arena_deinit(&world->arena);
 }
 
+void world_resize(World* world, i32 entity_count)
+{
+    APORIA_ASSERT_WITH_MESSAGE(entity_count >= world->entity_count && entity_count <= world->entity_max_count,
+        "Can't resize the world from % to % entities! Max: % entities", world->entity_count, entity_count, world->entity_max_count);
+
+    dynamic_array_resize(&world->ids, entity_count);
+    dynamic_array_resize(&world->flags, entity_count);
+    dynamic_array_resize(&world->types, entity_count);
+    dynamic_array_resize(&world->prefabs, entity_count);
+    dynamic_array_resize(&world->transforms, entity_count);
+    dynamic_array_resize(&world->renders, entity_count);
+    dynamic_array_resize(&world->animators, entity_count);
+    dynamic_array_resize(&world->colliders, entity_count);
+
+    dynamic_array_resize(&world->world_colliders, entity_count);
+    dynamic_array_resize(&world->world_bounds, entity_count);
+    dynamic_array_resize(&world->render_bounds, entity_count);
+
+    dynamic_array_resize(&world->live_bits, (entity_count + 63) / 64);
+
+    for (i32 idx = 0; idx < world->history_depth; ++idx)
+    {
+        dynamic_array_resize(&world->history[idx], entity_count);
+    }
+
+    for (i32 idx = world->entity_count; idx < entity_count; ++idx)
+    {
+        world->ids.data[idx].index = idx;
+        world->ids.data[idx].generation = 0;
+    }
+
+    world->entity_count = entity_count;
+}
+
 void world_next_frame(World* world)
 {
-    for (i64 idx = 0; idx < world->entity_count; ++idx)
+#if defined(APORIA_DEBUGTOOLS)
+    for (i64 chunk_idx = 0; chunk_idx < world->chunks.count; ++chunk_idx)
+    {
+        APORIA_ASSERT_WITH_MESSAGE(world->chunks.data[chunk_idx].first_command == nullptr,
+            "There are deferred changes left! Call world_apply_deferred_changes before the next frame!");
+    }
+#endif
+
+    arena_clear(&world->step_arena);
+
+    world->history_head = (world->history_head + 1) % world->history_depth;
+    EntitySnapshot* snapshot = world->history[world->history_head].data;
+
+    for (WorldIterator it = world_iterate(world); world_iterator_next(&it);)
+    {
+        i32 idx = it.index;
+
+        entity_flags_unset(&world->flags.data[idx], EntityFlag_SkipInterpolationNextFrame);
+
+        snapshot[idx].transform = world->transforms.data[idx];
+        snapshot[idx].color = world->renders.data[idx].color;
+    }
+
+    for (i64 pending_idx = 0; pending_idx < world->pending_free_indices.count; ++pending_idx)
     {
-        Entity* entity = &world->entity_array[idx];
+        i32 idx = world->pending_free_indices.data[pending_idx];
+        entity_flags_unset(&world->flags.data[idx], EntityFlag_DestroyedThisFrame | EntityFlag_SkipInterpolationNextFrame);
+
+        dynamic_array_push(&world->free_indices, idx);
+    }
+    dynamic_array_clear(&world->pending_free_indices);
+}
 
-        entity_flags_unset(entity, EntityFlag_SkipInterpolationNextFrame);
+void world_rebuild_entity_lists(World* world)
+{
+    memset(world->live_bits.data, 0, world->live_bits.count * sizeof(u64));
+    world->live_count = 0;
+    dynamic_array_clear(&world->free_indices);
+    dynamic_array_clear(&world->pending_free_indices);
 
-        if (entity_flags_has_all(*entity, EntityFlag_DestroyedThisFrame))
+    for (i32 idx = world->entity_count - 1; idx >= 0; --idx)
+    {
+        EntityFlags* flags = &world->flags.data[idx];
+        entity_flags_unset(flags, EntityFlag_DestroyedThisFrame);
+
+        if (entity_flags_has_all(*flags, EntityFlag_Active))
         {
-            entity->next = world->free_list;
-            world->free_list = entity;
+            // @NOTE(dubgron): There are no snapshots to interpolate from yet.
+            entity_flags_set(flags, EntityFlag_SkipInterpolationNextFrame);
 
-            entity_flags_unset(entity, EntityFlag_DestroyedThisFrame);
+            world->live_bits.data[idx / 64] |= 1ull << (idx % 64);
+            world->live_count += 1;
+        }
+        else
+        {
+            dynamic_array_push(&world->free_indices, idx);
         }
     }
 
-    memcpy(world->entity_array_last_frame, world->entity_array, world->entity_count * sizeof(Entity));
+    world_mark_static_entities_changed(world);
 }
 
-EntityID entity_create(World* world, Entity** out_entity)
+void world_mark_static_entities_changed(World* world)
 {
-    Entity* entity = nullptr;
+    world->static_entities_version = last_static_entities_version.fetch_add(1) + 1;
+}
 
-    if (world->free_list)
+const EntitySnapshot* world_get_snapshot(const World* world, i32 steps_ago /* = 0 */)
+{
+    APORIA_ASSERT_WITH_MESSAGE(steps_ago >= 0 && steps_ago < world->history_depth,
+        "Can't get the snapshot from % steps ago! The world keeps only % snapshots!", steps_ago, world->history_depth);
+
+    i32 history_idx = (world->history_head - steps_ago + world->history_depth) % world->history_depth;
+    return world->history[history_idx].data;
+}
+
+WorldIterator world_iterate(const World* world)
+{
+    WorldIterator result;
+    result.world = world;
+    result.word_count = (world->entity_count + 63) / 64;
+    return result;
+}
+
+WorldIterator world_iterate(const WorldChunk* chunk)
+{
+    WorldIterator result;
+    result.world = chunk->world;
+    result.word_idx = chunk->word_begin - 1;
+    result.word_count = chunk->word_end;
+    return result;
+}
+
+bool world_iterator_next(WorldIterator* iterator)
+{
+    while (iterator->bits == 0)
     {
-        entity = world->free_list;
-        world->free_list = world->free_list->next;
+        iterator->word_idx += 1;
+        if (iterator->word_idx >= iterator->word_count)
+        {
+            return false;
+        }
+
+        iterator->bits = iterator->world->live_bits.data[iterator->word_idx];
     }
-    else
+
+    iterator->index = iterator->word_idx * 64 + count_trailing_zeros(iterator->bits);
+    iterator->bits &= iterator->bits - 1;
+
+    return true;
+}
+
+// @NOTE(dubgron): Returns a mask with a bit set for every one of the 64 consecutive flags,
+// for which (flags & mask) == expected.
+static u64 world_match_flags(const EntityFlags* flags, EntityFlags mask, EntityFlags expected)
+{
+    static_assert(sizeof(EntityFlags) == sizeof(u64));
+
+    u64 result = 0;
+
+#if defined(APORIA_SSE2)
+    __m128i mask_lanes = _mm_set1_epi64x(mask);
+    __m128i expected_lanes = _mm_set1_epi64x(expected);
+
+    for (i32 idx = 0; idx < 64; idx += 4)
+    {
+        __m128i flags0 = _mm_loadu_si128((const __m128i*)&flags[idx]);
+        __m128i flags1 = _mm_loadu_si128((const __m128i*)&flags[idx + 2]);
+
+        // @NOTE(dubgron): SSE2 can't compare the 64-bit lanes, so we compare their halves,
+        // and a lane matches only if both of its halves do.
+        __m128i equal0 = _mm_cmpeq_epi32(_mm_and_si128(flags0, mask_lanes), expected_lanes);
+        __m128i equal1 = _mm_cmpeq_epi32(_mm_and_si128(flags1, mask_lanes), expected_lanes);
+        equal0 = _mm_and_si128(equal0, _mm_shuffle_epi32(equal0, _MM_SHUFFLE(2, 3, 0, 1)));
+        equal1 = _mm_and_si128(equal1, _mm_shuffle_epi32(equal1, _MM_SHUFFLE(2, 3, 0, 1)));
+
+        u64 bits = _mm_movemask_pd(_mm_castsi128_pd(equal0)) | (_mm_movemask_pd(_mm_castsi128_pd(equal1)) << 2);
+        result |= bits << idx;
+    }
+#elif defined(APORIA_NEON)
+    uint64x2_t mask_lanes = vdupq_n_u64(mask);
+    uint64x2_t expected_lanes = vdupq_n_u64(expected);
+
+    for (i32 idx = 0; idx < 64; idx += 2)
+    {
+        uint64x2_t equal = vceqq_u64(vandq_u64(vld1q_u64(&flags[idx]), mask_lanes), expected_lanes);
+
+        u64 bits = (vgetq_lane_u64(equal, 0) & 1) | (vgetq_lane_u64(equal, 1) & 2);
+        result |= bits << idx;
+    }
+#else
+    for (i32 idx = 0; idx < 64; ++idx)
+    {
+        result |= (u64)((flags[idx] & mask) == expected) << idx;
+    }
+#endif
+
+    return result;
+}
+
+static WorldQuery world_query_words(MemoryArena* arena, const World* world, i32 word_begin, i32 word_end, i64 max_count,
+    EntityFlags required_flags, EntityFlags excluded_flags)
+{
+    APORIA_ASSERT_WITH_MESSAGE((required_flags & excluded_flags) == 0,
+        "The flags % can't be both required and excluded!", required_flags & excluded_flags);
+
+    WorldQuery result;
+    result.indices = arena_push_uninitialized<i32>(arena, max_count);
+
+    EntityFlags mask = required_flags | excluded_flags;
+
+    // @NOTE(dubgron): The flags past entity_count may not be committed, so the last word,
+    // if it's only partially used, is tested one entity at a time.
+    i32 full_word_count = world->entity_count / 64;
+
+    for (i32 word_idx = word_begin; word_idx < word_end; ++word_idx)
+    {
+        u64 bits = world->live_bits.data[word_idx];
+        if (bits == 0)
+        {
+            continue;
+        }
+
+        const EntityFlags* flags = &world->flags.data[word_idx * 64];
+
+        if (word_idx < full_word_count)
+        {
+            bits &= world_match_flags(flags, mask, required_flags);
+        }
+        else
+        {
+            for (u64 remaining = bits; remaining; remaining &= remaining - 1)
+            {
+                u32 bit = count_trailing_zeros(remaining);
+                if ((flags[bit] & mask) != required_flags)
+                {
+                    bits &= ~(1ull << bit);
+                }
+            }
+        }
+
+        while (bits)
+        {
+            result.indices[result.count] = word_idx * 64 + count_trailing_zeros(bits);
+            result.count += 1;
+            bits &= bits - 1;
+        }
+    }
+
+    arena_pop(arena, (max_count - result.count) * sizeof(i32));
+
+    return result;
+}
+
+WorldQuery world_query(MemoryArena* arena, const World* world, EntityFlags required_flags, EntityFlags excluded_flags /* = EntityFlag_None */)
+{
+    i32 word_count = (world->entity_count + 63) / 64;
+    return world_query_words(arena, world, 0, word_count, world->live_count, required_flags, excluded_flags);
+}
+
+WorldQuery world_query(MemoryArena* arena, const WorldChunk* chunk, EntityFlags required_flags, EntityFlags excluded_flags /* = EntityFlag_None */)
+{
+    return world_query_words(arena, chunk->world, chunk->word_begin, chunk->word_end, chunk->live_count, required_flags, excluded_flags);
+}
+
+static void world_chunk_mark_colliders_dirty(WorldChunk* chunk)
+{
+    World* world = chunk->world;
+
+    for (i32 word_idx = chunk->word_begin; word_idx < chunk->word_end; ++word_idx)
+    {
+        for (u64 bits = world->live_bits.data[word_idx]; bits; bits &= bits - 1)
+        {
+            i32 idx = word_idx * 64 + count_trailing_zeros(bits);
+            entity_flags_set(&world->flags.data[idx], EntityFlag_WorldColliderDirty);
+        }
+    }
+}
+
+void world_run_system(World* world, WorldSystem system, void* user_data, WorldComponents written_components)
+{
+    i32 chunk_count = 0;
+
+    i32 word_count = (world->entity_count + 63) / 64;
+    i32 word_begin = 0;
+    i32 live_count = 0;
+
+    for (i32 word_idx = 0; word_idx < word_count; ++word_idx)
+    {
+        live_count += count_set_bits(world->live_bits.data[word_idx]);
+
+        bool is_last_word = (word_idx == word_count - 1);
+        if (live_count >= WORLD_CHUNK_ENTITY_COUNT || (is_last_word && live_count > 0))
+        {
+            // @NOTE(dubgron): The chunks are reused between the systems and the frames, along
+            // with their arenas. The commands deferred by the previous systems stay in place.
+            if (chunk_count == world->chunks.count)
+            {
+                WorldChunk* new_chunk = dynamic_array_push(&world->chunks);
+                new_chunk->arena = arena_init(WORLD_CHUNK_ARENA_SIZE);
+            }
+
+            WorldChunk* chunk = &world->chunks.data[chunk_count];
+            chunk->world = world;
+            chunk->chunk_index = chunk_count;
+            chunk->word_begin = word_begin;
+            chunk->word_end = word_idx + 1;
+            chunk->live_count = live_count;
+
+            chunk_count += 1;
+            word_begin = word_idx + 1;
+            live_count = 0;
+        }
+    }
+
+    bool writes_colliders = written_components & (WorldComponent_Transform | WorldComponent_Collider);
+
+    parallel_for(chunk_count, 1, [&](i64 begin, i64 end)
+    {
+        for (i64 idx = begin; idx < end; ++idx)
+        {
+            WorldChunk* chunk = &world->chunks.data[idx];
+            system(chunk, user_data);
+
+            // @NOTE(dubgron): The chunk owns the flags of its entities, so they can be set here.
+            if (writes_colliders)
+            {
+                world_chunk_mark_colliders_dirty(chunk);
+            }
+        }
+    });
+}
+
+static void world_activate_entity(World* world, i32 index)
+{
+    EntityID entity_id = world->ids.data[index];
+    entity_store(world, entity_id, Entity{});
+    entity_flags_set(&world->flags.data[index], EntityFlag_Active | EntityFlag_SkipInterpolationNextFrame);
+
+    world->live_bits.data[index / 64] |= 1ull << (index % 64);
+    world->live_count += 1;
+}
+
+void world_apply_deferred_changes(World* world)
+{
+    for (i64 chunk_idx = 0; chunk_idx < world->chunks.count; ++chunk_idx)
     {
-        APORIA_ASSERT_WITH_MESSAGE(world->entity_count < world->entity_max_count,
-            "The entity array is full! Can't create a new Entity!");
+        WorldChunk* chunk = &world->chunks.data[chunk_idx];
+
+        // @NOTE(dubgron): The real ids of the entities created by the chunk, indexed by their
+        // placeholder ids. The Create command of an entity always comes before the commands,
+        // which refer to it, so its id is known by then.
+        EntityID* created_ids = arena_push_uninitialized<EntityID>(&chunk->arena, chunk->created_count);
+
+        for (WorldCommand* command = chunk->first_command; command; command = command->next)
+        {
+            EntityID entity_id = command->entity_id;
+
+            if (entity_id_is_placeholder(entity_id))
+            {
+                APORIA_ASSERT_WITH_MESSAGE(world_placeholder_get_chunk_index(entity_id) == chunk->chunk_index,
+                    "The placeholder id of the chunk % was used by the chunk %!", world_placeholder_get_chunk_index(entity_id), chunk->chunk_index);
+                APORIA_ASSERT(entity_id.index >= 0 && entity_id.index < chunk->created_count);
+
+                if (command->type == WorldCommandType_Create)
+                {
+                    created_ids[entity_id.index] = entity_create(world);
+                }
+                entity_id = created_ids[entity_id.index];
+            }
+
+            // @NOTE(dubgron): The entity could have been destroyed by an earlier command. This
+            // is fine, e.g. more than one system may want to destroy the same entity.
+            if (!entity_is_valid(world, entity_id))
+            {
+                continue;
+            }
+
+            switch (command->type)
+            {
+                case WorldCommandType_Create:
+                {
+                    entity_store(world, entity_id, *world_command_get_payload<Entity>(command));
 
-        entity = &world->entity_array[world->entity_count];
-        world->entity_count += 1;
+                    // @NOTE(dubgron): There's no snapshot of the new entity yet.
+                    entity_flags_set(&world->flags.data[entity_id.index], EntityFlag_SkipInterpolationNextFrame);
+                }
+                break;
 
-        entity->id.index = INDEX_IN_ARRAY(entity, world->entity_array);
-        entity->id.generation = 0;
+                case WorldCommandType_Destroy:
+                {
+                    entity_destroy(world, entity_id);
+                }
+                break;
+
+                case WorldCommandType_Store:
+                {
+                    entity_store(world, entity_id, *world_command_get_payload<Entity>(command));
+                }
+                break;
+
+                case WorldCommandType_SetTransform:
+                {
+                    world->transforms.data[entity_id.index] = *world_command_get_payload<EntityTransform>(command);
+                    entity_flags_set(&world->flags.data[entity_id.index], EntityFlag_WorldColliderDirty);
+
+                    if (entity_flags_has_all(world->flags.data[entity_id.index], EntityFlag_Static))
+                    {
+                        world_mark_static_entities_changed(world);
+                    }
+                }
+                break;
+
+                case WorldCommandType_SetRender:
+                {
+                    world->renders.data[entity_id.index] = *world_command_get_payload<EntityRender>(command);
+
+                    if (entity_flags_has_all(world->flags.data[entity_id.index], EntityFlag_Static))
+                    {
+                        world_mark_static_entities_changed(world);
+                    }
+                }
+                break;
+
+                case WorldCommandType_SetAnimator:
+                {
+                    world->animators.data[entity_id.index] = *world_command_get_payload<Animator>(command);
+
+                    // @NOTE(dubgron): Starting or stopping the animation moves the entity in
+                    // or out of the static batches.
+                    if (entity_flags_has_all(world->flags.data[entity_id.index], EntityFlag_Static))
+                    {
+                        world_mark_static_entities_changed(world);
+                    }
+                }
+                break;
+
+                case WorldCommandType_SetCollider:
+                {
+                    world->colliders.data[entity_id.index] = *world_command_get_payload<Collider>(command);
+                    entity_flags_set(&world->flags.data[entity_id.index], EntityFlag_WorldColliderDirty);
+                }
+                break;
+            }
+        }
+
+        chunk->first_command = nullptr;
+        chunk->last_command = nullptr;
+        chunk->created_count = 0;
+        arena_clear(&chunk->arena);
     }
+}
+
+static WorldCommand* world_chunk_push_command(WorldChunk* chunk, WorldCommandType type, EntityID entity_id, u64 payload_size = 0)
+{
+    WorldCommand* command = (WorldCommand*)arena_push_uninitialized(&chunk->arena, sizeof(WorldCommand) + payload_size);
+    command->type = type;
+    command->entity_id = entity_id;
+    command->next = nullptr;
+
+    if (chunk->last_command)
+    {
+        chunk->last_command->next = command;
+    }
+    else
+    {
+        chunk->first_command = command;
+    }
+    chunk->last_command = command;
+
+    return command;
+}
+
+template<typename T>
+static void world_chunk_push_command(WorldChunk* chunk, WorldCommandType type, EntityID entity_id, const T& payload)
+{
+    WorldCommand* command = world_chunk_push_command(chunk, type, entity_id, sizeof(T));
+    *world_command_get_payload<T>(command) = payload;
+}
+
+EntityID entity_create_deferred(WorldChunk* chunk, const Entity& entity)
+{
+    EntityID entity_id;
+    entity_id.index = chunk->created_count;
+    entity_id.generation = WORLD_PLACEHOLDER_GENERATION - chunk->chunk_index;
+
+    chunk->created_count += 1;
+
+    world_chunk_push_command(chunk, WorldCommandType_Create, entity_id, entity);
+    return entity_id;
+}
+
+void entity_destroy_deferred(WorldChunk* chunk, EntityID entity_id)
+{
+    world_chunk_push_command(chunk, WorldCommandType_Destroy, entity_id);
+}
+
+void entity_store_deferred(WorldChunk* chunk, EntityID entity_id, const Entity& entity)
+{
+    world_chunk_push_command(chunk, WorldCommandType_Store, entity_id, entity);
+}
+
+void entity_set_transform_deferred(WorldChunk* chunk, EntityID entity_id, const EntityTransform& transform)
+{
+    world_chunk_push_command(chunk, WorldCommandType_SetTransform, entity_id, transform);
+}
+
+void entity_set_render_deferred(WorldChunk* chunk, EntityID entity_id, const EntityRender& render)
+{
+    world_chunk_push_command(chunk, WorldCommandType_SetRender, entity_id, render);
+}
 
-    entity_flags_set(entity, EntityFlag_Active);
+void entity_set_animator_deferred(WorldChunk* chunk, EntityID entity_id, const Animator& animator)
+{
+    world_chunk_push_command(chunk, WorldCommandType_SetAnimator, entity_id, animator);
+}
 
-    if (out_entity)
+void entity_set_collider_deferred(WorldChunk* chunk, EntityID entity_id, const Collider& collider)
+{
+    world_chunk_push_command(chunk, WorldCommandType_SetCollider, entity_id, collider);
+}
+
+EntityID entity_create(World* world)
+{
+    i32 index = INDEX_INVALID;
+
+    if (world->free_indices.count > 0)
+    {
+        world->free_indices.count -= 1;
+        index = world->free_indices.data[world->free_indices.count];
+    }
+    else
     {
-        *out_entity = entity;
+        index = world->entity_count;
+        world_resize(world, world->entity_count + 1);
     }
 
-    return entity->id;
+    world_activate_entity(world, index);
+
+    return world->ids.data[index];
 }
 
 void entity_destroy(World* world, EntityID entity_id)
@@ -81,37 +732,258 @@ void entity_destroy(World* world, EntityID entity_id)
     i32 index = entity_id.index;
     i32 generation = entity_id.generation;
 
-    APORIA_ASSERT_WITH_MESSAGE(index >= 0 && index < world->entity_max_count && generation >= 0,
+    APORIA_ASSERT_WITH_MESSAGE(index >= 0 && index < world->entity_count && generation >= 0,
         "Invalid Entity ID (index: %, generation: %)!", index, generation);
 
-    Entity* entity = &world->entity_array[index];
+    EntityID* id = &world->ids.data[index];
+    EntityFlags* flags = &world->flags.data[index];
 
-    APORIA_ASSERT_WITH_MESSAGE(entity->id.generation == generation,
+    APORIA_ASSERT_WITH_MESSAGE(id->generation == generation,
         "Generation mismatch! Tried to remove Entity with ID (index: %, generation: %), but only found ID (index: %, generation: %)!",
-        index, generation, index, entity->id.generation);
+        index, generation, index, id->generation);
 
-    APORIA_ASSERT_WITH_MESSAGE(entity_flags_has_all(*entity, EntityFlag_Active),
+    APORIA_ASSERT_WITH_MESSAGE(entity_flags_has_all(*flags, EntityFlag_Active),
         "Entity with ID (index: %, generation: %) is not alive!", index, generation);
 
-    entity_flags_unset(entity, EntityFlag_Active);
-    entity_flags_set(entity, EntityFlag_DestroyedThisFrame);
+    entity_flags_unset(flags, EntityFlag_Active);
+    entity_flags_set(flags, EntityFlag_DestroyedThisFrame);
+
+    id->generation += 1;
+
+    world->live_bits.data[index / 64] &= ~(1ull << (index % 64));
+    world->live_count -= 1;
 
-    entity->id.generation += 1;
+    if (entity_flags_has_all(*flags, EntityFlag_Static))
+    {
+        world_mark_static_entities_changed(world);
+    }
+
+    Collider* world_collider = &world->world_colliders.data[index];
+    if (world_collider->type == ColliderType_Polygon)
+    {
+        world_collider_points_free(world, world_collider->polygon.points, world_collider->polygon.point_count);
+    }
+    *world_collider = Collider{};
+    world->world_bounds.data[index] = Collider_AABB{};
+    world->render_bounds.data[index] = Collider_AABB{};
+
+    dynamic_array_push(&world->pending_free_indices, index);
 }
 
-Entity* entity_get(World* world, EntityID entity_id)
+bool entity_is_valid(const World* world, EntityID entity_id)
 {
     i32 index = entity_id.index;
     i32 generation = entity_id.generation;
 
-    APORIA_ASSERT_WITH_MESSAGE(index >= 0 && index < world->entity_max_count && generation >= 0,
+    // @NOTE(dubgron): The placeholders and the default ids have a negative generation.
+    if (generation < 0)
+    {
+        return false;
+    }
+
+    APORIA_ASSERT_WITH_MESSAGE(index >= 0 && index < world->entity_count,
         "Invalid EntityID (index: %, generation: %)!", index, generation);
 
-    Entity* entity = &world->entity_array[index];
-    if (entity->id.generation != generation)
+    return world->ids.data[index].generation == generation;
+}
+
+EntityFlags* entity_get_flags(World* world, EntityID entity_id)
+{
+    return entity_is_valid(world, entity_id) ? &world->flags.data[entity_id.index] : nullptr;
+}
+
+EntityTransform* entity_get_transform(World* world, EntityID entity_id)
+{
+    if (!entity_is_valid(world, entity_id))
     {
         return nullptr;
     }
 
-    return entity;
+    // @NOTE(dubgron): The caller may change the transform through the pointer.
+    entity_flags_set(&world->flags.data[entity_id.index], EntityFlag_WorldColliderDirty);
+    return &world->transforms.data[entity_id.index];
+}
+
+EntityRender* entity_get_render(World* world, EntityID entity_id)
+{
+    return entity_is_valid(world, entity_id) ? &world->renders.data[entity_id.index] : nullptr;
+}
+
+Animator* entity_get_animator(World* world, EntityID entity_id)
+{
+    return entity_is_valid(world, entity_id) ? &world->animators.data[entity_id.index] : nullptr;
+}
+
+Collider* entity_get_collider(World* world, EntityID entity_id)
+{
+    if (!entity_is_valid(world, entity_id))
+    {
+        return nullptr;
+    }
+
+    entity_flags_set(&world->flags.data[entity_id.index], EntityFlag_WorldColliderDirty);
+    return &world->colliders.data[entity_id.index];
+}
+
+bool entity_load(const World* world, EntityID entity_id, Entity* out_entity)
+{
+    if (!entity_is_valid(world, entity_id))
+    {
+        return false;
+    }
+
+    i32 index = entity_id.index;
+
+    out_entity->id = world->ids.data[index];
+    out_entity->flags = world->flags.data[index] & ~EntityFlag_WorldColliderDirty;
+    out_entity->type = world->types.data[index];
+    out_entity->prefab = world->prefabs.data[index];
+    out_entity->transform = world->transforms.data[index];
+    out_entity->render = world->renders.data[index];
+    out_entity->animator = world->animators.data[index];
+    out_entity->collider = world->colliders.data[index];
+
+    return true;
+}
+
+// @NOTE(dubgron): Overwrites all the components of the entity, except for its id and
+// the flags managed by entity_create and entity_destroy.
+void entity_store(World* world, EntityID entity_id, const Entity& entity)
+{
+    APORIA_ASSERT_WITH_MESSAGE(entity_is_valid(world, entity_id),
+        "Tried to store an Entity with ID (index: %, generation: %), but it has already been destroyed!",
+        entity_id.index, entity_id.generation);
+
+    i32 index = entity_id.index;
+
+    if (entity_flags_has_any(world->flags.data[index] | entity.flags, EntityFlag_Static))
+    {
+        world_mark_static_entities_changed(world);
+    }
+
+    constexpr EntityFlags lifetime_flags = EntityFlag_Active | EntityFlag_DestroyedThisFrame;
+    world->flags.data[index] = (entity.flags & ~lifetime_flags) | (world->flags.data[index] & lifetime_flags) | EntityFlag_WorldColliderDirty;
+    world->types.data[index] = entity.type;
+    world->prefabs.data[index] = entity.prefab;
+    world->transforms.data[index] = entity.transform;
+    world->renders.data[index] = entity.render;
+    world->animators.data[index] = entity.animator;
+    world->colliders.data[index] = entity.collider;
+}
+
+static void world_update_collider(World* world, i32 index)
+{
+    const Collider& collider = world->colliders.data[index];
+    Collider* world_collider = &world->world_colliders.data[index];
+
+    v2* points = nullptr;
+    if (world_collider->type == ColliderType_Polygon)
+    {
+        bool same_class = collider.type == ColliderType_Polygon
+            && world_collider_points_get_class(collider.polygon.point_count) == world_collider_points_get_class(world_collider->polygon.point_count);
+
+        if (same_class)
+        {
+            points = world_collider->polygon.points;
+        }
+        else
+        {
+            world_collider_points_free(world, world_collider->polygon.points, world_collider->polygon.point_count);
+        }
+    }
+
+    if (collider.type == ColliderType_Polygon && !points)
+    {
+        points = world_collider_points_alloc(world, collider.polygon.point_count);
+    }
+
+    *world_collider = entity_collider_from_local_to_world(collider, world->transforms.data[index], points);
+    world->world_bounds.data[index] = collider_get_bounds(*world_collider);
+
+    const EntityTransform& transform = world->transforms.data[index];
+    Collider_AABB render_bounds = entity_transform_get_bounds(transform);
+
+    // @NOTE(dubgron): The entities without the snapshot aren't interpolated.
+    if (!entity_flags_has_all(world->flags.data[index], EntityFlag_SkipInterpolationNextFrame))
+    {
+        const EntitySnapshot& last_frame = world_get_snapshot(world)[index];
+        render_bounds = aabb_union(render_bounds, entity_transform_get_bounds(last_frame.transform));
+    }
+
+    world->render_bounds.data[index] = render_bounds;
+
+    entity_flags_unset(&world->flags.data[index], EntityFlag_WorldColliderDirty);
+}
+
+void world_update_colliders(World* world)
+{
+    ScratchArena temp = scratch_begin();
+    defer { scratch_end(temp); };
+
+    WorldQuery query = world_query(temp.arena, world, EntityFlag_WorldColliderDirty);
+    for (i64 idx = 0; idx < query.count; ++idx)
+    {
+        world_update_collider(world, query.indices[idx]);
+    }
+}
+
+const Collider* entity_get_world_collider(World* world, EntityID entity_id)
+{
+    if (!entity_is_valid(world, entity_id))
+    {
+        return nullptr;
+    }
+
+    i32 index = entity_id.index;
+    if (entity_flags_has_all(world->flags.data[index], EntityFlag_WorldColliderDirty))
+    {
+        world_update_collider(world, index);
+    }
+
+    return &world->world_colliders.data[index];
+}
+
+const Collider_AABB* entity_get_world_bounds(World* world, EntityID entity_id)
+{
+    if (!entity_is_valid(world, entity_id))
+    {
+        return nullptr;
+    }
+
+    i32 index = entity_id.index;
+    if (entity_flags_has_all(world->flags.data[index], EntityFlag_WorldColliderDirty))
+    {
+        world_update_collider(world, index);
+    }
+
+    return &world->world_bounds.data[index];
+}
+
+const Collider_AABB* entity_get_render_bounds(World* world, EntityID entity_id)
+{
+    if (!entity_is_valid(world, entity_id))
+    {
+        return nullptr;
+    }
+
+    i32 index = entity_id.index;
+    if (entity_flags_has_all(world->flags.data[index], EntityFlag_WorldColliderDirty))
+    {
+        world_update_collider(world, index);
+    }
+
+    return &world->render_bounds.data[index];
+}
+
+bool entity_collision_check(World* world, EntityID entity_a, EntityID entity_b)
+{
+    const Collider_AABB* bounds_a = entity_get_world_bounds(world, entity_a);
+    const Collider_AABB* bounds_b = entity_get_world_bounds(world, entity_b);
+
+    if (!bounds_a || !bounds_b || !collision_aabb_to_aabb(*bounds_a, *bounds_b))
+    {
+        return false;
+    }
+
+    return collision_check(world->world_colliders.data[entity_a.index], world->world_colliders.data[entity_b.index]);
 }
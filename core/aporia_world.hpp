@@ -1,28 +1,259 @@
 #pragma once
 
+#include "aporia_dynamic_array.hpp"
 #include "aporia_entity.hpp"
 #include "aporia_memory.hpp"
 
+// @NOTE(dubgron): The world stores the entities as a struct of arrays. Every component
+// has its own array, indexed by EntityID::index, so a loop over the entities touches
+// only the components it actually reads. Use the entity_get_* accessors to reach
+// the components of a single entity, and entity_load/entity_store to copy the whole
+// entity in and out of the world.
+//
+// The arrays are dynamic arrays, so they only reserve the address space for
+// entity_max_count entities and commit the memory page by page as the world grows.
+// The components never move, so the pointers to them stay valid.
+//
+// The world also caches the world-space collider of every entity, together with its
+// bounds and the bounds of its quad, and updates them only after the entity has been
+// flagged with EntityFlag_WorldColliderDirty. The flag is set by the functions which can change the
+// transform or the collider (e.g. entity_get_transform, entity_store or the deferred
+// commands), and by world_run_system for the systems declared to write them. The code
+// which writes to the transforms or the colliders arrays directly has to set it on its own.
+struct WorldChunk;
+
+#if defined(APORIA_EMSCRIPTEN)
+constexpr i32 WORLD_COLLIDER_POINT_CLASS_COUNT = 8;
+#else
+constexpr i32 WORLD_COLLIDER_POINT_CLASS_COUNT = 16;
+#endif
+
 struct World
 {
     MemoryArena arena;
 
-    Entity* entity_array = nullptr;
+    // @NOTE(dubgron): The scratch memory of the simulation of this world, cleared at the
+    // beginning of every fixed step by world_next_frame. The worlds simulated in parallel
+    // must allocate from it instead of memory.frame, which belongs to the main thread.
+    MemoryArena step_arena;
+
+    DynamicArray<EntityID> ids;
+    DynamicArray<EntityFlags> flags;
+    DynamicArray<EntityType> types;
+    DynamicArray<Atom> prefabs;
+    DynamicArray<EntityTransform> transforms;
+    DynamicArray<EntityRender> renders;
+    DynamicArray<Animator> animators;
+    DynamicArray<Collider> colliders;
+
+    DynamicArray<Collider> world_colliders;
+    DynamicArray<Collider_AABB> world_bounds;
+
+    // @NOTE(dubgron): The bounds of the quad of the entity, used to cull the entities outside
+    // of the camera view. They also contain the quad from the last snapshot, so they cover
+    // every transform the entity can be interpolated to.
+    DynamicArray<Collider_AABB> render_bounds;
+
+    // @NOTE(dubgron): The points of the world-space polygons. They're pooled in classes of
+    // power-of-two point counts, each with its own free list, so a polygon keeps reusing its
+    // points as long as its point count stays within the same class.
+    MemoryArena collider_arena;
+    v2* free_collider_points[WORLD_COLLIDER_POINT_CLASS_COUNT] = {};
+
     i32 entity_max_count = 0;
     i32 entity_count = 0;
 
-    Entity* free_list = nullptr;
+    // @NOTE(dubgron): One bit per entity, set while the entity is active. The loops over
+    // the entities should go through a WorldIterator, which skips the empty words, so their
+    // cost scales with the number of active entities and not with the highest index ever
+    // used, while still visiting the entities in order.
+    DynamicArray<u64> live_bits;
+    i32 live_count = 0;
+
+    // @NOTE(dubgron): Stacks of the indices of the destroyed entities. The entities destroyed
+    // this frame wait on the pending_free_indices until the next frame.
+    DynamicArray<i32> free_indices;
+    DynamicArray<i32> pending_free_indices;
+
+    // @NOTE(dubgron): A ring buffer of the snapshots of the active entities, taken at the
+    // beginning of each of the last history_depth fixed steps. Every snapshot has a slot
+    // for each entity, indexed by EntityID::index. The snapshots taken before an entity
+    // was created are undefined, so new entities skip the interpolation on their first
+    // frame.
+    DynamicArray<EntitySnapshot>* history = nullptr;
+    i32 history_depth = 0;
+    i32 history_head = 0;
 
-    Entity* entity_array_last_frame = nullptr;
+    // @NOTE(dubgron): The chunks used by world_run_system. They keep their arenas and
+    // deferred commands until world_apply_deferred_changes.
+    DynamicArray<WorldChunk> chunks;
+
+    // @NOTE(dubgron): Changes whenever a static entity is created, destroyed or modified by
+    // entity_store or the deferred commands, and is unique across all the worlds. The code
+    // which modifies a static entity through the pointers from entity_get_* has to call
+    // world_mark_static_entities_changed on its own.
+    u64 static_entities_version = 0;
 };
 
 extern World current_world;
 
-World world_init(i32 max_entities = 10000);
+World world_init(i32 history_depth = 1);
 void world_deinit(World* world);
 
+// @NOTE(dubgron): Grows the arrays, so they fit entity_count entities. The new entities
+// aren't active until they're added to the live bits (see world_rebuild_entity_lists).
+void world_resize(World* world, i32 entity_count);
+
 void world_next_frame(World* world);
+void world_rebuild_entity_lists(World* world);
+
+void world_mark_static_entities_changed(World* world);
+
+// @NOTE(dubgron): Returns the snapshot taken steps_ago fixed steps before the last one,
+// e.g. 0 is the state from the beginning of the current fixed step.
+const EntitySnapshot* world_get_snapshot(const World* world, i32 steps_ago = 0);
+
+struct WorldIterator
+{
+    const World* world = nullptr;
+
+    u64 bits = 0;
+    i32 word_idx = INDEX_INVALID;
+    i32 word_count = 0;
+
+    i32 index = INDEX_INVALID;
+};
+
+// @NOTE(dubgron): Visits the indices of all active entities, e.g.:
+//     for (WorldIterator it = world_iterate(world); world_iterator_next(&it);)
+//     {
+//         EntityTransform* transform = &world->transforms.data[it.index];
+//     }
+WorldIterator world_iterate(const World* world);
+WorldIterator world_iterate(const WorldChunk* chunk);
+bool world_iterator_next(WorldIterator* iterator);
+
+// @NOTE(dubgron): The indices of the active entities, which have all of the required flags
+// and none of the excluded flags, in the increasing order, e.g.:
+//     WorldQuery query = world_query(arena, world, EntityFlag_Visible);
+//     for (i64 idx = 0; idx < query.count; ++idx)
+//     {
+//         EntityTransform* transform = &world->transforms.data[query.indices[idx]];
+//     }
+struct WorldQuery
+{
+    i32* indices = nullptr;
+    i64 count = 0;
+};
+
+// @NOTE(dubgron): The flags column is tested with SIMD, a few entities at a time, and the
+// words of the live bits without any active entities are skipped as a whole.
+WorldQuery world_query(MemoryArena* arena, const World* world, EntityFlags required_flags, EntityFlags excluded_flags = EntityFlag_None);
+WorldQuery world_query(MemoryArena* arena, const WorldChunk* chunk, EntityFlags required_flags, EntityFlags excluded_flags = EntityFlag_None);
 
-EntityID entity_create(World* world, Entity** out_entity = nullptr);
+struct WorldCommand;
+
+// @NOTE(dubgron): A range of consecutive entity indices, sized so that a system working
+// on it stays within the cache. The chunks are split at the words of the live bits, so
+// two chunks never share a cache line of any component array.
+struct WorldChunk
+{
+    World* world = nullptr;
+    i32 chunk_index = 0;
+
+    i32 word_begin = 0;
+    i32 word_end = 0;
+    i32 live_count = 0;
+
+    // @NOTE(dubgron): Cleared in world_apply_deferred_changes, so the allocations live until
+    // the end of the current step.
+    MemoryArena arena;
+
+    WorldCommand* first_command = nullptr;
+    WorldCommand* last_command = nullptr;
+
+    // @NOTE(dubgron): The number of entities created with entity_create_deferred since the
+    // last world_apply_deferred_changes. It's the index of the next placeholder id.
+    i32 created_count = 0;
+};
+
+// @NOTE(dubgron): A system may freely read and write the components of the entities in its
+// own chunk, and read the components of the rest of the world, as long as no other system
+// writes them at the same time. It must not create nor destroy the entities directly, nor
+// write to the components outside of its chunk. It should use the *_deferred functions
+// instead, which record the changes in the command buffer of the chunk.
+using WorldSystem = void(*)(WorldChunk* chunk, void* user_data);
+
+// @NOTE(dubgron): The components, which a system is allowed to write. They're declared up
+// front, so world_run_system can keep the caches of the world in sync with them.
+using WorldComponents = u32;
+enum WorldComponent_ : WorldComponents
+{
+    WorldComponent_None         = 0x00,
+
+    WorldComponent_Transform    = 0x01,
+    WorldComponent_Render       = 0x02,
+    WorldComponent_Animator     = 0x04,
+    WorldComponent_Collider     = 0x08,
+};
+
+// @NOTE(dubgron): Runs the system on every chunk of the world, spreading the chunks across
+// the job threads, and returns when all of them are done. The chunks depend only on which
+// entities are alive, and the deferred changes are applied in the order of the chunks, so
+// the result doesn't depend on the number of threads.
+//
+// If the system writes the transforms or the colliders, every live entity of its chunk is
+// flagged with EntityFlag_WorldColliderDirty once the system is done with the chunk.
+void world_run_system(World* world, WorldSystem system, void* user_data, WorldComponents written_components);
+
+// @NOTE(dubgron): The merge point of the parallel update. Plays back the command buffers, one
+// chunk after another and in the order the commands were recorded within a chunk, and clears
+// the chunk arenas. The deferred entities get their real ids here, in that same order, so the
+// ids don't depend on which thread ran which chunk. The commands which refer to the entities
+// destroyed in the meantime are skipped. Call it on the thread which runs the world (usually
+// the main one) after all systems of a step have finished, before the next world_next_frame.
+void world_apply_deferred_changes(World* world);
+
+// @NOTE(dubgron): Returns a placeholder id, local to the chunk, which is replaced with the real
+// id of the entity in world_apply_deferred_changes. It may only be passed to the other deferred
+// commands of the same chunk, before the changes are applied. It can't be stored in the
+// components, nor used with any other function of the world (entity_is_valid returns false
+// for it, and entity_destroy fails an assertion).
+EntityID entity_create_deferred(WorldChunk* chunk, const Entity& entity);
+void entity_destroy_deferred(WorldChunk* chunk, EntityID entity_id);
+
+void entity_store_deferred(WorldChunk* chunk, EntityID entity_id, const Entity& entity);
+void entity_set_transform_deferred(WorldChunk* chunk, EntityID entity_id, const EntityTransform& transform);
+void entity_set_render_deferred(WorldChunk* chunk, EntityID entity_id, const EntityRender& render);
+void entity_set_animator_deferred(WorldChunk* chunk, EntityID entity_id, const Animator& animator);
+void entity_set_collider_deferred(WorldChunk* chunk, EntityID entity_id, const Collider& collider);
+
+EntityID entity_create(World* world);
 void entity_destroy(World* world, EntityID entity_id);
-Entity* entity_get(World* world, EntityID entity_id);
+bool entity_is_valid(const World* world, EntityID entity_id);
+
+// @NOTE(dubgron): The accessors return nullptr, if the entity has already been destroyed.
+EntityFlags* entity_get_flags(World* world, EntityID entity_id);
+EntityTransform* entity_get_transform(World* world, EntityID entity_id);
+EntityRender* entity_get_render(World* world, EntityID entity_id);
+Animator* entity_get_animator(World* world, EntityID entity_id);
+Collider* entity_get_collider(World* world, EntityID entity_id);
+
+bool entity_load(const World* world, EntityID entity_id, Entity* out_entity);
+void entity_store(World* world, EntityID entity_id, const Entity& entity);
+
+// @NOTE(dubgron): Brings the cached world-space colliders and bounds of all dirty entities
+// up to date. After this call, the world_colliders, world_bounds and render_bounds arrays
+// can be read from many threads at once, as long as nothing flags the entities as dirty
+// in the meantime.
+void world_update_colliders(World* world);
+
+// @NOTE(dubgron): Update the cached collider of the entity first, if it's dirty, so they
+// may only be called on the thread which runs the world. Return nullptr, if the entity has
+// already been destroyed.
+const Collider* entity_get_world_collider(World* world, EntityID entity_id);
+const Collider_AABB* entity_get_world_bounds(World* world, EntityID entity_id);
+const Collider_AABB* entity_get_render_bounds(World* world, EntityID entity_id);
+
+// @NOTE(dubgron): Tests the bounds of the entities first, and only then their colliders.
+bool entity_collision_check(World* world, EntityID entity_a, EntityID entity_b);
@@ -0,0 +1,244 @@
+#include "aporia_benchmarks.hpp"
+
+#include "aporia_debug.hpp"
+#include "aporia_game.hpp"
+#include "aporia_hash_table.hpp"
+#include "aporia_parser.hpp"
+
+// @NOTE(dubgron): The byte-at-a-time FNV-1a, which 'get_hash' used before, kept as the reference.
+static u32 reference_fnv1a_hash(String string)
+{
+    u64 hash = 0xcbf29ce484222325;
+    for (u64 idx = 0; idx < string.length; ++idx)
+    {
+        hash ^= string.data[idx];
+        hash *= 0x100000001b3;
+    }
+    return (u32)hash;
+}
+
+static_assert(hash_literal("u_vp_matrix") == hash_bytes("u_vp_matrix", 11));
+
+struct HashKeySet
+{
+    String name;
+
+    String* keys = nullptr;
+    i64 count = 0;
+    i64 max_count = 0;
+
+    HashTable<bool> unique_keys;
+};
+
+static HashKeySet hash_key_set_create(String name, i64 max_count)
+{
+    HashKeySet result;
+    result.name = name;
+    result.keys = arena_push<String>(&memory.frame, max_count);
+    result.max_count = max_count;
+    result.unique_keys = hash_table_create<bool>(&memory.frame, MIN_BUCKET_COUNT);
+    return result;
+}
+
+static void hash_key_set_add(HashKeySet* key_set, String key)
+{
+    if (key.is_empty() || key_set->count >= key_set->max_count || hash_table_find(&key_set->unique_keys, key))
+    {
+        return;
+    }
+
+    hash_table_insert(&key_set->unique_keys, key, true);
+    key_set->keys[key_set->count] = key;
+    key_set->count += 1;
+}
+
+// @NOTE(dubgron): Adds the names of the categories, the fields and the structs.
+static void hash_key_set_add_parse_tree(HashKeySet* key_set, ParseTreeNode* node)
+{
+    for (ParseTreeNode* child = node->child_first; child; child = child->next)
+    {
+        switch (child->type)
+        {
+            case ParseTreeNode_Category:
+            case ParseTreeNode_Field:
+            case ParseTreeNode_Struct:
+            case ParseTreeNode_ArrayOfStructs:
+            {
+                hash_key_set_add(key_set, child->name);
+                hash_key_set_add_parse_tree(key_set, child);
+            }
+            break;
+
+            default: break;
+        }
+    }
+}
+
+// @NOTE(dubgron): Picks the names out of the lines like 'uniform sampler2D u_atlas[32];'.
+static void hash_key_set_add_uniforms(HashKeySet* key_set, String shader_filepath)
+{
+    String contents = read_entire_file(&memory.frame, shader_filepath);
+
+    StringList lines = contents.split(&memory.frame, '\n');
+    for (StringNode* line = lines.first; line; line = line->next)
+    {
+        String trimmed = line->string.trim().trim('\r');
+        if (!trimmed.starts_with("uniform "))
+        {
+            continue;
+        }
+
+        StringList tokens = trimmed.split(&memory.frame, ' ');
+        if (tokens.node_count < 3)
+        {
+            continue;
+        }
+
+        String uniform_name = tokens.first->next->next->string;
+        uniform_name = uniform_name.substr(0, min(uniform_name.find(';'), uniform_name.find('[')));
+        hash_key_set_add(key_set, uniform_name);
+    }
+}
+
+static i64 count_hash_collisions(u32 (*hash_function)(String), const HashKeySet& key_set, i64 bucket_count, i64* out_bucket_collisions)
+{
+    u64* hashes = arena_push_uninitialized<u64>(&memory.frame, key_set.count);
+    u32* indices = arena_push_uninitialized<u32>(&memory.frame, key_set.count);
+    u64* temp_hashes = arena_push_uninitialized<u64>(&memory.frame, key_set.count);
+    u32* temp_indices = arena_push_uninitialized<u32>(&memory.frame, key_set.count);
+
+    for (i64 idx = 0; idx < key_set.count; ++idx)
+    {
+        hashes[idx] = hash_function(key_set.keys[idx]);
+        indices[idx] = idx;
+    }
+
+    // @NOTE(dubgron): Counts the keys, which land in an already taken bucket of a table with
+    // bucket_count buckets. It shows how well the low bits of the hash are distributed.
+    bool* bucket_taken = arena_push<bool>(&memory.frame, bucket_count);
+    *out_bucket_collisions = 0;
+    for (i64 idx = 0; idx < key_set.count; ++idx)
+    {
+        i64 bucket = hashes[idx] & (bucket_count - 1);
+        *out_bucket_collisions += bucket_taken[bucket];
+        bucket_taken[bucket] = true;
+    }
+
+    radix_sort(hashes, indices, key_set.count, temp_hashes, temp_indices);
+
+    i64 collisions = 0;
+    for (i64 idx = 1; idx < key_set.count; ++idx)
+    {
+        collisions += hashes[idx] == hashes[idx - 1];
+    }
+    return collisions;
+}
+
+static constexpr i64 HASH_COUNT_PER_MEASUREMENT = 20000000;
+
+static f32 measure_hash_function(u32 (*hash_function)(String), const HashKeySet& key_set)
+{
+    i64 repeat_count = HASH_COUNT_PER_MEASUREMENT / key_set.count + 1;
+
+    Timer timer;
+    for (i64 repeat_idx = 0; repeat_idx < repeat_count; ++repeat_idx)
+    {
+        for (i64 idx = 0; idx < key_set.count; ++idx)
+        {
+            benchmark_sink += hash_function(key_set.keys[idx]);
+        }
+    }
+    return benchmark_nanoseconds(timer) / (repeat_count * key_set.count);
+}
+
+void benchmark_hash()
+{
+    APORIA_ASSERT(get_hash("u_vp_matrix") == hash_literal("u_vp_matrix"));
+
+    HashKeySet key_sets[4];
+
+    // @NOTE(dubgron): These are the keys the engine actually uses, read from the content
+    // directory. The benchmark has to be run from the 'bin' directory to find them.
+    key_sets[0] = hash_key_set_create("config keys and uniform names", 1024);
+    if (ParseTreeNode* config = parse_from_file(&memory.frame, "content/settings.aporia-config"))
+    {
+        hash_key_set_add_parse_tree(&key_sets[0], config);
+    }
+
+    const CString shader_filepaths[] = {
+        "content/shaders/circle.glsl",
+        "content/shaders/default.glsl",
+        "content/shaders/font.glsl",
+        "content/shaders/line.glsl",
+        "content/shaders/postprocessing.glsl",
+        "content/shaders/raycasting.glsl",
+        "content/shaders/rectangle.glsl",
+        "content/shaders/shadowcasting.glsl",
+        "content/shaders/sprite.glsl",
+        "content/shaders/editor/grid.glsl",
+        "content/shaders/editor/selected.glsl",
+    };
+    for (CString shader_filepath : shader_filepaths)
+    {
+        hash_key_set_add_uniforms(&key_sets[0], shader_filepath);
+    }
+
+    // @NOTE(dubgron): There are no atlases in the repository, so the animation and the
+    // subtexture names are generated to follow the naming of the ones in our games.
+    const CString actions[] = { "idle", "walk", "run", "jump", "fall", "attack", "hurt", "die" };
+    const CString directions[] = { "left", "right", "up", "down" };
+
+    key_sets[1] = hash_key_set_create("animation names", 200 * ARRAY_COUNT(actions) * ARRAY_COUNT(directions));
+    for (i64 character_idx = 0; character_idx < 200; ++character_idx)
+    {
+        for (CString action : actions)
+        {
+            for (CString direction : directions)
+            {
+                hash_key_set_add(&key_sets[1], sprintf(&memory.frame, "character_%/%_%", character_idx, action, direction));
+            }
+        }
+    }
+
+    key_sets[2] = hash_key_set_create("subtexture names", 100000);
+    for (i64 idx = 0; idx < key_sets[2].max_count; ++idx)
+    {
+        hash_key_set_add(&key_sets[2], sprintf(&memory.frame, "atlas_%/sprite_%_frame_%", idx / 512, idx % 512, idx % 7));
+    }
+
+    key_sets[3] = hash_key_set_create("short names", 10000);
+    for (i64 idx = 0; idx < key_sets[3].max_count; ++idx)
+    {
+        hash_key_set_add(&key_sets[3], sprintf(&memory.frame, "e%", idx));
+    }
+
+    for (const HashKeySet& key_set : key_sets)
+    {
+        if (key_set.count == 0)
+        {
+            APORIA_LOG(Warning, "No % found, skipping them!", key_set.name);
+            continue;
+        }
+
+        u64 total_length = 0;
+        for (i64 idx = 0; idx < key_set.count; ++idx)
+        {
+            total_length += key_set.keys[idx].length;
+        }
+
+        // @NOTE(dubgron): The table is sized like a HashTable holding these keys would be.
+        i64 bucket_count = next_power_of_two(key_set.count * 2);
+
+        i64 bucket_collisions = 0;
+        i64 reference_bucket_collisions = 0;
+        i64 collisions = count_hash_collisions(get_hash, key_set, bucket_count, &bucket_collisions);
+        i64 reference_collisions = count_hash_collisions(reference_fnv1a_hash, key_set, bucket_count, &reference_bucket_collisions);
+
+        f32 hash_ns = measure_hash_function(get_hash, key_set);
+        f32 reference_hash_ns = measure_hash_function(reference_fnv1a_hash, key_set);
+
+        APORIA_LOG(Info, "% (% keys, % B on average): % ns per hash (FNV-1a % ns), 32-bit collisions % (FNV-1a %), bucket collisions in % buckets % (FNV-1a %)",
+            key_set.name, key_set.count, (f32)total_length / key_set.count, hash_ns, reference_hash_ns,
+            collisions, reference_collisions, bucket_count, bucket_collisions, reference_bucket_collisions);
+    }
+}
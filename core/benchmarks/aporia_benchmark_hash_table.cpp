@@ -0,0 +1,182 @@
+#include "aporia_benchmarks.hpp"
+
+#include "aporia_debug.hpp"
+#include "aporia_game.hpp"
+#include "aporia_hash_table.hpp"
+#include "aporia_textures.hpp"
+
+// @NOTE(dubgron): The hash table from before the group probing, kept as the reference. It
+// stores the hash, the key and the value in the same bucket, and probes quadratically one
+// bucket at a time. Only the parts needed by the benchmark are kept.
+template<typename T>
+struct ReferenceHashTable
+{
+    struct Bucket
+    {
+        i64 hash = -1;
+        String key;
+        T value;
+    };
+
+    MemoryArena* arena = nullptr;
+
+    Bucket* buckets = nullptr;
+    i64 bucket_count = 0;
+    i64 valid_buckets = 0;
+};
+
+template<typename T>
+static ReferenceHashTable<T> reference_hash_table_create(MemoryArena* arena, i64 bucket_count)
+{
+    ReferenceHashTable<T> result;
+    result.arena = arena;
+    result.buckets = arena_push<typename ReferenceHashTable<T>::Bucket>(arena, bucket_count);
+    result.bucket_count = bucket_count;
+    return result;
+}
+
+template<typename T>
+static void reference_hash_table_insert(ReferenceHashTable<T>* hash_table, String key, T value)
+{
+    if ((hash_table->valid_buckets + 1) * 100 > MAX_LOAD_FACTOR_PERCENT * hash_table->bucket_count)
+    {
+        ReferenceHashTable<T> old_table = *hash_table;
+        *hash_table = reference_hash_table_create<T>(hash_table->arena, old_table.bucket_count * 2);
+
+        for (i64 idx = 0; idx < old_table.bucket_count; ++idx)
+        {
+            if (old_table.buckets[idx].hash >= 0)
+            {
+                reference_hash_table_insert(hash_table, old_table.buckets[idx].key, old_table.buckets[idx].value);
+            }
+        }
+    }
+
+    u32 hash = get_hash(key);
+    i64 index = hash & (hash_table->bucket_count - 1);
+
+    u32 probe_increment = 1;
+    while (hash_table->buckets[index].hash >= 0)
+    {
+        index = (index + probe_increment) & (hash_table->bucket_count - 1);
+        probe_increment += 1;
+    }
+
+    hash_table->buckets[index].hash = hash;
+    hash_table->buckets[index].key = key;
+    hash_table->buckets[index].value = value;
+    hash_table->valid_buckets += 1;
+}
+
+template<typename T>
+static T* reference_hash_table_find(ReferenceHashTable<T>* hash_table, String key)
+{
+    u32 hash = get_hash(key);
+    i64 index = hash & (hash_table->bucket_count - 1);
+
+    u32 probe_increment = 1;
+    while (hash_table->buckets[index].hash != hash || hash_table->buckets[index].key != key)
+    {
+        if (hash_table->buckets[index].hash == -1)
+        {
+            return nullptr;
+        }
+
+        index = (index + probe_increment) & (hash_table->bucket_count - 1);
+        probe_increment += 1;
+    }
+
+    return &hash_table->buckets[index].value;
+}
+
+static constexpr i64 HASH_TABLE_LOOKUP_COUNT = 2000000;
+
+// @NOTE(dubgron): The keys are visited with a large odd stride, so the lookups jump around
+// the table like the per-entity lookups do, instead of walking it in order.
+static i64 lookup_key_index(i64 lookup_idx, i64 key_count)
+{
+    return (lookup_idx * 7919) % key_count;
+}
+
+void benchmark_hash_table()
+{
+    const i64 key_counts[] = { 1000, 10000, 100000 };
+    const i64 max_key_count = key_counts[ARRAY_COUNT(key_counts) - 1];
+
+    // @NOTE(dubgron): The keys are shaped like the names of the subtextures in our atlases.
+    String* keys = arena_push<String>(&memory.frame, max_key_count);
+    String* missing_keys = arena_push<String>(&memory.frame, max_key_count);
+    for (i64 idx = 0; idx < max_key_count; ++idx)
+    {
+        keys[idx] = sprintf(&memory.frame, "sprites/atlas_%/frame_%", idx / 512, idx % 512);
+        missing_keys[idx] = sprintf(&memory.frame, "sprites/missing_%/frame_%", idx / 512, idx % 512);
+    }
+
+    for (i64 key_count : key_counts)
+    {
+        MemoryArena arena = arena_init(GIGABYTES(1));
+        MemoryArena reference_arena = arena_init(GIGABYTES(1));
+        defer { arena_deinit(&arena); arena_deinit(&reference_arena); };
+
+        HashTable<SubTexture> hash_table = hash_table_create<SubTexture>(&arena, MIN_BUCKET_COUNT);
+        ReferenceHashTable<SubTexture> reference = reference_hash_table_create<SubTexture>(&reference_arena, MIN_BUCKET_COUNT);
+
+        Timer timer;
+        for (i64 idx = 0; idx < key_count; ++idx)
+        {
+            SubTexture subtexture;
+            subtexture.texture_index = idx;
+            hash_table_insert(&hash_table, keys[idx], subtexture);
+        }
+        f32 insert_ns = benchmark_nanoseconds(timer) / key_count;
+
+        timer.reset();
+        for (i64 idx = 0; idx < key_count; ++idx)
+        {
+            SubTexture subtexture;
+            subtexture.texture_index = idx;
+            reference_hash_table_insert(&reference, keys[idx], subtexture);
+        }
+        f32 reference_insert_ns = benchmark_nanoseconds(timer) / key_count;
+
+        bool results_match = true;
+        for (i64 idx = 0; idx < key_count; ++idx)
+        {
+            SubTexture* found = hash_table_find(&hash_table, keys[idx]);
+            results_match &= found && found->texture_index == idx;
+            results_match &= hash_table_find(&hash_table, missing_keys[idx]) == nullptr;
+        }
+        APORIA_ASSERT(results_match);
+
+        timer.reset();
+        for (i64 lookup_idx = 0; lookup_idx < HASH_TABLE_LOOKUP_COUNT; ++lookup_idx)
+        {
+            benchmark_sink += hash_table_find(&hash_table, keys[lookup_key_index(lookup_idx, key_count)])->texture_index;
+        }
+        f32 hit_ns = benchmark_nanoseconds(timer) / HASH_TABLE_LOOKUP_COUNT;
+
+        timer.reset();
+        for (i64 lookup_idx = 0; lookup_idx < HASH_TABLE_LOOKUP_COUNT; ++lookup_idx)
+        {
+            benchmark_sink += reference_hash_table_find(&reference, keys[lookup_key_index(lookup_idx, key_count)])->texture_index;
+        }
+        f32 reference_hit_ns = benchmark_nanoseconds(timer) / HASH_TABLE_LOOKUP_COUNT;
+
+        timer.reset();
+        for (i64 lookup_idx = 0; lookup_idx < HASH_TABLE_LOOKUP_COUNT; ++lookup_idx)
+        {
+            benchmark_sink += hash_table_find(&hash_table, missing_keys[lookup_key_index(lookup_idx, key_count)]) != nullptr;
+        }
+        f32 miss_ns = benchmark_nanoseconds(timer) / HASH_TABLE_LOOKUP_COUNT;
+
+        timer.reset();
+        for (i64 lookup_idx = 0; lookup_idx < HASH_TABLE_LOOKUP_COUNT; ++lookup_idx)
+        {
+            benchmark_sink += reference_hash_table_find(&reference, missing_keys[lookup_key_index(lookup_idx, key_count)]) != nullptr;
+        }
+        f32 reference_miss_ns = benchmark_nanoseconds(timer) / HASH_TABLE_LOOKUP_COUNT;
+
+        APORIA_LOG(Info, "% keys: insert % ns (reference % ns), hit % ns (reference % ns), miss % ns (reference % ns)",
+            key_count, insert_ns, reference_insert_ns, hit_ns, reference_hit_ns, miss_ns, reference_miss_ns);
+    }
+}
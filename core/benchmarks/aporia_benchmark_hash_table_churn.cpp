@@ -0,0 +1,62 @@
+#include "aporia_benchmarks.hpp"
+
+#include "aporia_debug.hpp"
+#include "aporia_game.hpp"
+#include "aporia_hash_table.hpp"
+
+static constexpr i64 HASH_TABLE_CHURN_OPERATION_COUNT = 1000000;
+
+// @NOTE(dubgron): Keeps the number of keys in the table constant, while removing the oldest
+// key and inserting a new one, like the tables of the hot-reloaded assets do. The removed
+// buckets have to be reclaimed by the rehash, otherwise the table would keep on growing.
+void benchmark_hash_table_churn()
+{
+    const i64 live_key_counts[] = { 1000, 10000, 100000 };
+    const i64 max_key_count = live_key_counts[ARRAY_COUNT(live_key_counts) - 1] + HASH_TABLE_CHURN_OPERATION_COUNT;
+
+    String* keys = arena_push<String>(&memory.frame, max_key_count);
+    for (i64 idx = 0; idx < max_key_count; ++idx)
+    {
+        keys[idx] = sprintf(&memory.frame, "animations/bullet_%", idx);
+    }
+
+    for (i64 live_key_count : live_key_counts)
+    {
+        MemoryArena arena = arena_init(GIGABYTES(1));
+        defer { arena_deinit(&arena); };
+
+        HashTable<i64> hash_table = hash_table_create<i64>(&arena, MIN_BUCKET_COUNT);
+        for (i64 idx = 0; idx < live_key_count; ++idx)
+        {
+            hash_table_insert(&hash_table, keys[idx], idx);
+        }
+
+        i64 bucket_count_before = hash_table.bucket_count;
+        u64 arena_pos_before = arena.pos;
+        i64 rehash_count = 0;
+
+        Timer timer;
+        for (i64 op_idx = 0; op_idx < HASH_TABLE_CHURN_OPERATION_COUNT; ++op_idx)
+        {
+            benchmark_sink += hash_table_remove(&hash_table, keys[op_idx]);
+
+            i64 occupied_before = hash_table.occupied_buckets;
+            hash_table_insert(&hash_table, keys[live_key_count + op_idx], live_key_count + op_idx);
+            rehash_count += hash_table.occupied_buckets < occupied_before;
+        }
+        f32 operation_ns = benchmark_nanoseconds(timer) / HASH_TABLE_CHURN_OPERATION_COUNT;
+
+        bool results_match = hash_table.valid_buckets == live_key_count;
+        for (i64 idx = 0; idx < live_key_count; ++idx)
+        {
+            i64 key_idx = HASH_TABLE_CHURN_OPERATION_COUNT + idx;
+            i64* found = hash_table_find(&hash_table, keys[key_idx]);
+            results_match &= found && *found == key_idx;
+        }
+        APORIA_ASSERT(results_match);
+
+        APORIA_LOG(Info, "% live keys, % removes and inserts: % ns per pair, % rehashes, buckets % -> %, arena % B -> % B",
+            live_key_count, HASH_TABLE_CHURN_OPERATION_COUNT, operation_ns, rehash_count,
+            bucket_count_before, hash_table.bucket_count, arena_pos_before, arena.pos);
+    }
+}
@@ -0,0 +1,102 @@
+#include "aporia_benchmarks.hpp"
+
+#include "aporia_debug.hpp"
+#include "aporia_game.hpp"
+#include "aporia_world.hpp"
+
+static constexpr i32 WORLD_CHURN_FRAME_COUNT = 600;
+static constexpr i32 WORLD_CHURN_LIVE_COUNT = 10000;
+
+// @NOTE(dubgron): 10000 bullets spawned and destroyed per second, at 60 frames per second.
+static constexpr i32 WORLD_CHURN_SPAWNS_PER_FRAME = 10000 / 60;
+
+static void world_churn_destroy_random(World* world, EntityID* live_ids, i32* live_count)
+{
+    i32 idx = random_range(0, *live_count - 1);
+    entity_destroy(world, live_ids[idx]);
+
+    *live_count -= 1;
+    live_ids[idx] = live_ids[*live_count];
+}
+
+// @NOTE(dubgron): Spawns the world up to the peak entity count, destroys the entities down
+// to the steady live count, and then keeps on spawning and destroying bullets. It compares
+// the loop over every index up to entity_count, which tests EntityFlag_Active on each of
+// them, against the WorldIterator, which skips the words of the dead entities.
+void benchmark_world_churn()
+{
+    const i32 peak_entity_counts[] = { 20000, 100000 };
+
+    for (i32 peak_entity_count : peak_entity_counts)
+    {
+        World world = world_init();
+        defer { world_deinit(&world); };
+
+        EntityID* live_ids = arena_push<EntityID>(&memory.frame, peak_entity_count);
+        i32 live_count = 0;
+
+        for (i32 idx = 0; idx < peak_entity_count; ++idx)
+        {
+            live_ids[live_count] = entity_create(&world);
+            live_count += 1;
+        }
+
+        while (live_count > WORLD_CHURN_LIVE_COUNT)
+        {
+            world_churn_destroy_random(&world, live_ids, &live_count);
+        }
+
+        world_next_frame(&world);
+
+        f32 churn_ns = 0.f, next_frame_ns = 0.f;
+        f32 iterator_ns = 0.f, scan_ns = 0.f;
+
+        for (i32 frame_idx = 0; frame_idx < WORLD_CHURN_FRAME_COUNT; ++frame_idx)
+        {
+            Timer timer;
+            for (i32 idx = 0; idx < WORLD_CHURN_SPAWNS_PER_FRAME; ++idx)
+            {
+                world_churn_destroy_random(&world, live_ids, &live_count);
+            }
+            for (i32 idx = 0; idx < WORLD_CHURN_SPAWNS_PER_FRAME; ++idx)
+            {
+                live_ids[live_count] = entity_create(&world);
+                live_count += 1;
+            }
+            churn_ns += benchmark_nanoseconds(timer);
+
+            timer.reset();
+            world_next_frame(&world);
+            next_frame_ns += benchmark_nanoseconds(timer);
+
+            timer.reset();
+            for (i32 idx = 0; idx < world.entity_count; ++idx)
+            {
+                if (entity_flags_has_all(world.flags.data[idx], EntityFlag_Active | EntityFlag_Visible))
+                {
+                    world.transforms.data[idx].position.x += 1.f;
+                }
+            }
+            scan_ns += benchmark_nanoseconds(timer);
+
+            timer.reset();
+            for (WorldIterator iterator = world_iterate(&world); world_iterator_next(&iterator);)
+            {
+                if (entity_flags_has_all(world.flags.data[iterator.index], EntityFlag_Visible))
+                {
+                    world.transforms.data[iterator.index].position.x += 1.f;
+                }
+            }
+            iterator_ns += benchmark_nanoseconds(timer);
+        }
+
+        APORIA_ASSERT(world.live_count == live_count);
+
+        const f32 ns_to_us = 0.001f / WORLD_CHURN_FRAME_COUNT;
+        APORIA_LOG(Info, "% live out of % entities, % spawns and destroys per frame: churn % us, next frame % us, loop over every index % us, WorldIterator % us",
+            world.live_count, world.entity_count, WORLD_CHURN_SPAWNS_PER_FRAME,
+            churn_ns * ns_to_us, next_frame_ns * ns_to_us, scan_ns * ns_to_us, iterator_ns * ns_to_us);
+
+        arena_clear(&memory.frame);
+    }
+}
@@ -0,0 +1,158 @@
+#include "aporia_benchmarks.hpp"
+
+#include "aporia_debug.hpp"
+#include "aporia_entity.hpp"
+#include "aporia_game.hpp"
+#include "aporia_world.hpp"
+
+static constexpr i32 WORLD_COLLIDERS_ENTITY_COUNT = 5000;
+static constexpr i32 WORLD_COLLIDERS_ROW_LENGTH = 100;
+static constexpr i32 WORLD_COLLIDERS_FRAME_COUNT = 100;
+
+// @NOTE(dubgron): Every entity is tested against that many of the next entities, so every
+// frame runs N×M collision checks, similarly to the gameplay code testing the bullets.
+static constexpr i32 WORLD_COLLIDERS_QUERY_COUNT = 4;
+
+static v2 world_colliders_hexagon[6];
+
+enum WorldCollidersMode
+{
+    // @NOTE(dubgron): The cached world colliders, updated once per frame.
+    WorldCollidersMode_Cached,
+
+    // @NOTE(dubgron): The cached world colliders, but every entity is flagged as dirty right
+    // before it's tested, so the collider is recomputed for every check.
+    WorldCollidersMode_ForcedRecompute,
+
+    // @NOTE(dubgron): The world colliders computed into memory.frame for every check, as it
+    // was done before the world cached them.
+    WorldCollidersMode_Reference,
+};
+
+static const char* world_colliders_mode_names[] = {
+    "cached",
+    "forced recompute",
+    "before the cache",
+};
+
+static bool world_colliders_reference_check(World* world, i32 index_a, i32 index_b)
+{
+    Collider collider_a = entity_collider_from_local_to_world(world->colliders.data[index_a], world->transforms.data[index_a]);
+    Collider collider_b = entity_collider_from_local_to_world(world->colliders.data[index_b], world->transforms.data[index_b]);
+
+    return collision_check(collider_a, collider_b);
+}
+
+static void world_colliders_run(WorldCollidersMode mode)
+{
+    World world = world_init();
+    defer { world_deinit(&world); };
+
+    ScratchArena temp = scratch_begin();
+    defer { scratch_end(temp); };
+
+    EntityID* entity_ids = arena_push<EntityID>(temp.arena, WORLD_COLLIDERS_ENTITY_COUNT);
+    for (i32 idx = 0; idx < WORLD_COLLIDERS_ENTITY_COUNT; ++idx)
+    {
+        EntityID entity_id = entity_create(&world);
+        entity_ids[idx] = entity_id;
+
+        EntityTransform* transform = entity_get_transform(&world, entity_id);
+        transform->position = v2{ (f32)(idx % WORLD_COLLIDERS_ROW_LENGTH), (f32)(idx / WORLD_COLLIDERS_ROW_LENGTH) } * 12.f;
+        transform->rotation = idx * 0.1f;
+
+        Collider* collider = entity_get_collider(&world, entity_id);
+        collider->type = ColliderType_Polygon;
+        collider->polygon.point_count = ARRAY_COUNT(world_colliders_hexagon);
+        collider->polygon.points = world_colliders_hexagon;
+    }
+
+    world_update_colliders(&world);
+
+    u64 collider_push_count = arena_get_push_count(&world.collider_arena);
+    u64 frame_push_count = arena_get_push_count(&memory.frame);
+
+    f32 elapsed_ns = 0.f;
+    u64 collision_count = 0;
+
+    for (i32 frame_idx = 0; frame_idx < WORLD_COLLIDERS_FRAME_COUNT; ++frame_idx)
+    {
+        Timer timer;
+
+        for (i32 idx = 0; idx < WORLD_COLLIDERS_ENTITY_COUNT; ++idx)
+        {
+            entity_get_transform(&world, entity_ids[idx])->rotation += 0.05f;
+        }
+
+        if (mode == WorldCollidersMode_Cached)
+        {
+            world_update_colliders(&world);
+        }
+
+        for (i32 idx = 0; idx < WORLD_COLLIDERS_ENTITY_COUNT; ++idx)
+        {
+            for (i32 query_idx = 1; query_idx <= WORLD_COLLIDERS_QUERY_COUNT; ++query_idx)
+            {
+                EntityID entity_a = entity_ids[idx];
+                EntityID entity_b = entity_ids[(idx + query_idx) % WORLD_COLLIDERS_ENTITY_COUNT];
+
+                bool collides = false;
+                switch (mode)
+                {
+                    case WorldCollidersMode_Cached:
+                    {
+                        collides = entity_collision_check(&world, entity_a, entity_b);
+                    }
+                    break;
+
+                    case WorldCollidersMode_ForcedRecompute:
+                    {
+                        entity_flags_set(&world.flags.data[entity_a.index], EntityFlag_WorldColliderDirty);
+                        entity_flags_set(&world.flags.data[entity_b.index], EntityFlag_WorldColliderDirty);
+                        collides = entity_collision_check(&world, entity_a, entity_b);
+                    }
+                    break;
+
+                    case WorldCollidersMode_Reference:
+                    {
+                        collides = world_colliders_reference_check(&world, entity_a.index, entity_b.index);
+                    }
+                    break;
+                }
+
+                collision_count += collides;
+            }
+        }
+
+        elapsed_ns += benchmark_nanoseconds(timer);
+
+        world_next_frame(&world);
+        arena_clear(&memory.frame);
+    }
+
+    benchmark_sink += collision_count;
+
+    collider_push_count = arena_get_push_count(&world.collider_arena) - collider_push_count;
+    frame_push_count = arena_get_push_count(&memory.frame) - frame_push_count;
+
+    APORIA_LOG(Info, "% rotating polygons, % checks per frame, %: % us per frame, % collider arena and % frame arena allocations per frame",
+        WORLD_COLLIDERS_ENTITY_COUNT, WORLD_COLLIDERS_ENTITY_COUNT * WORLD_COLLIDERS_QUERY_COUNT, world_colliders_mode_names[mode],
+        elapsed_ns * 0.001f / WORLD_COLLIDERS_FRAME_COUNT,
+        (f32)collider_push_count / WORLD_COLLIDERS_FRAME_COUNT, (f32)frame_push_count / WORLD_COLLIDERS_FRAME_COUNT);
+}
+
+// @NOTE(dubgron): Rotates the polygons every frame and tests each of them against a few of
+// its neighbours. The polygons rotate, so all of the cached colliders are recomputed every
+// frame, and the cache saves the recomputations done by every check and the allocations.
+void benchmark_world_colliders()
+{
+    for (i32 idx = 0; idx < ARRAY_COUNT(world_colliders_hexagon); ++idx)
+    {
+        f32 angle = idx * (2.f * M_PI / ARRAY_COUNT(world_colliders_hexagon));
+        world_colliders_hexagon[idx] = v2{ std::cos(angle), std::sin(angle) } * 8.f;
+    }
+
+    world_colliders_run(WorldCollidersMode_Cached);
+    world_colliders_run(WorldCollidersMode_ForcedRecompute);
+    world_colliders_run(WorldCollidersMode_Reference);
+}
@@ -0,0 +1,128 @@
+#include "aporia_benchmarks.hpp"
+
+#include "aporia_debug.hpp"
+#include "aporia_game.hpp"
+#include "aporia_jobs.hpp"
+#include "aporia_world.hpp"
+
+static constexpr i32 WORLD_DETERMINISM_ENTITY_COUNT = 100000;
+static constexpr i32 WORLD_DETERMINISM_STEP_COUNT = 100;
+static constexpr i32 WORLD_DETERMINISM_WORKER_COUNT = 7;
+
+// @NOTE(dubgron): The system can't use random_range, because its state is shared between the
+// threads. The decisions are hashed from the entity and the step instead.
+static u32 world_determinism_hash(i32 index, i32 step_idx)
+{
+    i32 key[2] = { index, step_idx };
+    return get_hash(key, sizeof(key));
+}
+
+// @NOTE(dubgron): Moves every entity, and destroys and spawns a few of them, so the step
+// exercises both the direct writes and all kinds of the deferred commands.
+static void world_determinism_system(WorldChunk* chunk, void* user_data)
+{
+    i32 step_idx = *(i32*)user_data;
+    World* world = chunk->world;
+
+    for (WorldIterator it = world_iterate(chunk); world_iterator_next(&it);)
+    {
+        u32 hash = world_determinism_hash(it.index, step_idx);
+
+        EntityTransform* transform = &world->transforms.data[it.index];
+        transform->position += v2{ (f32)(hash & 0xff) - 127.5f, (f32)((hash >> 8) & 0xff) - 127.5f } * 0.01f;
+
+        switch ((hash >> 16) % 32)
+        {
+            case 0:
+            {
+                entity_destroy_deferred(chunk, world->ids.data[it.index]);
+            }
+            break;
+
+            case 1:
+            {
+                Entity bullet;
+                bullet.transform.position = transform->position;
+                bullet.transform.width = 4.f;
+                bullet.transform.height = 4.f;
+
+                EntityID bullet_id = entity_create_deferred(chunk, bullet);
+
+                EntityRender render;
+                render.color = Color{ (u8)hash, (u8)(hash >> 8), (u8)(hash >> 16), 255 };
+                entity_set_render_deferred(chunk, bullet_id, render);
+            }
+            break;
+        }
+    }
+}
+
+static World world_determinism_run(i32 worker_count, f32* out_elapsed_ms)
+{
+    jobs_deinit();
+    jobs_init(worker_count);
+
+    World world = world_init();
+    for (i32 idx = 0; idx < WORLD_DETERMINISM_ENTITY_COUNT; ++idx)
+    {
+        EntityID entity_id = entity_create(&world);
+        entity_get_transform(&world, entity_id)->position = v2{ (f32)(idx % 1000), (f32)(idx / 1000) };
+    }
+
+    Timer timer;
+    for (i32 step_idx = 0; step_idx < WORLD_DETERMINISM_STEP_COUNT; ++step_idx)
+    {
+        world_next_frame(&world);
+
+        world_run_system(&world, world_determinism_system, &step_idx, WorldComponent_Transform);
+        world_apply_deferred_changes(&world);
+    }
+    *out_elapsed_ms = timer.get_elapsed_time<Milliseconds>();
+
+    world_update_colliders(&world);
+
+    return world;
+}
+
+template<typename T>
+static bool world_determinism_compare(const DynamicArray<T>& column0, const DynamicArray<T>& column1, i32 entity_count)
+{
+    return memcmp(column0.data, column1.data, entity_count * sizeof(T)) == 0;
+}
+
+// @NOTE(dubgron): Runs the same steps of the same world with a single thread and with many
+// worker threads, and checks that both end up in exactly the same state, with the same ids.
+void benchmark_world_determinism()
+{
+    f32 serial_ms = 0.f;
+    World serial_world = world_determinism_run(0, &serial_ms);
+    defer { world_deinit(&serial_world); };
+
+    f32 parallel_ms = 0.f;
+    World parallel_world = world_determinism_run(WORLD_DETERMINISM_WORKER_COUNT, &parallel_ms);
+    defer { world_deinit(&parallel_world); };
+
+    jobs_deinit();
+    jobs_init();
+
+    i32 entity_count = serial_world.entity_count;
+
+    bool is_deterministic = serial_world.entity_count == parallel_world.entity_count
+        && serial_world.live_count == parallel_world.live_count
+        && world_determinism_compare(serial_world.live_bits, parallel_world.live_bits, (entity_count + 63) / 64)
+        && world_determinism_compare(serial_world.ids, parallel_world.ids, entity_count)
+        && world_determinism_compare(serial_world.flags, parallel_world.flags, entity_count)
+        && world_determinism_compare(serial_world.transforms, parallel_world.transforms, entity_count)
+        && world_determinism_compare(serial_world.renders, parallel_world.renders, entity_count)
+        && world_determinism_compare(serial_world.render_bounds, parallel_world.render_bounds, entity_count);
+
+    if (!is_deterministic)
+    {
+        APORIA_LOG(Error, "The worlds simulated with 1 and % threads have diverged!", WORLD_DETERMINISM_WORKER_COUNT + 1);
+    }
+    APORIA_ASSERT(is_deterministic);
+
+    APORIA_LOG(Info, "% steps, % live out of % entities: 1 thread % ms, % threads % ms, the worlds are identical",
+        WORLD_DETERMINISM_STEP_COUNT, serial_world.live_count, entity_count,
+        serial_ms, WORLD_DETERMINISM_WORKER_COUNT + 1, parallel_ms);
+}
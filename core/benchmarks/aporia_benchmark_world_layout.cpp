@@ -0,0 +1,229 @@
+#include "aporia_benchmarks.hpp"
+
+#include "aporia_debug.hpp"
+#include "aporia_game.hpp"
+#include "aporia_world.hpp"
+
+// @NOTE(dubgron): The entity, as the world stored it before the components were split into
+// separate arrays, kept as the reference. Every loop had to stream the whole struct.
+struct ReferenceEntity
+{
+    EntityID id;
+    ReferenceEntity* next = nullptr;
+
+    EntityFlags flags = EntityFlag_Visible | EntityFlag_BlockingLight;
+    EntityType type = Entity_None;
+
+    v2 position{ 0.f };
+    f32 z = 0.f;
+
+    f32 rotation = 0.f;
+    v2 center_of_rotation{ 0.f };
+
+    f32 width = 0.f;
+    f32 height = 0.f;
+    v2 scale{ 1.f };
+
+    SubTexture texture;
+    Color color = Color::White;
+    u32 shader_id = 0;
+
+    String current_animation;
+    String requested_animation;
+    u64 current_frame = 0;
+    f32 elapsed_time = 0.f;
+
+    Collider collider;
+};
+
+static EntityTransform reference_entity_get_transform(const ReferenceEntity& entity)
+{
+    EntityTransform result;
+    result.position = entity.position;
+    result.z = entity.z;
+    result.rotation = entity.rotation;
+    result.center_of_rotation = entity.center_of_rotation;
+    result.width = entity.width;
+    result.height = entity.height;
+    result.scale = entity.scale;
+    return result;
+}
+
+// @NOTE(dubgron): Stands in for pushing the quad to the render queue, which needs the bounds
+// of the quad and the render data of the entity.
+static void world_layout_draw(const EntityTransform& transform, const SubTexture& texture, Color color, u32 shader_id)
+{
+    Collider_AABB bounds = entity_transform_get_bounds(transform);
+    benchmark_sink += (u64)(bounds.base.x + bounds.width) + texture.texture_index + color.a + shader_id;
+}
+
+// @NOTE(dubgron): The bytes the world commits per entity. The components are the columns
+// the entities are stored in, and the caches are the columns derived from them, which the
+// world keeps up to date on its own (the history counts all of the kept snapshots).
+struct WorldLayoutFootprint
+{
+    u64 components = 0;
+    u64 prefab = 0;
+    u64 caches = 0;
+};
+
+static WorldLayoutFootprint world_layout_get_footprint(const World& world)
+{
+    WorldLayoutFootprint result;
+    result.components = sizeof(*world.ids.data) + sizeof(*world.flags.data) + sizeof(*world.types.data)
+        + sizeof(*world.prefabs.data) + sizeof(*world.transforms.data) + sizeof(*world.renders.data)
+        + sizeof(*world.animators.data) + sizeof(*world.colliders.data);
+    result.prefab = sizeof(*world.prefabs.data);
+    result.caches = sizeof(*world.world_colliders.data) + sizeof(*world.world_bounds.data)
+        + sizeof(*world.render_bounds.data) + sizeof(EntitySnapshot) * world.history_depth;
+    return result;
+}
+
+static constexpr i32 WORLD_LAYOUT_FRAME_COUNT = 100;
+static constexpr f32 WORLD_LAYOUT_ALPHA = 0.5f;
+
+// @NOTE(dubgron): Runs the per-frame loops of the engine (the snapshot for the interpolation,
+// the draw loop and the light masking pass) over the old array of structs and over the
+// columns of the World. Both sides walk the indices and test the flags the same way, so
+// the difference comes only from the memory layout.
+void benchmark_world_layout()
+{
+    const i32 entity_counts[] = { 10000, 100000 };
+
+    {
+        World world = world_init();
+        defer { world_deinit(&world); };
+
+        WorldLayoutFootprint footprint = world_layout_get_footprint(world);
+        APORIA_LOG(Info, "Bytes per entity: % B before, % B of components now (% B of them for the prefab) and % B of caches",
+            sizeof(ReferenceEntity), footprint.components, footprint.prefab, footprint.caches);
+    }
+
+    for (i32 entity_count : entity_counts)
+    {
+        World world = world_init();
+        defer { world_deinit(&world); };
+
+        ReferenceEntity* entities = arena_push<ReferenceEntity>(&memory.frame, entity_count);
+        ReferenceEntity* entities_last_frame = arena_push<ReferenceEntity>(&memory.frame, entity_count);
+
+        for (i32 idx = 0; idx < entity_count; ++idx)
+        {
+            EntityID entity_id = entity_create(&world);
+
+            EntityTransform* transform = entity_get_transform(&world, entity_id);
+            transform->position = v2{ (f32)(idx % 1000) * 16.f, (f32)(idx / 1000) * 16.f };
+            transform->rotation = idx * 0.01f;
+            transform->width = 16.f;
+            transform->height = 16.f;
+
+            EntityFlags* flags = entity_get_flags(&world, entity_id);
+            if (idx % 3 == 0)
+            {
+                entity_flags_unset(flags, EntityFlag_BlockingLight);
+            }
+
+            ReferenceEntity* entity = &entities[idx];
+            entity->id = entity_id;
+            entity->flags = *flags;
+            entity->position = transform->position;
+            entity->rotation = transform->rotation;
+            entity->width = transform->width;
+            entity->height = transform->height;
+        }
+
+        // @NOTE(dubgron): Take the first snapshot, so none of the entities skips the interpolation.
+        world_next_frame(&world);
+
+        f32 next_frame_ns = 0.f, reference_next_frame_ns = 0.f;
+        f32 draw_ns = 0.f, reference_draw_ns = 0.f;
+        f32 mask_ns = 0.f, reference_mask_ns = 0.f;
+
+        for (i32 frame_idx = 0; frame_idx < WORLD_LAYOUT_FRAME_COUNT; ++frame_idx)
+        {
+            Timer timer;
+            for (i32 idx = 0; idx < entity_count; ++idx)
+            {
+                ReferenceEntity* entity = &entities[idx];
+                entity_flags_unset(&entity->flags, EntityFlag_SkipInterpolationNextFrame);
+
+                if (entity_flags_has_all(entity->flags, EntityFlag_DestroyedThisFrame))
+                {
+                    entity_flags_unset(&entity->flags, EntityFlag_DestroyedThisFrame);
+                }
+            }
+            memcpy(entities_last_frame, entities, entity_count * sizeof(ReferenceEntity));
+            reference_next_frame_ns += benchmark_nanoseconds(timer);
+
+            timer.reset();
+            world_next_frame(&world);
+            next_frame_ns += benchmark_nanoseconds(timer);
+
+            for (i32 idx = 0; idx < entity_count; ++idx)
+            {
+                entities[idx].position.x += 1.f;
+                world.transforms.data[idx].position.x += 1.f;
+            }
+
+            timer.reset();
+            for (i32 idx = 0; idx < entity_count; ++idx)
+            {
+                const ReferenceEntity& entity = entities[idx];
+                if (entity_flags_has_all(entity.flags, EntityFlag_Active | EntityFlag_Visible))
+                {
+                    EntityTransform last_transform = reference_entity_get_transform(entities_last_frame[idx]);
+                    EntityTransform transform = reference_entity_get_transform(entity);
+
+                    EntityTransform interpolated = entity_transform_lerp(last_transform, transform, WORLD_LAYOUT_ALPHA);
+                    world_layout_draw(interpolated, entity.texture, entity.color, entity.shader_id);
+                }
+            }
+            reference_draw_ns += benchmark_nanoseconds(timer);
+
+            timer.reset();
+            const EntitySnapshot* last_frame = world_get_snapshot(&world);
+            for (i32 idx = 0; idx < world.entity_count; ++idx)
+            {
+                if (entity_flags_has_all(world.flags.data[idx], EntityFlag_Active | EntityFlag_Visible))
+                {
+                    const EntityRender& render = world.renders.data[idx];
+
+                    EntityTransform interpolated = entity_transform_lerp(last_frame[idx].transform, world.transforms.data[idx], WORLD_LAYOUT_ALPHA);
+                    world_layout_draw(interpolated, render.texture, render.color, render.shader_id);
+                }
+            }
+            draw_ns += benchmark_nanoseconds(timer);
+
+            timer.reset();
+            for (i32 idx = 0; idx < entity_count; ++idx)
+            {
+                const ReferenceEntity& entity = entities[idx];
+                if (entity_flags_has_all(entity.flags, EntityFlag_Active | EntityFlag_Visible | EntityFlag_BlockingLight))
+                {
+                    world_layout_draw(reference_entity_get_transform(entity), entity.texture, entity.color, entity.shader_id);
+                }
+            }
+            reference_mask_ns += benchmark_nanoseconds(timer);
+
+            timer.reset();
+            for (i32 idx = 0; idx < world.entity_count; ++idx)
+            {
+                if (entity_flags_has_all(world.flags.data[idx], EntityFlag_Active | EntityFlag_Visible | EntityFlag_BlockingLight))
+                {
+                    const EntityRender& render = world.renders.data[idx];
+                    world_layout_draw(world.transforms.data[idx], render.texture, render.color, render.shader_id);
+                }
+            }
+            mask_ns += benchmark_nanoseconds(timer);
+        }
+
+        const f32 ns_to_us = 0.001f / WORLD_LAYOUT_FRAME_COUNT;
+        APORIA_LOG(Info, "% entities: next frame % us (before % us), draw % us (before % us), light mask % us (before % us)",
+            entity_count,
+            next_frame_ns * ns_to_us, reference_next_frame_ns * ns_to_us,
+            draw_ns * ns_to_us, reference_draw_ns * ns_to_us,
+            mask_ns * ns_to_us, reference_mask_ns * ns_to_us);
+
+        arena_clear(&memory.frame);
+    }
+}
@@ -0,0 +1,88 @@
+#include "aporia_benchmarks.hpp"
+
+#include "aporia_debug.hpp"
+#include "aporia_game.hpp"
+#include "aporia_world.hpp"
+
+static constexpr i32 WORLD_QUERY_ENTITY_COUNT = 100000;
+static constexpr i32 WORLD_QUERY_REPEAT_COUNT = 50;
+
+// @NOTE(dubgron): Compares world_query against the scalar loop, which tests the flags of
+// every live entity one at a time, with different ratios of the matching entities. Both
+// sides sum the matched indices, so the loop consuming the indices is part of the cost.
+void benchmark_world_query()
+{
+    const i32 visible_percents[] = { 90, 50, 10 };
+    const i32 destroyed_percents[] = { 0, 50 };
+
+    const EntityFlags required_flags = EntityFlag_Visible | EntityFlag_BlockingLight;
+
+    for (i32 visible_percent : visible_percents)
+    {
+        for (i32 destroyed_percent : destroyed_percents)
+        {
+            World world = world_init();
+            defer { world_deinit(&world); };
+
+            for (i32 idx = 0; idx < WORLD_QUERY_ENTITY_COUNT; ++idx)
+            {
+                entity_create(&world);
+            }
+
+            for (i32 idx = 0; idx < WORLD_QUERY_ENTITY_COUNT; ++idx)
+            {
+                EntityFlags* flags = &world.flags.data[idx];
+                if (random_range(0, 99) >= visible_percent)
+                {
+                    entity_flags_unset(flags, EntityFlag_Visible);
+                }
+                if (random_range(0, 1) == 0)
+                {
+                    entity_flags_unset(flags, EntityFlag_BlockingLight);
+                }
+                if (random_range(0, 99) < destroyed_percent)
+                {
+                    entity_destroy(&world, world.ids.data[idx]);
+                }
+            }
+
+            f32 scalar_ns = 0.f, query_ns = 0.f;
+            u64 scalar_sum = 0, query_sum = 0;
+
+            for (i32 repeat_idx = 0; repeat_idx < WORLD_QUERY_REPEAT_COUNT; ++repeat_idx)
+            {
+                scalar_sum = 0;
+                query_sum = 0;
+
+                Timer timer;
+                for (WorldIterator iterator = world_iterate(&world); world_iterator_next(&iterator);)
+                {
+                    if (entity_flags_has_all(world.flags.data[iterator.index], required_flags))
+                    {
+                        scalar_sum += iterator.index;
+                    }
+                }
+                scalar_ns += benchmark_nanoseconds(timer);
+
+                ScratchArena temp = scratch_begin();
+
+                timer.reset();
+                WorldQuery query = world_query(temp.arena, &world, required_flags);
+                for (i64 idx = 0; idx < query.count; ++idx)
+                {
+                    query_sum += query.indices[idx];
+                }
+                query_ns += benchmark_nanoseconds(timer);
+
+                scratch_end(temp);
+            }
+
+            APORIA_ASSERT(scalar_sum == query_sum);
+            benchmark_sink += query_sum;
+
+            const f32 ns_to_us = 0.001f / WORLD_QUERY_REPEAT_COUNT;
+            APORIA_LOG(Info, "% entities, % percent visible, % percent destroyed: scalar loop % us, world_query % us",
+                WORLD_QUERY_ENTITY_COUNT, visible_percent, destroyed_percent, scalar_ns * ns_to_us, query_ns * ns_to_us);
+        }
+    }
+}
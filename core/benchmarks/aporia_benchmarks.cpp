@@ -0,0 +1,77 @@
+#include "aporia_benchmarks.hpp"
+
+#include "aporia_atoms.hpp"
+#include "aporia_debug.hpp"
+#include "aporia_game.hpp"
+#include "aporia_jobs.hpp"
+#include "aporia_memory.hpp"
+
+volatile u64 benchmark_sink = 0;
+
+struct Benchmark
+{
+    String name;
+    void (*run)() = nullptr;
+};
+
+static Benchmark benchmarks[] = {
+    { "hash", benchmark_hash },
+    { "hash_table", benchmark_hash_table },
+    { "hash_table_churn", benchmark_hash_table_churn },
+    { "render_queue_sort", benchmark_render_queue_sort },
+    { "world_churn", benchmark_world_churn },
+    { "world_colliders", benchmark_world_colliders },
+    { "world_determinism", benchmark_world_determinism },
+    { "world_layout", benchmark_world_layout },
+    { "world_query", benchmark_world_query },
+};
+
+f32 benchmark_nanoseconds(const Timer& timer)
+{
+    return timer.get_elapsed_time<Nanoseconds>();
+}
+
+void benchmarks_main(String name)
+{
+    memory.persistent = arena_init(GIGABYTES(4));
+    memory.frame = arena_init(GIGABYTES(1));
+
+    temporary_memory_init(GIGABYTES(1));
+
+    LOGGING_INIT(&memory.persistent, "benchmarks");
+
+    atoms_init();
+    jobs_init();
+
+    bool found = false;
+    for (const Benchmark& benchmark : benchmarks)
+    {
+        if (name == "all" || name == benchmark.name)
+        {
+            APORIA_LOG(Info, "Running benchmark '%'.", benchmark.name);
+
+            Timer timer;
+            benchmark.run();
+
+            APORIA_LOG(Info, "Benchmark '%' finished in % s.", benchmark.name, timer.get_elapsed_time());
+
+            arena_clear(&memory.frame);
+            found = true;
+        }
+    }
+
+    if (!found)
+    {
+        APORIA_LOG(Error, "There's no benchmark named '%'!", name);
+    }
+
+    jobs_deinit();
+    atoms_deinit();
+
+    LOGGING_DEINIT();
+
+    temporary_memory_deinit();
+
+    arena_deinit(&memory.frame);
+    arena_deinit(&memory.persistent);
+}
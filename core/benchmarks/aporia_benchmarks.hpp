@@ -0,0 +1,26 @@
+#pragma once
+
+#include "aporia_string.hpp"
+#include "aporia_types.hpp"
+#include "aporia_utils.hpp"
+
+// @NOTE(dubgron): The benchmarks are compiled only with APORIA_BENCHMARKS and are run with
+// '--benchmark <name>', or '--benchmark all'. They don't create the window, nor initialize
+// the rendering and the audio, so they can run on the build machines. The results are logged.
+void benchmarks_main(String name);
+
+// @NOTE(dubgron): The benchmarks add their results to the sink, so the compiler can't
+// optimize away the code being measured.
+extern volatile u64 benchmark_sink;
+
+f32 benchmark_nanoseconds(const Timer& timer);
+
+void benchmark_hash();
+void benchmark_hash_table();
+void benchmark_hash_table_churn();
+void benchmark_render_queue_sort();
+void benchmark_world_churn();
+void benchmark_world_colliders();
+void benchmark_world_determinism();
+void benchmark_world_layout();
+void benchmark_world_query();
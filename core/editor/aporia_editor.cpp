@@ -2,7 +2,9 @@
 
 #include "imgui_internal.h"
 
+#include "aporia_assets.hpp"
 #include "aporia_camera.hpp"
+#include "aporia_dynamic_array.hpp"
 #include "aporia_game.hpp"
 #include "aporia_input.hpp"
 #include "aporia_rendering.hpp"
@@ -52,7 +54,7 @@ static GizmoType displayed_gizmo_type = Gizmo_Translate;
 static GizmoSpace gizmo_space = GizmoSpace_World;
 
 static v2 initial_mouse_position{ 0.f };
-static Entity initial_entity_state;
+static EntityTransform initial_entity_transform;
 
 enum EditorActionType : u32
 {
@@ -68,23 +70,26 @@ struct EditorAction
     Entity entity_state;
 };
 
-// @TODO(dubgron): Use a resizable array to make the history as long as it needs to be.
-constexpr i64 MAX_EDITOR_ACTIONS_COUNT = 256;
-static EditorAction action_history[MAX_EDITOR_ACTIONS_COUNT];
+// @NOTE(dubgron): This is only the size of the reserved address space, the history
+// commits the memory as it grows.
+constexpr i64 MAX_EDITOR_ACTIONS_COUNT = 1 << 20;
+
+// @NOTE(dubgron): The actions before the cursor are applied, the ones after it can
+// be redone. Making a new action discards all of the actions which could be redone.
+static DynamicArray<EditorAction> action_history;
 static i64 action_history_cursor = 0;
-static i64 action_history_count = 0;
-static i64 action_history_redos = 0;
 
 static EditorAction* editor_make_new_action()
 {
-    EditorAction* action = &action_history[action_history_cursor];
-    ring_buffer_increment_index(&action_history_cursor, MAX_EDITOR_ACTIONS_COUNT);
+    if (!dynamic_array_is_created(&action_history))
+    {
+        action_history = dynamic_array_create<EditorAction>(MAX_EDITOR_ACTIONS_COUNT);
+    }
 
-    action_history_count += 1;
-    if (action_history_count > MAX_EDITOR_ACTIONS_COUNT)
-        action_history_count = MAX_EDITOR_ACTIONS_COUNT;
+    dynamic_array_resize(&action_history, action_history_cursor);
 
-    action_history_redos = 0;
+    EditorAction* action = dynamic_array_push(&action_history);
+    action_history_cursor += 1;
 
     return action;
 }
@@ -102,41 +107,42 @@ static void editor_select_entity(EntityID new_entity_id)
 
     if (selected_entity_id.index != INDEX_INVALID)
     {
-        action->entity_state = *entity_get(&current_world, selected_entity_id);
+        entity_load(&current_world, selected_entity_id, &action->entity_state);
     }
 }
 
-static void editor_modify_entity(Entity* entity)
+static void editor_modify_entity(EntityID entity_id)
 {
     EditorAction* action = editor_make_new_action();
     action->type = EditorAction_ModifyEntity;
-    action->entity_state = *entity;
+    entity_load(&current_world, entity_id, &action->entity_state);
+
+    // @NOTE(dubgron): The gizmos modify the entity in place, without entity_store.
+    if (entity_flags_has_all(action->entity_state.flags, EntityFlag_Static))
+    {
+        world_mark_static_entities_changed(&current_world);
+    }
 }
 
 static void editor_try_undo_last_action()
 {
-    if (action_history_count == 0)
+    if (action_history_cursor == 0)
         return;
 
-    ring_buffer_decrement_index(&action_history_cursor, MAX_EDITOR_ACTIONS_COUNT);
-    action_history_count -= 1;
-    action_history_redos += 1;
+    action_history_cursor -= 1;
 
     Entity* prev_entity_state = nullptr;
-    if (action_history_count == 0)
+    if (action_history_cursor == 0)
     {
         static Entity default_entity;
         prev_entity_state = &default_entity;
     }
     else
     {
-        i64 prev_cursor = action_history_cursor;
-        ring_buffer_decrement_index(&prev_cursor, MAX_EDITOR_ACTIONS_COUNT);
-
-        prev_entity_state = &action_history[prev_cursor].entity_state;
+        prev_entity_state = &action_history.data[action_history_cursor - 1].entity_state;
     }
 
-    EditorAction* last_action = &action_history[action_history_cursor];
+    EditorAction* last_action = &action_history.data[action_history_cursor];
     switch (last_action->type)
     {
         case EditorAction_SelectEntity:
@@ -147,10 +153,7 @@ static void editor_try_undo_last_action()
 
         case EditorAction_ModifyEntity:
         {
-            Entity* entity = entity_get(&current_world, selected_entity_id);
-            APORIA_ASSERT(entity);
-
-            *entity = *prev_entity_state;
+            entity_store(&current_world, selected_entity_id, *prev_entity_state);
         }
         break;
     }
@@ -158,14 +161,11 @@ static void editor_try_undo_last_action()
 
 static void editor_try_redo_last_action()
 {
-    if (action_history_redos == 0)
+    if (action_history_cursor == action_history.count)
         return;
 
-    EditorAction last_action = action_history[action_history_cursor];
-
-    ring_buffer_increment_index(&action_history_cursor, MAX_EDITOR_ACTIONS_COUNT);
-    action_history_count += 1;
-    action_history_redos -= 1;
+    EditorAction last_action = action_history.data[action_history_cursor];
+    action_history_cursor += 1;
 
     switch (last_action.type)
     {
@@ -177,10 +177,7 @@ static void editor_try_redo_last_action()
 
         case EditorAction_ModifyEntity:
         {
-            Entity* entity = entity_get(&current_world, selected_entity_id);
-            APORIA_ASSERT(entity);
-
-            *entity = last_action.entity_state;
+            entity_store(&current_world, selected_entity_id, last_action.entity_state);
         }
         break;
     }
@@ -268,7 +265,7 @@ void editor_update(f32 frame_time)
     {
         if (index > NOTHING_SELECTED_INDEX)
         {
-            i32 generation = current_world.entity_array[index].id.generation;
+            i32 generation = current_world.ids.data[index].generation;
             EntityID new_entity_id = EntityID{ index, generation };
             editor_select_entity(new_entity_id);
 
@@ -280,23 +277,23 @@ void editor_update(f32 frame_time)
         }
         else
         {
-            Entity* entity = entity_get(&current_world, selected_entity_id);
-            APORIA_ASSERT(entity);
+            EntityTransform* transform = entity_get_transform(&current_world, selected_entity_id);
+            APORIA_ASSERT(transform);
 
             gizmo_index = index;
             initial_mouse_position = get_mouse_world_position();
-            initial_entity_state = *entity;
+            initial_entity_transform = *transform;
         }
     }
     else if (gizmo_index != NOTHING_SELECTED_INDEX)
     {
-        Entity* entity = entity_get(&current_world, selected_entity_id);
-        APORIA_ASSERT(entity);
+        EntityTransform* transform = entity_get_transform(&current_world, selected_entity_id);
+        APORIA_ASSERT(transform);
 
         if (input_is_held(left_mouse_button))
         {
-            v2 mouse_start_offset = initial_mouse_position - initial_entity_state.position;
-            v2 mouse_current_offset = mouse_current_position - initial_entity_state.position;
+            v2 mouse_start_offset = initial_mouse_position - initial_entity_transform.position;
+            v2 mouse_current_offset = mouse_current_position - initial_entity_transform.position;
 
             switch (gizmo_index)
             {
@@ -309,7 +306,7 @@ void editor_update(f32 frame_time)
 
                     if (gizmo_space == GizmoSpace_Local)
                     {
-                        right = v2{ cos(entity->rotation), sin(entity->rotation) };
+                        right = v2{ cos(transform->rotation), sin(transform->rotation) };
                         up = v2{ -right.y, right.x };
                     }
 
@@ -318,22 +315,22 @@ void editor_update(f32 frame_time)
                     bool snap_to_grid = input_is_held(Key_LShift);
                     f32 snap_resolution = editor_config.editor_grid_size / 2.f;
 
-                    entity->position = initial_entity_state.position;
+                    transform->position = initial_entity_transform.position;
 
                     if (gizmo_index == TRANSLATE_X_AXIS_INDEX || gizmo_index == TRANSLATE_XY_AXIS_INDEX)
                     {
-                        entity->position += glm::dot(mouse_offset, right) * right;
+                        transform->position += glm::dot(mouse_offset, right) * right;
 
                         if (snap_to_grid)
-                            entity->position.x = std::floor(mouse_current_position.x / snap_resolution) * snap_resolution;
+                            transform->position.x = std::floor(mouse_current_position.x / snap_resolution) * snap_resolution;
                     }
 
                     if (gizmo_index == TRANSLATE_Y_AXIS_INDEX || gizmo_index == TRANSLATE_XY_AXIS_INDEX)
                     {
-                        entity->position += glm::dot(mouse_offset, up) * up;
+                        transform->position += glm::dot(mouse_offset, up) * up;
 
                         if (snap_to_grid)
-                            entity->position.y = std::floor(mouse_current_position.y / snap_resolution) * snap_resolution;
+                            transform->position.y = std::floor(mouse_current_position.y / snap_resolution) * snap_resolution;
                     }
                 }
                 break;
@@ -343,7 +340,7 @@ void editor_update(f32 frame_time)
                     f32 base_angle = atan2(mouse_start_offset.y, mouse_start_offset.x);
                     f32 current_angle = atan2(mouse_current_offset.y, mouse_current_offset.x);
 
-                    entity->rotation = initial_entity_state.rotation + (current_angle - base_angle);
+                    transform->rotation = initial_entity_transform.rotation + (current_angle - base_angle);
                 }
                 break;
 
@@ -352,7 +349,7 @@ void editor_update(f32 frame_time)
                 {
                     v2 scale{ 1.f };
 
-                    v2 right = v2{ cos(entity->rotation), sin(entity->rotation) };
+                    v2 right = v2{ cos(transform->rotation), sin(transform->rotation) };
                     v2 up = v2{ -right.y, right.x };
 
                     switch (gizmo_index)
@@ -376,14 +373,22 @@ void editor_update(f32 frame_time)
                         break;
                     }
 
-                    entity->scale = initial_entity_state.scale * scale;
+                    transform->scale = initial_entity_transform.scale * scale;
                 }
                 break;
             }
+
+            // @NOTE(dubgron): Keep the static batches in sync while the entity is dragged around.
+            // They're rebuilt once, by editor_modify_entity, after the mouse is released.
+            EntityFlags* flags = entity_get_flags(&current_world, selected_entity_id);
+            if (entity_flags_has_all(*flags, EntityFlag_Static))
+            {
+                rendering_update_static_entity(&current_world, selected_entity_id);
+            }
         }
         else if (input_is_released(left_mouse_button))
         {
-            editor_modify_entity(entity);
+            editor_modify_entity(selected_entity_id);
             gizmo_index = NOTHING_SELECTED_INDEX;
         }
     }
@@ -429,6 +434,11 @@ void editor_update(f32 frame_time)
         {
             gizmo_space = GizmoSpace_Local;
         }
+
+        ImGui::Separator();
+
+        String culling_info = tprintf("Visible: %, Culled: %", culling_stats.visible_count, culling_stats.culled_count);
+        ImGui::TextUnformatted(*culling_info);
     }
     ImGui::End();
 
@@ -437,15 +447,12 @@ void editor_update(f32 frame_time)
         float footer_height_to_reserve = ImGui::GetStyle().ItemSpacing.y + ImGui::GetFrameHeightWithSpacing();
         if (ImGui::BeginChild("##scrolling_region", ImVec2(0, -footer_height_to_reserve), true))
         {
-            for (u64 idx = 0; idx < current_world.entity_count; ++idx)
+            for (WorldIterator it = world_iterate(&current_world); world_iterator_next(&it);)
             {
-                const Entity& entity = current_world.entity_array[idx];
-                if (!entity_flags_has_all(entity, EntityFlag_Active))
-                    continue;
-
-                String name = tprintf("Entity (ID = %, GEN = %)", entity.id.index, entity.id.generation);
-                if (ImGui::Selectable(*name, selected_entity_id == entity.id))
-                    selected_entity_id = entity.id;
+                EntityID entity_id = current_world.ids.data[it.index];
+                String name = tprintf("Entity (ID = %, GEN = %)", entity_id.index, entity_id.generation);
+                if (ImGui::Selectable(*name, selected_entity_id == entity_id))
+                    selected_entity_id = entity_id;
             }
         }
         ImGui::EndChild();
@@ -465,14 +472,12 @@ void editor_update(f32 frame_time)
             ImGui::SameLine();
             if (ImGui::Button("Copy Entity"))
             {
-                Entity* entity = entity_get(&current_world, selected_entity_id);
-                APORIA_ASSERT(entity);
-
-                Entity* new_entity = nullptr;
-                selected_entity_id = entity_create(&current_world, &new_entity);
-                EntityID id = new_entity->id;
-                *new_entity = *entity;
-                new_entity->id = id;
+                Entity entity;
+                bool is_valid = entity_load(&current_world, selected_entity_id, &entity);
+                APORIA_ASSERT(is_valid);
+
+                selected_entity_id = entity_create(&current_world);
+                entity_store(&current_world, selected_entity_id, entity);
             }
         }
     }
@@ -482,18 +487,19 @@ void editor_update(f32 frame_time)
     {
         if (selected_entity_id.index != INDEX_INVALID)
         {
-            Entity* selected_entity = entity_get(&current_world, selected_entity_id);
-            u32 before_hash = get_hash(selected_entity, sizeof(Entity));
+            Entity selected_entity;
+            entity_load(&current_world, selected_entity_id, &selected_entity);
+            u32 before_hash = get_hash(&selected_entity, sizeof(Entity));
 
-            if (ImGui::BeginCombo("Entity Type", *entity_type_to_string(selected_entity->type)))
+            if (ImGui::BeginCombo("Entity Type", *entity_type_to_string(selected_entity.type)))
             {
                 for (u32 n = 0; n < EntityType_Count; ++n)
                 {
                     EntityType type = (EntityType)n;
-                    bool is_selected = (selected_entity->type == type);
+                    bool is_selected = (selected_entity.type == type);
 
                     if (ImGui::Selectable(*entity_type_to_string(type), is_selected))
-                        selected_entity->type = type;
+                        selected_entity.type = type;
 
                     if (is_selected)
                         ImGui::SetItemDefaultFocus();
@@ -501,21 +507,21 @@ void editor_update(f32 frame_time)
                 ImGui::EndCombo();
             }
 
-            if (selected_entity->type != Entity_None)
+            if (selected_entity.type != Entity_None)
             {
-                ImGui::DragFloat3("Position", &selected_entity->position[0]);
+                ImGui::DragFloat3("Position", &selected_entity.transform.position[0]);
 
-                ImGui::DragFloat("Rotation", &selected_entity->rotation);
-                ImGui::DragFloat2("Center of Rotation", &selected_entity->center_of_rotation[0]);
+                ImGui::DragFloat("Rotation", &selected_entity.transform.rotation);
+                ImGui::DragFloat2("Center of Rotation", &selected_entity.transform.center_of_rotation[0]);
 
-                ImGui::DragFloat2("Size", &selected_entity->width);
-                ImGui::DragFloat2("Scale", &selected_entity->scale[0]);
+                ImGui::DragFloat2("Size", &selected_entity.transform.width);
+                ImGui::DragFloat2("Scale", &selected_entity.transform.scale[0]);
 
                 ImGui::Separator();
 
                 static bool fit_size_by_default = false;
 
-                if (ImGui::BeginCombo("Texture", *get_subtexture_name(selected_entity->texture)))
+                if (ImGui::BeginCombo("Texture", *get_subtexture_name(selected_entity.render.texture)))
                 {
                     ScratchArena temp = scratch_begin();
                     defer { scratch_end(temp); };
@@ -531,12 +537,11 @@ void editor_update(f32 frame_time)
 
                     for (i64 idx = 0; idx < subtextures.bucket_count; ++idx)
                     {
-                        const SubTexture& texture = subtextures.buckets[idx].value;
-                        if (texture.texture_index == INDEX_INVALID)
+                        if (!hash_table_is_bucket_valid(&subtextures, idx))
                             continue;
 
-                        textures[textures_count].texture = texture;
-                        textures[textures_count].name = get_subtexture_name(texture);
+                        textures[textures_count].texture = subtextures.buckets[idx].value;
+                        textures[textures_count].name = atom_get_string(subtextures.buckets[idx].key);
                         textures_count += 1;
                     }
 
@@ -549,15 +554,15 @@ void editor_update(f32 frame_time)
                     for (i64 idx = 0; idx < textures_count; ++idx)
                     {
                         const SubTexture& texture = textures[idx].texture;
-                        bool is_selected = (texture == selected_entity->texture);
+                        bool is_selected = (texture == selected_entity.render.texture);
 
                         String name = textures[idx].name;
                         if (ImGui::Selectable(*name, is_selected))
                         {
-                            selected_entity->texture = texture;
+                            selected_entity.render.texture = texture;
 
                             if (fit_size_by_default)
-                                entity_adjust_size_to_texture(selected_entity);
+                                entity_adjust_size_to_texture(&selected_entity.transform, selected_entity.render);
                         }
 
                         if (is_selected)
@@ -568,7 +573,7 @@ void editor_update(f32 frame_time)
                 }
 
                 if (ImGui::Button("Fit Size to Texture"))
-                    entity_adjust_size_to_texture(selected_entity);
+                    entity_adjust_size_to_texture(&selected_entity.transform, selected_entity.render);
 
                 ImGui::SameLine();
                 ImGui::Checkbox("Fit by Default", &fit_size_by_default);
@@ -576,41 +581,56 @@ void editor_update(f32 frame_time)
                 ImGui::Separator();
             }
 
-            v4 color = vec4_from_color(selected_entity->color);
+            v4 color = vec4_from_color(selected_entity.render.color);
             ImGui::ColorEdit4("Color", &color[0]);
-            selected_entity->color = color_from_vec4(color);
+            selected_entity.render.color = color_from_vec4(color);
+
+            bool is_static = entity_flags_has_all(selected_entity.flags, EntityFlag_Static);
+            if (ImGui::Checkbox("Static", &is_static))
+            {
+                if (is_static)
+                    entity_flags_set(&selected_entity.flags, EntityFlag_Static);
+                else
+                    entity_flags_unset(&selected_entity.flags, EntityFlag_Static);
+            }
 
             // @TODO(dubgron): Action should be registered only when editing is finished.
-            u32 after_hash = get_hash(selected_entity, sizeof(Entity));
+            u32 after_hash = get_hash(&selected_entity, sizeof(Entity));
             if (before_hash != after_hash)
             {
-                editor_modify_entity(selected_entity);
+                entity_store(&current_world, selected_entity_id, selected_entity);
+                editor_modify_entity(selected_entity_id);
             }
         }
     }
     ImGui::End();
+
+#if defined(APORIA_DEBUGTOOLS)
+    debug_assets();
+    debug_memory();
+#endif
 }
 
 void editor_draw_selected_entity()
 {
-    Entity* entity = entity_get(&current_world, selected_entity_id);
-    if (!entity)
+    EntityTransform* transform = entity_get_transform(&current_world, selected_entity_id);
+    EntityRender* render = entity_get_render(&current_world, selected_entity_id);
+    if (!transform || !render)
         return;
 
-    // @HACK(dubgron): It's stupid and there should be an easier way to do it.
-    u32 shader = entity->shader_id;
-    f32 z = entity->z;
-    entity->shader_id = editor_selected_shader;
-    entity->z = 0.99f;
-    draw_entity(*entity);
-    entity->shader_id = shader;
-    entity->z = z;
+    EntityTransform selected_transform = *transform;
+    selected_transform.z = 0.99f;
+
+    EntityRender selected_render = *render;
+    selected_render.shader_id = editor_selected_shader;
+
+    draw_entity(selected_entity_id, selected_transform, selected_render);
 }
 
 void editor_draw_gizmos()
 {
-    Entity* entity = entity_get(&current_world, selected_entity_id);
-    if (!entity)
+    EntityTransform* transform = entity_get_transform(&current_world, selected_entity_id);
+    if (!transform)
         return;
 
     f32 line_thickness = 5.f;
@@ -628,7 +648,7 @@ void editor_draw_gizmos()
         0.f, 0.f, -1.f, 0.f,
         viewport_width / 2.f, viewport_height / 2.f, 0.f, 1.f };
 
-    v2 start = clip_to_viewport * world_to_clip * v4{ entity->position, 0.f, 1.f };
+    v2 start = clip_to_viewport * world_to_clip * v4{ transform->position, 0.f, 1.f };
 
     m2 camera_rotation = active_camera.view.matrix;
 
@@ -643,7 +663,7 @@ void editor_draw_gizmos()
             v2 right = v2{ 1.f, 0.f };
 
             if (gizmo_space == GizmoSpace_Local)
-                right = v2{ cos(entity->rotation), sin(entity->rotation) };
+                right = v2{ cos(transform->rotation), sin(transform->rotation) };
 
             right = camera_rotation * right;
             v2 up = v2{ -right.y, right.x };
@@ -700,8 +720,8 @@ void editor_draw_gizmos()
 
             if (gizmo_index == ROTATE_INDEX)
             {
-                v2 mouse_start_offset = initial_mouse_position - initial_entity_state.position;
-                v2 mouse_current_offset = get_mouse_world_position() - initial_entity_state.position;
+                v2 mouse_start_offset = initial_mouse_position - initial_entity_transform.position;
+                v2 mouse_current_offset = get_mouse_world_position() - initial_entity_transform.position;
 
                 f32 rotation_line_thickness = 3.f;
 
@@ -718,7 +738,7 @@ void editor_draw_gizmos()
 
         case Gizmo_Scale:
         {
-            v2 right = camera_rotation * v2{ cos(entity->rotation), sin(entity->rotation) };
+            v2 right = camera_rotation * v2{ cos(transform->rotation), sin(transform->rotation) };
             v2 up = v2{ -right.y, right.x };
 
             v2 end = start + line_length * right;
@@ -13,6 +13,11 @@ String get_last_error();
 bool does_directory_exist(String path);
 bool make_directory(String path);
 
+void* memory_reserve(u64 size);
+bool memory_commit(void* address, u64 size);
+void memory_decommit(void* address, u64 size);
+void memory_release(void* address, u64 size);
+
 struct Mutex
 {
     // @NOTE(dubgron): The size of the handle is selected so it can hold the mutex
@@ -39,4 +44,45 @@ void mutex_lock(Mutex* mutex);
 void mutex_unlock(Mutex* mutex);
 void mutex_destroy(Mutex* mutex);
 
+struct ConditionVariable
+{
+    // @NOTE(dubgron): Same as with the mutex, the handle can hold the condition
+    // variable on every supported system.
+    //
+    // On Windows,   sizeof(CONDITION_VARIABLE) == 8
+    // On Linux,     sizeof(pthread_cond_t) == 48
+    // On MacOs,     sizeof(pthread_cond_t) == 48
+    u8 handle[48] = {};
+};
+
+#if defined(APORIA_WINDOWS)
+    static_assert(sizeof(CONDITION_VARIABLE) <= sizeof(ConditionVariable));
+#elif defined(APORIA_UNIX)
+    static_assert(sizeof(pthread_cond_t) <= sizeof(ConditionVariable));
+#endif
+
+ConditionVariable condition_variable_create();
+void condition_variable_wait(ConditionVariable* condition_variable, Mutex* mutex);
+void condition_variable_wake_one(ConditionVariable* condition_variable);
+void condition_variable_wake_all(ConditionVariable* condition_variable);
+void condition_variable_destroy(ConditionVariable* condition_variable);
+
+using ThreadProc = void(*)(void* data);
+
+// @NOTE(dubgron): The thread keeps a pointer to this struct until it starts running,
+// so it has to outlive the call to thread_create.
+struct Thread
+{
+    u64 handle = 0;
+
+    ThreadProc proc = nullptr;
+    void* data = nullptr;
+};
+
+bool thread_create(Thread* thread, ThreadProc proc, void* data);
+void thread_join(Thread* thread);
+void thread_yield();
+
+i32 get_processor_count();
+
 void watch_project_directory();
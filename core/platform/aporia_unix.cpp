@@ -40,6 +40,30 @@ bool make_directory(String dir_path)
     return mkdir(*dir_path, S_IREAD | S_IWRITE | S_IEXEC) != -1;
 }
 
+void* memory_reserve(u64 size)
+{
+    void* result = mmap(nullptr, size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    return result != MAP_FAILED ? result : nullptr;
+}
+
+bool memory_commit(void* address, u64 size)
+{
+    return mprotect(address, size, PROT_READ | PROT_WRITE) == 0;
+}
+
+void memory_decommit(void* address, u64 size)
+{
+    // @NOTE(dubgron): MADV_DONTNEED releases the physical pages right away, while
+    // keeping the address range reserved. Touching them again will fault in zeroed pages.
+    madvise(address, size, MADV_DONTNEED);
+    mprotect(address, size, PROT_NONE);
+}
+
+void memory_release(void* address, u64 size)
+{
+    munmap(address, size);
+}
+
 Mutex mutex_create()
 {
     Mutex result;
@@ -68,6 +92,75 @@ void mutex_destroy(Mutex* mutex)
     pthread_mutex_destroy((pthread_mutex_t*)mutex->handle);
 }
 
+ConditionVariable condition_variable_create()
+{
+    ConditionVariable result;
+    pthread_cond_init((pthread_cond_t*)result.handle, nullptr);
+    return result;
+}
+
+void condition_variable_wait(ConditionVariable* condition_variable, Mutex* mutex)
+{
+    pthread_cond_wait((pthread_cond_t*)condition_variable->handle, (pthread_mutex_t*)mutex->handle);
+}
+
+void condition_variable_wake_one(ConditionVariable* condition_variable)
+{
+    pthread_cond_signal((pthread_cond_t*)condition_variable->handle);
+}
+
+void condition_variable_wake_all(ConditionVariable* condition_variable)
+{
+    pthread_cond_broadcast((pthread_cond_t*)condition_variable->handle);
+}
+
+void condition_variable_destroy(ConditionVariable* condition_variable)
+{
+    pthread_cond_destroy((pthread_cond_t*)condition_variable->handle);
+}
+
+static void* internal_thread_proc(void* data)
+{
+    Thread* thread = (Thread*)data;
+    thread->proc(thread->data);
+    return nullptr;
+}
+
+bool thread_create(Thread* thread, ThreadProc proc, void* data)
+{
+    static_assert(sizeof(pthread_t) <= sizeof(thread->handle));
+
+    thread->proc = proc;
+    thread->data = data;
+
+    pthread_t handle;
+    if (pthread_create(&handle, nullptr, internal_thread_proc, thread) != 0)
+    {
+        return false;
+    }
+
+    memcpy(&thread->handle, &handle, sizeof(pthread_t));
+    return true;
+}
+
+void thread_join(Thread* thread)
+{
+    pthread_t handle;
+    memcpy(&handle, &thread->handle, sizeof(pthread_t));
+    pthread_join(handle, nullptr);
+}
+
+void thread_yield()
+{
+    sched_yield();
+}
+
+i32 get_processor_count()
+{
+    i64 processor_count = sysconf(_SC_NPROCESSORS_ONLN);
+    return processor_count > 0 ? (i32)processor_count : 1;
+}
+
 void watch_project_directory()
 {
     APORIA_LOG(Warning, "This feature is not supported on Unix!");
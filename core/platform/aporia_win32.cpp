@@ -56,6 +56,26 @@ bool make_directory(String path)
     return CreateDirectory(*path, NULL);
 }
 
+void* memory_reserve(u64 size)
+{
+    return VirtualAlloc(NULL, size, MEM_RESERVE, PAGE_NOACCESS);
+}
+
+bool memory_commit(void* address, u64 size)
+{
+    return VirtualAlloc(address, size, MEM_COMMIT, PAGE_READWRITE) != NULL;
+}
+
+void memory_decommit(void* address, u64 size)
+{
+    VirtualFree(address, size, MEM_DECOMMIT);
+}
+
+void memory_release(void* address, u64 size)
+{
+    VirtualFree(address, 0, MEM_RELEASE);
+}
+
 Mutex mutex_create()
 {
     Mutex result;
@@ -83,8 +103,78 @@ void mutex_destroy(Mutex* mutex)
     DeleteCriticalSection((CRITICAL_SECTION*)mutex->handle);
 }
 
+ConditionVariable condition_variable_create()
+{
+    ConditionVariable result;
+    InitializeConditionVariable((CONDITION_VARIABLE*)result.handle);
+    return result;
+}
+
+void condition_variable_wait(ConditionVariable* condition_variable, Mutex* mutex)
+{
+    SleepConditionVariableCS((CONDITION_VARIABLE*)condition_variable->handle, (CRITICAL_SECTION*)mutex->handle, INFINITE);
+}
+
+void condition_variable_wake_one(ConditionVariable* condition_variable)
+{
+    WakeConditionVariable((CONDITION_VARIABLE*)condition_variable->handle);
+}
+
+void condition_variable_wake_all(ConditionVariable* condition_variable)
+{
+    WakeAllConditionVariable((CONDITION_VARIABLE*)condition_variable->handle);
+}
+
+void condition_variable_destroy(ConditionVariable* condition_variable)
+{
+    // @NOTE(dubgron): Condition variables on Windows don't have to be destroyed.
+}
+
+static DWORD WINAPI internal_thread_proc(void* data)
+{
+    Thread* thread = (Thread*)data;
+    thread->proc(thread->data);
+    return 0;
+}
+
+bool thread_create(Thread* thread, ThreadProc proc, void* data)
+{
+    thread->proc = proc;
+    thread->data = data;
+
+    HANDLE handle = CreateThread(NULL, 0, internal_thread_proc, thread, 0, NULL);
+    if (handle == NULL)
+    {
+        return false;
+    }
+
+    thread->handle = (u64)handle;
+    return true;
+}
+
+void thread_join(Thread* thread)
+{
+    WaitForSingleObject((HANDLE)thread->handle, INFINITE);
+    CloseHandle((HANDLE)thread->handle);
+}
+
+void thread_yield()
+{
+    SwitchToThread();
+}
+
+i32 get_processor_count()
+{
+    SYSTEM_INFO system_info;
+    GetSystemInfo(&system_info);
+    return (i32)system_info.dwNumberOfProcessors;
+}
+
 static DWORD internal_watch_project_directory(void* data)
 {
+    temporary_memory_thread_init();
+    defer { temporary_memory_thread_deinit(); };
+
     // @NOTE(dubgron): Initially I intended to use SHChangeNotifyRegister as
     // it seemed to be more robust, but it turned out that in order to capture
     // the user message it sends, we'd need to have an access to the window